@@ -0,0 +1,126 @@
+#ifndef ROMI_ROVER_BUILD_AND_TEST_BENCHUTILS_H
+#define ROMI_ROVER_BUILD_AND_TEST_BENCHUTILS_H
+
+// What the benchmarks share: "--name value" argument parsing with the
+// common --json and --label options, percentiles, and the JSON results
+// file, {"label":..., <fields>, "results":[{...}, ...]}.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <fstream>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace bench {
+
+    struct common_options
+    {
+        std::string json{};
+        std::string label{};
+    };
+
+    // Parses "--name value" pairs. --json and --label go to common; the
+    // others to parse_option(name, value), which returns false for an
+    // option it does not know. Prints the usage and returns false when an
+    // option is unknown, has no value or does not parse.
+    template<typename ParseOption>
+    bool parse(int argc, char **argv, const char* usage, common_options& common, ParseOption parse_option)
+    {
+        try {
+            for (int i = 1; i < argc; i++) {
+                std::string name = argv[i];
+                bool ok = (i + 1 < argc);
+                if (ok) {
+                    std::string value = argv[++i];
+                    if (name == "--json")
+                        common.json = value;
+                    else if (name == "--label")
+                        common.label = value;
+                    else
+                        ok = parse_option(name, value);
+                }
+                if (!ok) {
+                    std::fprintf(stderr, "usage: %s %s\n", argv[0], usage);
+                    return false;
+                }
+            }
+        } catch (const std::exception& e) {
+            std::fprintf(stderr, "%s: %s\n", argv[0], e.what());
+            return false;
+        }
+        return true;
+    }
+
+    // "1,2,4" as {1, 2, 4}; every entry is at least 1.
+    inline std::vector<size_t> parse_list(const std::string& value)
+    {
+        std::vector<size_t> list;
+        std::stringstream entries(value);
+        std::string entry;
+        while (std::getline(entries, entry, ','))
+            list.push_back(std::max<size_t>(1, std::stoul(entry)));
+        return list;
+    }
+
+    // The p-th percentile of sorted, 0 when it is empty.
+    inline uint64_t percentile(const std::vector<uint64_t>& sorted, double p)
+    {
+        if (sorted.empty())
+            return 0;
+        auto index = static_cast<size_t>(p * static_cast<double>(sorted.size() - 1));
+        return sorted[index];
+    }
+
+    // text as a quoted JSON string.
+    inline std::string json_string(const std::string& text)
+    {
+        std::string quoted = "\"";
+        for (char c : text) {
+            switch (c) {
+                case '"': quoted += "\\\""; break;
+                case '\\': quoted += "\\\\"; break;
+                case '\n': quoted += "\\n"; break;
+                case '\r': quoted += "\\r"; break;
+                case '\t': quoted += "\\t"; break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20) {
+                        char escaped[8];
+                        std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(c));
+                        quoted += escaped;
+                    } else {
+                        quoted += c;
+                    }
+                    break;
+            }
+        }
+        return quoted + "\"";
+    }
+
+    // Writes the results to common.json, if it is set. write_fields(out)
+    // writes the run's fields and write_result(out, result) those of one
+    // result, each as ",\"name\":value" pairs.
+    template<typename Result, typename WriteFields, typename WriteResult>
+    void write_json(const common_options& common, const std::vector<Result>& results,
+                    WriteFields write_fields, WriteResult write_result)
+    {
+        if (common.json.empty())
+            return;
+        std::ofstream out(common.json);
+        out << "{\"label\":" << json_string(common.label);
+        write_fields(out);
+        out << ",\"results\":[";
+        for (size_t i = 0; i < results.size(); i++) {
+            std::ostringstream fields;
+            write_result(fields, results[i]);
+            // Drops the leading comma of the first field.
+            out << (i > 0 ? "," : "") << "{" << fields.str().substr(1) << "}";
+        }
+        out << "]}\n";
+    }
+}
+
+#endif //ROMI_ROVER_BUILD_AND_TEST_BENCHUTILS_H
@@ -0,0 +1,231 @@
+// FileLogWriter durability modes: one thread writes N lines of about 100
+// bytes through a FileLogWriter in each mode. Reports lines per second,
+// per-line latency and the data-loss windows:
+//
+// process crash: measured. A sampler thread compares the file size the
+//                kernel holds with what was written and reports the age of
+//                the oldest line still in the process.
+// power loss:    the bound. fdatasync() interval for GROUP_COMMIT, the
+//                kernel's dirty page writeback delay for the others.
+//
+// usage: rpp_durability_bench [--messages N] [--mode line|buffered|group|all] [--interval ms]
+//                             [--rate lines/s] [--error-every N] [--file path] [--json path]
+//                             [--label text]
+//
+// --rate 0 writes as fast as possible. --error-every N calls sync() after
+// every Nth line, as an ERROR line does through the logger.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/stat.h>
+#include "BenchUtils.h"
+#include "LogWriter.h"
+
+namespace {
+
+    using clock_type = std::chrono::steady_clock;
+
+    struct options
+    {
+        size_t messages = 200000;
+        std::vector<std::string> modes{"line", "buffered", "group"};
+        std::chrono::milliseconds interval{100};
+        double rate = 0.0;
+        size_t error_every = 0;
+        std::string file = "/tmp/rpp_durability_bench.txt";
+        bench::common_options common{};
+    };
+
+    struct result
+    {
+        std::string mode{};
+        size_t lines = 0;
+        double seconds = 0.0;
+        uint64_t p50 = 0;
+        uint64_t p99 = 0;
+        uint64_t max = 0;
+        double process_loss_ms = 0.0;
+        double power_loss_ms = 0.0;
+    };
+
+    // The number of bytes written once a line returned, and when.
+    struct progress
+    {
+        uint64_t bytes = 0;
+        int64_t time = 0;
+    };
+
+    int64_t now_ns()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(clock_type::now().time_since_epoch()).count();
+    }
+
+    double kernel_writeback_ms()
+    {
+        auto read_centisecs = [](const char* path) {
+            std::ifstream in(path);
+            double value = 0.0;
+            in >> value;
+            return value * 10.0;
+        };
+        return read_centisecs("/proc/sys/vm/dirty_expire_centisecs")
+               + read_centisecs("/proc/sys/vm/dirty_writeback_centisecs");
+    }
+
+    rpp::log_durability_policy make_policy(const std::string& mode, const options& opts)
+    {
+        rpp::log_durability_policy policy;
+        policy.interval = opts.interval;
+        if (mode == "buffered")
+            policy.mode = rpp::log_durability::BUFFERED;
+        else if (mode == "group")
+            policy.mode = rpp::log_durability::GROUP_COMMIT;
+        else
+            policy.mode = rpp::log_durability::LINE;
+        return policy;
+    }
+
+    // Runs until stop, tracking the oldest line that is not in the file yet.
+    void sample(const std::string& path, const std::vector<progress>& log, const std::atomic<size_t>& published,
+                const std::atomic<bool>& stop, int64_t& max_age)
+    {
+        size_t cursor = 0;
+        while (!stop.load(std::memory_order_acquire)) {
+            struct stat info{};
+            size_t count = published.load(std::memory_order_acquire);
+            if (stat(path.c_str(), &info) == 0) {
+                auto size = static_cast<uint64_t>(info.st_size);
+                while (cursor < count && log[cursor].bytes <= size)
+                    cursor++;
+                if (cursor < count)
+                    max_age = std::max(max_age, now_ns() - log[cursor].time);
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(500));
+        }
+    }
+
+    result run(const std::string& mode, const options& opts)
+    {
+        std::remove(opts.file.c_str());
+        auto policy = make_policy(mode, opts);
+        rpp::FileLogWriter writer(policy);
+        writer.open(opts.file);
+
+        std::vector<progress> log(opts.messages);
+        std::vector<uint64_t> latencies;
+        latencies.reserve(opts.messages);
+        std::atomic<size_t> published(0);
+        std::atomic<bool> stop(false);
+        int64_t max_age = 0;
+        std::thread sampler(sample, std::cref(opts.file), std::cref(log), std::cref(published), std::cref(stop),
+                            std::ref(max_age));
+
+        char line[128];
+        uint64_t bytes = 0;
+        auto period = std::chrono::nanoseconds(opts.rate > 0.0 ? static_cast<int64_t>(1e9 / opts.rate) : 0);
+        auto start = clock_type::now();
+        for (size_t i = 0; i < opts.messages; i++) {
+            if (period.count() > 0)
+                std::this_thread::sleep_until(start + period * static_cast<int64_t>(i));
+            int length = std::snprintf(line, sizeof(line), "20260101T000000, II, bench, 1:1000, motor %zu speed "
+                                                           "%.3f m/s current %.2f A state MOVING\n",
+                                       i % 2, static_cast<double>(i) * 0.001, static_cast<double>(i) * 0.0001);
+            int64_t begin = now_ns();
+            writer.write_line(std::string_view(line, static_cast<size_t>(length)));
+            if (opts.error_every > 0 && (i + 1) % opts.error_every == 0)
+                writer.sync();
+            int64_t end = now_ns();
+            latencies.push_back(static_cast<uint64_t>(end - begin));
+            bytes += static_cast<uint64_t>(length);
+            log[i] = progress{bytes, begin};
+            published.store(i + 1, std::memory_order_release);
+        }
+        auto stop_time = clock_type::now();
+        writer.close();
+        stop.store(true, std::memory_order_release);
+        sampler.join();
+        std::remove(opts.file.c_str());
+
+        std::sort(latencies.begin(), latencies.end());
+        result r;
+        r.mode = mode;
+        r.lines = opts.messages;
+        r.seconds = std::chrono::duration<double>(stop_time - start).count();
+        r.p50 = bench::percentile(latencies, 0.50);
+        r.p99 = bench::percentile(latencies, 0.99);
+        r.max = latencies.back();
+        r.process_loss_ms = static_cast<double>(max_age) / 1e6;
+        r.power_loss_ms = (policy.mode == rpp::log_durability::GROUP_COMMIT)
+                          ? static_cast<double>(opts.interval.count()) : kernel_writeback_ms();
+        return r;
+    }
+
+    void print(const result& r)
+    {
+        std::fprintf(stderr, "%-8s lines=%zu lines/s=%.0f p50=%" PRIu64 "ns p99=%" PRIu64 "ns max=%" PRIu64
+                             "ns process-crash-window=%.1fms power-loss-window<=%.0fms\n",
+                     r.mode.c_str(), r.lines, static_cast<double>(r.lines) / r.seconds, r.p50, r.p99, r.max,
+                     r.process_loss_ms, r.power_loss_ms);
+    }
+
+    void write_json(const options& opts, const std::vector<result>& results)
+    {
+        bench::write_json(opts.common, results, [&opts](std::ostream& out) {
+            out << ",\"interval_ms\":" << opts.interval.count() << ",\"rate\":" << opts.rate
+                << ",\"error_every\":" << opts.error_every;
+        }, [](std::ostream& out, const result& r) {
+            out << ",\"mode\":" << bench::json_string(r.mode) << ",\"lines\":" << r.lines
+                << ",\"lines_per_second\":" << static_cast<double>(r.lines) / r.seconds
+                << ",\"p50_ns\":" << r.p50 << ",\"p99_ns\":" << r.p99 << ",\"max_ns\":" << r.max
+                << ",\"process_crash_window_ms\":" << r.process_loss_ms
+                << ",\"power_loss_window_ms\":" << r.power_loss_ms;
+        });
+    }
+
+    bool parse_option(const std::string& name, const std::string& value, options& opts)
+    {
+        if (name == "--messages")
+            opts.messages = std::max<size_t>(1, std::stoul(value));
+        else if (name == "--mode" && value == "all")
+            opts.modes = {"line", "buffered", "group"};
+        else if (name == "--mode" && (value == "line" || value == "buffered" || value == "group"))
+            opts.modes = {value};
+        else if (name == "--interval")
+            opts.interval = std::chrono::milliseconds(std::stoul(value));
+        else if (name == "--rate")
+            opts.rate = std::stod(value);
+        else if (name == "--error-every")
+            opts.error_every = std::stoul(value);
+        else if (name == "--file")
+            opts.file = value;
+        else
+            return false;
+        return true;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    options opts;
+    if (!bench::parse(argc, argv, "[--messages N] [--mode line|buffered|group|all] [--interval ms] "
+                                  "[--rate lines/s] [--error-every N] [--file path] [--json path] [--label text]",
+                      opts.common, [&opts](const std::string& name, const std::string& value) {
+                          return parse_option(name, value, opts);
+                      }))
+        return 1;
+
+    std::vector<result> results;
+    for (const auto& mode : opts.modes) {
+        results.push_back(run(mode, opts));
+        print(results.back());
+    }
+    write_json(opts, results);
+    return 0;
+}
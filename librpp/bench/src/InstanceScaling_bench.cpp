@@ -0,0 +1,94 @@
+// Measures how the singleton lookups done on every r_* call scale with the
+// number of threads: Logger::Instance() and ClockAccessor::GetInstance(),
+// next to the locked lookup that copies a shared_ptr they used to be, and a
+// disabled r_debug() call.
+//
+// usage: rpp_instance_scaling_bench [max-threads] [lookups-per-thread]
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "ClockAccessor.h"
+#include "Logger.h"
+
+namespace {
+
+    std::atomic<uintptr_t> sink{0};
+
+    std::recursive_mutex locked_mutex;
+    std::shared_ptr<rpp::ILogger> locked_logger;
+
+    std::shared_ptr<rpp::ILogger> locked_instance()
+    {
+        std::scoped_lock lock(locked_mutex);
+        return locked_logger;
+    }
+
+    void lookup_locked(size_t n)
+    {
+        uintptr_t sum = 0;
+        for (size_t i = 0; i < n; i++)
+            sum += reinterpret_cast<uintptr_t>(locked_instance().get());
+        sink.fetch_add(sum, std::memory_order_relaxed);
+    }
+
+    void lookup_logger(size_t n)
+    {
+        uintptr_t sum = 0;
+        for (size_t i = 0; i < n; i++)
+            sum += reinterpret_cast<uintptr_t>(rpp::Logger::Instance().get());
+        sink.fetch_add(sum, std::memory_order_relaxed);
+    }
+
+    void lookup_clock(size_t n)
+    {
+        uintptr_t sum = 0;
+        for (size_t i = 0; i < n; i++)
+            sum += reinterpret_cast<uintptr_t>(rpp::ClockAccessor::GetInstance().get());
+        sink.fetch_add(sum, std::memory_order_relaxed);
+    }
+
+    void disabled_debug(size_t n)
+    {
+        for (size_t i = 0; i < n; i++)
+            r_debug("disabled %zu", i);
+    }
+
+    double run(const std::function<void(size_t)>& lookup, size_t n_threads, size_t n_lookups)
+    {
+        std::vector<std::thread> threads;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < n_threads; i++)
+            threads.emplace_back(lookup, n_lookups);
+        for (auto& thread : threads)
+            thread.join();
+        auto stop = std::chrono::steady_clock::now();
+        // Nanoseconds per lookup as seen by one thread.
+        return std::chrono::duration<double, std::nano>(stop - start).count() / static_cast<double>(n_lookups);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    size_t max_threads = (argc > 1) ? std::stoul(argv[1]) : std::max(1u, std::thread::hardware_concurrency());
+    size_t n_lookups = (argc > 2) ? std::stoul(argv[2]) : 2000000;
+
+    locked_logger = rpp::Logger::Instance();
+    log_set_level(rpp::log_level::INFO);
+
+    std::printf("%8s %14s %14s %14s %14s\n", "threads", "locked ns", "logger ns", "clock ns", "r_debug ns");
+    for (size_t n_threads = 1; n_threads <= max_threads; n_threads *= 2) {
+        std::printf("%8zu %14.2f %14.2f %14.2f %14.2f\n", n_threads,
+                    run(lookup_locked, n_threads, n_lookups),
+                    run(lookup_logger, n_threads, n_lookups),
+                    run(lookup_clock, n_threads, n_lookups),
+                    run(disabled_debug, n_threads, n_lookups));
+    }
+    return 0;
+}
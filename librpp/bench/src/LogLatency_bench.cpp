@@ -0,0 +1,81 @@
+// Measures the latency of a single r_info() call when logging to a file with
+// the synchronous writer, the asynchronous writer, and per-thread staging
+// buffers written with writev().
+//
+// usage: rpp_log_latency_bench [threads] [messages-per-thread] [log-file]
+
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Logger.h"
+#include "BenchUtils.h"
+
+namespace {
+
+    using latencies = std::vector<uint64_t>;
+
+    void logging_thread(size_t n_messages, latencies& results)
+    {
+        results.reserve(n_messages);
+        for (size_t i = 0; i < n_messages; i++) {
+            auto start = std::chrono::steady_clock::now();
+            r_info("bench message %zu value %f", i, static_cast<double>(i) * 0.5);
+            auto stop = std::chrono::steady_clock::now();
+            results.push_back(static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count()));
+        }
+    }
+
+    void run(const char *name, size_t n_threads, size_t n_messages)
+    {
+        std::vector<latencies> results(n_threads);
+        std::vector<std::thread> threads;
+
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < n_threads; i++)
+            threads.emplace_back(logging_thread, n_messages, std::ref(results[i]));
+        for (auto& thread : threads)
+            thread.join();
+        log_flush();
+        auto stop = std::chrono::steady_clock::now();
+
+        latencies all;
+        for (auto& result : results)
+            all.insert(all.end(), result.begin(), result.end());
+        std::sort(all.begin(), all.end());
+
+        double seconds = std::chrono::duration<double>(stop - start).count();
+        std::printf("%-6s threads=%zu lines=%zu lines/s=%.0f p50=%" PRIu64 "ns p99=%" PRIu64 "ns p99.9=%" PRIu64 "ns max=%" PRIu64 "ns\n",
+                    name, n_threads, all.size(), static_cast<double>(all.size()) / seconds,
+                    bench::percentile(all, 0.50), bench::percentile(all, 0.99), bench::percentile(all, 0.999),
+                    bench::percentile(all, 1.0));
+    }
+}
+
+int main(int argc, char **argv)
+{
+    size_t n_threads = (argc > 1) ? std::stoul(argv[1]) : 4;
+    size_t n_messages = (argc > 2) ? std::stoul(argv[2]) : 20000;
+    std::string path = (argc > 3) ? argv[3] : "/tmp/rpp_log_latency_bench.txt";
+
+    log_set_application("bench");
+    log_set_file(path);
+    run("sync", n_threads, n_messages);
+
+    log_set_async();
+    run("async", n_threads, n_messages);
+
+    log_set_sync();
+    log_set_file_writer_type(rpp::file_writer_type::FD);
+    log_set_file(path);
+    log_set_staging();
+    run("staged", n_threads, n_messages);
+
+    log_cleanup();
+    std::remove(path.c_str());
+    return 0;
+}
@@ -0,0 +1,235 @@
+// Logging throughput and latency: N threads call r_info() or r_debug() with
+// a mix of representative formats against the console, file or null writer.
+// Reports lines per second, per-call latency percentiles and the process CPU
+// time per line, and optionally writes the results as JSON to compare
+// commits.
+//
+// usage: rpp_log_bench [--threads N] [--messages N] [--writer console|file|null|all]
+//                      [--level info|debug] [--file path] [--json path] [--label text]
+//
+// The console writer writes to stdout; redirect it to keep the terminal
+// usable. The summary goes to stderr.
+
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/resource.h>
+#include "BenchUtils.h"
+#include "Logger.h"
+#include "LogWriter.h"
+
+namespace {
+
+    class BenchLogWriterFactory : public rpp::LogWriterFactory
+    {
+    public:
+        explicit BenchLogWriterFactory(bool null_console) : null_console_(null_console) {
+        }
+
+        std::shared_ptr<rpp::ILogWriter> create_console_writer() override {
+            if (null_console_)
+                return std::make_shared<rpp::NullLogWriter>();
+            return rpp::LogWriterFactory::create_console_writer();
+        }
+
+    private:
+        const bool null_console_;
+    };
+
+    struct options
+    {
+        size_t threads = 4;
+        size_t messages = 100000;
+        std::vector<std::string> writers{"null", "file", "console"};
+        bool debug = false;
+        std::string file = "/tmp/rpp_log_bench.txt";
+        bench::common_options common{};
+    };
+
+    struct result
+    {
+        std::string writer{};
+        size_t threads = 0;
+        size_t lines = 0;
+        double seconds = 0.0;
+        double cpu_seconds = 0.0;
+        uint64_t p50 = 0;
+        uint64_t p99 = 0;
+        uint64_t p999 = 0;
+        uint64_t max = 0;
+    };
+
+    using latencies = std::vector<uint64_t>;
+
+    const char* const states[] = {"IDLE", "MOVING", "WEEDING", "CHARGING"};
+
+    template <bool Debug>
+    void log_one(size_t i)
+    {
+        double x = static_cast<double>(i) * 0.001;
+        switch (i % 4) {
+            case 0:
+                if constexpr (Debug)
+                    r_debug("motor %d speed %.3f m/s current %.2f A", static_cast<int>(i % 2), x, x * 0.1);
+                else
+                    r_info("motor %d speed %.3f m/s current %.2f A", static_cast<int>(i % 2), x, x * 0.1);
+                break;
+            case 1:
+                if constexpr (Debug)
+                    r_debug("navigation: waypoint %zu reached at (%.2f, %.2f)", i, x, -x);
+                else
+                    r_info("navigation: waypoint %zu reached at (%.2f, %.2f)", i, x, -x);
+                break;
+            case 2:
+                if constexpr (Debug)
+                    r_debug("state changed from %s to %s", states[i % 4], states[(i + 1) % 4]);
+                else
+                    r_info("state changed from %s to %s", states[i % 4], states[(i + 1) % 4]);
+                break;
+            default:
+                if constexpr (Debug)
+                    r_debug("heartbeat");
+                else
+                    r_info("heartbeat");
+                break;
+        }
+    }
+
+    template <bool Debug>
+    void logging_thread(size_t n_messages, latencies& results)
+    {
+        results.reserve(n_messages);
+        for (size_t i = 0; i < n_messages; i++) {
+            auto start = std::chrono::steady_clock::now();
+            log_one<Debug>(i);
+            auto stop = std::chrono::steady_clock::now();
+            results.push_back(static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count()));
+        }
+    }
+
+    double cpu_seconds()
+    {
+        rusage usage{};
+        getrusage(RUSAGE_SELF, &usage);
+        auto seconds = [](const timeval& t) {
+            return static_cast<double>(t.tv_sec) + static_cast<double>(t.tv_usec) / 1e6;
+        };
+        return seconds(usage.ru_utime) + seconds(usage.ru_stime);
+    }
+
+    result run(const std::string& writer, const options& opts)
+    {
+        log_set_writer_factory(std::make_shared<BenchLogWriterFactory>(writer == "null"));
+        log_set_application("bench");
+        log_set_level(opts.debug ? rpp::log_level::DEBUG : rpp::log_level::INFO);
+        if (writer == "file") {
+            std::remove(opts.file.c_str());
+            log_set_file(opts.file);
+        }
+
+        std::vector<latencies> per_thread(opts.threads);
+        std::vector<std::thread> threads;
+        double cpu_start = cpu_seconds();
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < opts.threads; i++) {
+            if (opts.debug)
+                threads.emplace_back(logging_thread<true>, opts.messages, std::ref(per_thread[i]));
+            else
+                threads.emplace_back(logging_thread<false>, opts.messages, std::ref(per_thread[i]));
+        }
+        for (auto& thread : threads)
+            thread.join();
+        log_flush();
+        auto stop = std::chrono::steady_clock::now();
+        double cpu_stop = cpu_seconds();
+
+        latencies all;
+        for (auto& thread_latencies : per_thread)
+            all.insert(all.end(), thread_latencies.begin(), thread_latencies.end());
+        std::sort(all.begin(), all.end());
+
+        result r;
+        r.writer = writer;
+        r.threads = opts.threads;
+        r.lines = all.size();
+        r.seconds = std::chrono::duration<double>(stop - start).count();
+        r.cpu_seconds = cpu_stop - cpu_start;
+        if (!all.empty()) {
+            r.p50 = bench::percentile(all, 0.50);
+            r.p99 = bench::percentile(all, 0.99);
+            r.p999 = bench::percentile(all, 0.999);
+            r.max = all.back();
+        }
+
+        log_cleanup();
+        if (writer == "file")
+            std::remove(opts.file.c_str());
+        return r;
+    }
+
+    void print(const result& r)
+    {
+        std::fprintf(stderr, "%-8s threads=%zu lines=%zu lines/s=%.0f p50=%" PRIu64 "ns p99=%" PRIu64
+                             "ns p99.9=%" PRIu64 "ns max=%" PRIu64 "ns cpu/line=%.0fns\n",
+                     r.writer.c_str(), r.threads, r.lines, static_cast<double>(r.lines) / r.seconds,
+                     r.p50, r.p99, r.p999, r.max, r.cpu_seconds * 1e9 / static_cast<double>(r.lines));
+    }
+
+    void write_json(const options& opts, const std::vector<result>& results)
+    {
+        bench::write_json(opts.common, results, [&opts](std::ostream& out) {
+            out << ",\"level\":" << bench::json_string(opts.debug ? "debug" : "info")
+                << ",\"messages_per_thread\":" << opts.messages;
+        }, [](std::ostream& out, const result& r) {
+            out << ",\"writer\":" << bench::json_string(r.writer) << ",\"threads\":" << r.threads
+                << ",\"lines\":" << r.lines
+                << ",\"lines_per_second\":" << static_cast<double>(r.lines) / r.seconds
+                << ",\"p50_ns\":" << r.p50 << ",\"p99_ns\":" << r.p99 << ",\"p999_ns\":" << r.p999
+                << ",\"max_ns\":" << r.max
+                << ",\"cpu_ns_per_line\":" << r.cpu_seconds * 1e9 / static_cast<double>(r.lines);
+        });
+    }
+
+    bool parse_option(const std::string& name, const std::string& value, options& opts)
+    {
+        if (name == "--threads")
+            opts.threads = std::max<size_t>(1, std::stoul(value));
+        else if (name == "--messages")
+            opts.messages = std::max<size_t>(1, std::stoul(value));
+        else if (name == "--writer" && value == "all")
+            opts.writers = {"null", "file", "console"};
+        else if (name == "--writer" && (value == "null" || value == "file" || value == "console"))
+            opts.writers = {value};
+        else if (name == "--level" && (value == "info" || value == "debug"))
+            opts.debug = (value == "debug");
+        else if (name == "--file")
+            opts.file = value;
+        else
+            return false;
+        return true;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    options opts;
+    if (!bench::parse(argc, argv, "[--threads N] [--messages N] [--writer console|file|null|all] "
+                                  "[--level info|debug] [--file path] [--json path] [--label text]",
+                      opts.common, [&opts](const std::string& name, const std::string& value) {
+                          return parse_option(name, value, opts);
+                      }))
+        return 1;
+
+    std::vector<result> results;
+    for (const auto& writer : opts.writers) {
+        results.push_back(run(writer, opts));
+        print(results.back());
+    }
+    write_json(opts, results);
+    return 0;
+}
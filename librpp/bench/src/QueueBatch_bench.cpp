@@ -0,0 +1,160 @@
+// Queue batching: one producer hands items to one consumer through
+// ThreadsafeQueue, MPMCQueue and SPSCQueue with push_bulk() and
+// try_drain() in batches of each size. Batch size 1 goes through push()
+// and pop(). Reports the cost of one item for each batch size, to show
+// where batching stops paying for itself.
+//
+// usage: rpp_queue_batch_bench [--batches 1,4,16,64,256,1024] [--items N] [--capacity N]
+//                              [--json path] [--label text]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+#include "BenchUtils.h"
+#include "MPMCQueue.h"
+#include "SPSCQueue.h"
+#include "ThreadsafeQueue.h"
+
+namespace {
+
+    struct options
+    {
+        std::vector<size_t> batches{1, 4, 16, 64, 256, 1024};
+        size_t items = 1000000;
+        size_t capacity = 4096;
+        bench::common_options common{};
+    };
+
+    struct result
+    {
+        std::string queue{};
+        size_t batch = 0;
+        size_t items = 0;
+        double seconds = 0.0;
+    };
+
+    // The consumer spins, yielding, on an empty queue, as in
+    // rpp_queue_bench.
+    template<typename Queue>
+    double run(Queue& queue, size_t batch, size_t items)
+    {
+        std::vector<uint64_t> input(batch);
+        std::atomic<bool> go(false);
+        uint64_t checksum = 0;
+
+        std::thread consumer([&queue, &go, &checksum, batch, items] {
+            std::vector<uint64_t> output(batch);
+            while (!go.load(std::memory_order_acquire))
+                std::this_thread::yield();
+            uint64_t sum = 0;
+            size_t received = 0;
+            while (received < items) {
+                size_t count = 0;
+                if (batch == 1) {
+                    auto item = queue.pop();
+                    if (item) {
+                        sum += *item;
+                        count = 1;
+                    }
+                } else {
+                    count = queue.try_drain(output.begin(), std::min(batch, items - received));
+                    for (size_t i = 0; i < count; i++)
+                        sum += output[i];
+                }
+                if (count == 0)
+                    std::this_thread::yield();
+                received += count;
+            }
+            checksum = sum;
+        });
+
+        auto start = std::chrono::steady_clock::now();
+        go.store(true, std::memory_order_release);
+        for (size_t sent = 0; sent < items; sent += batch) {
+            size_t count = std::min(batch, items - sent);
+            if (batch == 1) {
+                queue.push(sent);
+            } else {
+                std::iota(input.begin(), input.begin() + static_cast<std::ptrdiff_t>(count), sent);
+                queue.push_bulk(input.begin(), input.begin() + static_cast<std::ptrdiff_t>(count));
+            }
+        }
+        consumer.join();
+        auto stop = std::chrono::steady_clock::now();
+
+        uint64_t expected = items * (items - 1) / 2;
+        if (checksum != expected)
+            std::fprintf(stderr, "checksum mismatch: %llu != %llu\n",
+                         static_cast<unsigned long long>(checksum), static_cast<unsigned long long>(expected));
+        return std::chrono::duration<double>(stop - start).count();
+    }
+
+    void print(const result& r)
+    {
+        double total = static_cast<double>(r.items);
+        std::fprintf(stderr, "%-16s batch=%5zu items/s=%12.0f ns/item=%8.1f\n", r.queue.c_str(),
+                     r.batch, total / r.seconds, r.seconds * 1e9 / total);
+    }
+
+    void write_json(const options& opts, const std::vector<result>& results)
+    {
+        bench::write_json(opts.common, results, [&opts](std::ostream& out) {
+            out << ",\"items\":" << opts.items << ",\"capacity\":" << opts.capacity;
+        }, [](std::ostream& out, const result& r) {
+            double total = static_cast<double>(r.items);
+            out << ",\"queue\":" << bench::json_string(r.queue) << ",\"batch\":" << r.batch
+                << ",\"items_per_second\":" << total / r.seconds
+                << ",\"ns_per_item\":" << r.seconds * 1e9 / total;
+        });
+    }
+
+    bool parse_option(const std::string& name, const std::string& value, options& opts)
+    {
+        if (name == "--batches")
+            opts.batches = bench::parse_list(value);
+        else if (name == "--items")
+            opts.items = std::max<size_t>(1, std::stoul(value));
+        else if (name == "--capacity")
+            opts.capacity = std::max<size_t>(1, std::stoul(value));
+        else
+            return false;
+        return true;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    options opts;
+    if (!bench::parse(argc, argv, "[--batches 1,4,16,64,256,1024] [--items N] [--capacity N] "
+                                  "[--json path] [--label text]",
+                      opts.common, [&opts](const std::string& name, const std::string& value) {
+                          return parse_option(name, value, opts);
+                      }))
+        return 1;
+
+    std::vector<result> results;
+    for (size_t batch : opts.batches) {
+        {
+            ThreadsafeQueue<uint64_t> queue;
+            results.push_back(result{"ThreadsafeQueue", batch, opts.items, run(queue, batch, opts.items)});
+            print(results.back());
+        }
+        {
+            MPMCQueue<uint64_t> queue(opts.capacity);
+            results.push_back(result{"MPMCQueue", batch, opts.items, run(queue, batch, opts.items)});
+            print(results.back());
+        }
+        {
+            SPSCQueue<uint64_t> queue(opts.capacity);
+            results.push_back(result{"SPSCQueue", batch, opts.items, run(queue, batch, opts.items)});
+            print(results.back());
+        }
+    }
+    write_json(opts, results);
+    return 0;
+}
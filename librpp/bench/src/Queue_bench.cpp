@@ -0,0 +1,170 @@
+// Queue contention: N producers push and N consumers pop through one queue,
+// for ThreadsafeQueue (mutex and std::queue) and MPMCQueue (lock-free
+// ring), and with one producer and one consumer also for SPSCQueue.
+// Reports items per second and the cost of one handoff for each thread
+// count.
+//
+// usage: rpp_queue_bench [--threads 1,2,4,8,16] [--items N] [--capacity N] [--pin on|off]
+//                        [--json path] [--label text]
+//
+// --threads is the number of producers, and as many consumers; --items is
+// per producer. --pin on puts thread i on CPU i modulo the CPU count.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include "BenchUtils.h"
+#include "MPMCQueue.h"
+#include "SPSCQueue.h"
+#include "ThreadsafeQueue.h"
+
+namespace {
+
+    struct options
+    {
+        std::vector<size_t> threads{1, 2, 4, 8, 16};
+        size_t items = 200000;
+        size_t capacity = 4096;
+        bool pin = false;
+        bench::common_options common{};
+    };
+
+    struct result
+    {
+        std::string queue{};
+        size_t threads = 0;
+        size_t items = 0;
+        double seconds = 0.0;
+    };
+
+    void pin_to_cpu(std::thread& thread, size_t index)
+    {
+        auto cpus = static_cast<size_t>(std::max(1L, sysconf(_SC_NPROCESSORS_ONLN)));
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(index % cpus, &set);
+        pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set);
+    }
+
+    // Consumers spin, yielding, on an empty queue: the cost measured is
+    // that of the queue, not of waking threads.
+    double run(IThreadsafeQueue<uint64_t>& queue, size_t threads, size_t items, bool pin)
+    {
+        std::atomic<bool> go(false);
+        std::atomic<size_t> remaining(threads * items);
+        std::atomic<uint64_t> checksum(0);
+        std::vector<std::thread> workers;
+        for (size_t t = 0; t < threads; t++) {
+            workers.emplace_back([&queue, &go, items] {
+                while (!go.load(std::memory_order_acquire))
+                    std::this_thread::yield();
+                for (size_t i = 0; i < items; i++)
+                    queue.push(i);
+            });
+            workers.emplace_back([&queue, &go, &remaining, &checksum] {
+                while (!go.load(std::memory_order_acquire))
+                    std::this_thread::yield();
+                uint64_t sum = 0;
+                while (remaining.load(std::memory_order_relaxed) > 0) {
+                    auto item = queue.pop();
+                    if (item) {
+                        sum += *item;
+                        remaining.fetch_sub(1, std::memory_order_relaxed);
+                    } else {
+                        std::this_thread::yield();
+                    }
+                }
+                checksum.fetch_add(sum);
+            });
+        }
+        if (pin) {
+            for (size_t i = 0; i < workers.size(); i++)
+                pin_to_cpu(workers[i], i);
+        }
+        auto start = std::chrono::steady_clock::now();
+        go.store(true, std::memory_order_release);
+        for (auto& worker : workers)
+            worker.join();
+        auto stop = std::chrono::steady_clock::now();
+
+        uint64_t expected = threads * (items * (items - 1) / 2);
+        if (checksum.load() != expected)
+            std::fprintf(stderr, "checksum mismatch: %llu != %llu\n",
+                         static_cast<unsigned long long>(checksum.load()), static_cast<unsigned long long>(expected));
+        return std::chrono::duration<double>(stop - start).count();
+    }
+
+    void print(const result& r)
+    {
+        double total = static_cast<double>(r.threads * r.items);
+        std::fprintf(stderr, "%-16s threads=%2zu+%-2zu items/s=%12.0f ns/item=%8.1f\n", r.queue.c_str(),
+                     r.threads, r.threads, total / r.seconds, r.seconds * 1e9 / total);
+    }
+
+    void write_json(const options& opts, const std::vector<result>& results)
+    {
+        bench::write_json(opts.common, results, [&opts](std::ostream& out) {
+            out << ",\"items_per_producer\":" << opts.items << ",\"capacity\":" << opts.capacity;
+        }, [](std::ostream& out, const result& r) {
+            double total = static_cast<double>(r.threads * r.items);
+            out << ",\"queue\":" << bench::json_string(r.queue) << ",\"producers\":" << r.threads
+                << ",\"consumers\":" << r.threads << ",\"items_per_second\":" << total / r.seconds
+                << ",\"ns_per_item\":" << r.seconds * 1e9 / total;
+        });
+    }
+
+    bool parse_option(const std::string& name, const std::string& value, options& opts)
+    {
+        if (name == "--threads")
+            opts.threads = bench::parse_list(value);
+        else if (name == "--items")
+            opts.items = std::max<size_t>(1, std::stoul(value));
+        else if (name == "--capacity")
+            opts.capacity = std::max<size_t>(1, std::stoul(value));
+        else if (name == "--pin" && (value == "on" || value == "off"))
+            opts.pin = (value == "on");
+        else
+            return false;
+        return true;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    options opts;
+    if (!bench::parse(argc, argv, "[--threads 1,2,4,8,16] [--items N] [--capacity N] [--pin on|off] "
+                                  "[--json path] [--label text]",
+                      opts.common, [&opts](const std::string& name, const std::string& value) {
+                          return parse_option(name, value, opts);
+                      }))
+        return 1;
+
+    std::vector<result> results;
+    for (size_t threads : opts.threads) {
+        {
+            ThreadsafeQueue<uint64_t> queue;
+            results.push_back(result{"ThreadsafeQueue", threads, opts.items,
+                                     run(queue, threads, opts.items, opts.pin)});
+            print(results.back());
+        }
+        {
+            MPMCQueue<uint64_t> queue(opts.capacity);
+            results.push_back(result{"MPMCQueue", threads, opts.items, run(queue, threads, opts.items, opts.pin)});
+            print(results.back());
+        }
+        if (threads == 1) {
+            SPSCQueue<uint64_t> queue(opts.capacity);
+            results.push_back(result{"SPSCQueue", threads, opts.items, run(queue, threads, opts.items, opts.pin)});
+            print(results.back());
+        }
+    }
+    write_json(opts, results);
+    return 0;
+}
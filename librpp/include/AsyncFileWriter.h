@@ -0,0 +1,97 @@
+#ifndef ROMI_ROVER_BUILD_AND_TEST_ASYNCFILEWRITER_H
+#define ROMI_ROVER_BUILD_AND_TEST_ASYNCFILEWRITER_H
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace rpp
+{
+    enum class async_io_backend
+    {
+        AUTO = 1,       // io_uring when the kernel allows it, else THREAD.
+        IO_URING,       // Registered buffers submitted through io_uring.
+        THREAD          // Buffers written with pwrite() by a background thread.
+    };
+
+    // Writes a file from a set of fixed buffers without blocking the caller
+    // on the disk. write() copies into the current buffer and submits it to
+    // the backend when it is full; submit() hands over the partly filled one.
+    // Buffers are recycled once their completion is harvested; a short write,
+    // EINTR or EAGAIN queues the rest again. The caller only waits when
+    // every buffer is in flight, or in flush().
+    //
+    // Not thread safe: one thread, or the caller's lock, drives a writer.
+    class AsyncFileWriter
+    {
+    public:
+        static constexpr size_t default_buffer_size = 64 * 1024;
+        static constexpr size_t default_buffer_count = 16;
+
+        // Throws std::runtime_error when IO_URING is asked for and the
+        // kernel refuses it.
+        explicit AsyncFileWriter(async_io_backend backend = async_io_backend::AUTO,
+                                 size_t buffer_size = default_buffer_size,
+                                 size_t buffer_count = default_buffer_count);
+        ~AsyncFileWriter();
+        AsyncFileWriter(const AsyncFileWriter&) = delete;
+        AsyncFileWriter& operator=(const AsyncFileWriter&) = delete;
+
+        // Creates the file, truncated unless append. Throws std::runtime_error.
+        void open(const std::string& path, bool append);
+        void close();
+        bool is_open() const { return fd_ >= 0; }
+
+        void write(const char* data, size_t size);
+        // Hands everything written so far to the backend.
+        void submit();
+        // Submits and blocks until everything submitted is on the file.
+        void flush();
+
+        // IO_URING or THREAD, never AUTO.
+        async_io_backend backend() const { return backend_; }
+        uint64_t bytes_written() const { return bytes_written_.load(std::memory_order_relaxed); }
+        uint64_t errors() const { return errors_.load(std::memory_order_relaxed); }
+
+        struct completion
+        {
+            size_t buffer = 0;
+            int64_t result = 0;     // Bytes written, or -errno.
+        };
+        class Engine;
+
+    private:
+        static constexpr size_t no_buffer = static_cast<size_t>(-1);
+
+        struct Buffer
+        {
+            std::vector<char> data{};
+            size_t used = 0;
+            size_t done = 0;
+            uint64_t offset = 0;
+        };
+
+        size_t acquire_buffer();
+        void queue_current();
+        void queue_rest(size_t index);
+        void reap(bool wait);
+        void complete(const completion& c);
+
+        async_io_backend backend_;
+        std::vector<Buffer> buffers_;
+        std::deque<size_t> free_;
+        std::vector<completion> completions_;
+        std::unique_ptr<Engine> engine_;
+        int fd_;
+        uint64_t offset_;
+        size_t current_;
+        size_t in_flight_;
+        std::atomic<uint64_t> bytes_written_;
+        std::atomic<uint64_t> errors_;
+    };
+}
+
+#endif
@@ -0,0 +1,70 @@
+#ifndef ROMI_ROVER_BUILD_AND_TEST_ASYNCLOGWRITER_H
+#define ROMI_ROVER_BUILD_AND_TEST_ASYNCLOGWRITER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "ILogWriter.h"
+
+namespace rpp
+{
+    // Decorator that moves the I/O of another ILogWriter onto a dedicated thread.
+    // write() only copies the message onto a bounded queue. The writer thread
+    // drains the queue in batches and hands each batch to the wrapped writer as
+    // a single write() call.
+    class AsyncLogWriter : public ILogWriter
+    {
+    public:
+        static constexpr size_t default_capacity = 8192;
+
+        AsyncLogWriter(const std::shared_ptr<ILogWriter>& writer,
+                       size_t capacity = default_capacity,
+                       log_overflow_policy policy = log_overflow_policy::BLOCK);
+        ~AsyncLogWriter() override;
+        AsyncLogWriter(const AsyncLogWriter&) = delete;
+        AsyncLogWriter& operator=(const AsyncLogWriter&) = delete;
+
+        void open(std::string_view name) override;
+        void close() override;
+        void write(const std::string& message) override;
+        void write_line(std::string_view line) override;
+        // Does not wait: the writer thread syncs once the lines queued
+        // before the call are written.
+        void sync() override;
+
+        // Blocks until every message queued before the call has been written.
+        void flush();
+        uint64_t dropped() const;
+        const std::shared_ptr<ILogWriter>& writer() const;
+
+    private:
+        void run();
+        void stop();
+
+        const std::shared_ptr<ILogWriter> writer_;
+        const size_t capacity_;
+        const log_overflow_policy policy_;
+
+        std::mutex queue_mutex_;
+        std::condition_variable not_empty_;
+        std::condition_variable not_full_;
+        std::condition_variable written_;
+        std::vector<std::string> queue_;
+        uint64_t enqueued_;
+        uint64_t completed_;
+        bool sync_requested_;
+        bool quit_;
+
+        // Serialises the writer thread with open() and close().
+        std::mutex writer_mutex_;
+        std::atomic<uint64_t> dropped_;
+        uint64_t reported_dropped_;
+        std::thread thread_;
+    };
+}
+
+#endif
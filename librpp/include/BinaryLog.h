@@ -0,0 +1,241 @@
+#ifndef ROMI_ROVER_BUILD_AND_TEST_BINARYLOG_H
+#define ROMI_ROVER_BUILD_AND_TEST_BINARYLOG_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "LogFilter.h"
+
+// Binary log with deferred formatting. A call records the id of its format
+// string, the raw Clock::timestamp(), the thread and the packed argument
+// values into a per-thread buffer. No printf formatting happens on the
+// logging thread; rpp-logdecode turns the file back into the text layout
+// "DTC, LL, app, THREAD, message" written by Logger. A buffer is written to
+// the file when it is full, when its thread exits and, while the file is
+// open, by a timer thread every flush interval.
+//
+// File layout (host byte order): the magic "RPPBLOG1" followed by records.
+// Every record starts with a one byte type:
+//   format:      u32 id, u8 level, u32 length, format bytes
+//   application: u32 length, name bytes
+//   message:     u32 id, u64 timestamp, u64 thread, u16 length, arguments
+//   thread:      u64 thread, u32 length, ThreadIdentity field bytes
+// Each argument is a one byte tag followed by its value:
+//   'i' i64, 'u' u64, 'f' f64, 'p' u64, 's' u16 length + bytes.
+
+namespace rpp
+{
+    namespace binary_log
+    {
+        constexpr char magic[] = "RPPBLOG1";
+        constexpr size_t magic_size = 8;
+        constexpr uint8_t format_record = 1;
+        constexpr uint8_t application_record = 2;
+        constexpr uint8_t message_record = 3;
+        constexpr uint8_t thread_record = 4;
+        constexpr size_t message_header_size = 1 + 4 + 8 + 8 + 2;
+        constexpr size_t max_string_size = 1024;
+        constexpr size_t max_payload_size = 0xffff;
+
+        template <typename T>
+        constexpr bool is_c_string_v = std::is_same_v<std::decay_t<T>, const char*>
+                                       || std::is_same_v<std::decay_t<T>, char*>;
+
+        template <typename T>
+        constexpr bool is_string_v = std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view>;
+
+        template <typename T>
+        std::string_view as_string(const T& value) {
+            if constexpr (is_c_string_v<T>) {
+                const char* s = value;
+                return (s == nullptr) ? std::string_view() : std::string_view(s, strnlen(s, max_string_size));
+            } else {
+                return std::string_view(value).substr(0, max_string_size);
+            }
+        }
+
+        template <typename T>
+        size_t encoded_size(const T& value) {
+            if constexpr (is_c_string_v<T> || is_string_v<T>) {
+                return 1 + 2 + as_string(value).size();
+            } else {
+                static_assert(std::is_arithmetic_v<T> || std::is_pointer_v<T>,
+                              "binary log arguments must be numbers, pointers or strings");
+                return 1 + 8;
+            }
+        }
+
+        template <typename T>
+        char* encode(char* p, const T& value) {
+            if constexpr (is_c_string_v<T> || is_string_v<T>) {
+                std::string_view s = as_string(value);
+                auto length = static_cast<uint16_t>(s.size());
+                *p++ = 's';
+                memcpy(p, &length, sizeof(length));
+                p += sizeof(length);
+                if (!s.empty())
+                    memcpy(p, s.data(), s.size());
+                return p + s.size();
+            } else if constexpr (std::is_floating_point_v<T>) {
+                auto v = static_cast<double>(value);
+                *p++ = 'f';
+                memcpy(p, &v, sizeof(v));
+            } else if constexpr (std::is_pointer_v<T>) {
+                auto v = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(value));
+                *p++ = 'p';
+                memcpy(p, &v, sizeof(v));
+            } else if constexpr (std::is_signed_v<T>) {
+                auto v = static_cast<int64_t>(value);
+                *p++ = 'i';
+                memcpy(p, &v, sizeof(v));
+            } else {
+                auto v = static_cast<uint64_t>(value);
+                *p++ = 'u';
+                memcpy(p, &v, sizeof(v));
+            }
+            return p + 8;
+        }
+    }
+
+    class BinaryLog
+    {
+    public:
+        static constexpr std::chrono::milliseconds default_flush_interval{100};
+
+        static BinaryLog& Instance();
+        ~BinaryLog();
+        BinaryLog(const BinaryLog&) = delete;
+        BinaryLog& operator=(const BinaryLog&) = delete;
+
+        // Creates (or truncates) the binary log file. Throws std::runtime_error.
+        void open(const std::string& path, std::chrono::milliseconds flush_interval = default_flush_interval);
+        void close();
+        bool is_open() const { return fd_.load(std::memory_order_relaxed) >= 0; }
+        void set_application_name(std::string_view application_name);
+        // Writes the buffered records of every thread to the file.
+        void flush();
+
+        uint32_t register_format(log_level level, const char* format);
+
+        // The format is only carried for the compiler: the id already identifies it.
+        template <typename ...Args>
+        void log(uint32_t id, const char* /* format */, const Args& ...args) {
+            if (!is_open())
+                return;
+            size_t payload = (binary_log::encoded_size(args) + ... + 0);
+            if (payload > binary_log::max_payload_size)
+                return;
+            char* p = reserve(binary_log::message_header_size + payload);
+            p = encode_header(p, id, static_cast<uint16_t>(payload));
+            ((p = binary_log::encode(p, args)), ...);
+            commit(p);
+        }
+
+        class ThreadBuffer;
+
+    private:
+        BinaryLog();
+        char* reserve(size_t size);
+        char* encode_header(char* p, uint32_t id, uint16_t payload);
+        void commit(char* end);
+        void write_to_file(const char* data, size_t size);
+        void write_to_file_locked(const char* data, size_t size);
+        void write_format(uint32_t id);
+        void write_application();
+        void write_thread(size_t index);
+        uint64_t register_thread();
+        void register_buffer(ThreadBuffer* buffer);
+        void unregister_buffer(ThreadBuffer* buffer);
+        void open_file(const std::string& path);
+        void stop_timer();
+        void run();
+
+        std::mutex mutex_;
+        std::atomic<int> fd_;
+        std::string application_name_;
+        std::vector<std::pair<log_level, std::string>> formats_;
+        // The ThreadIdentity field of every thread as it first logged.
+        std::vector<std::pair<uint64_t, std::string>> threads_;
+        std::mutex buffers_mutex_;
+        std::vector<ThreadBuffer*> buffers_;
+        std::chrono::milliseconds flush_interval_;
+        std::mutex timer_mutex_;
+        std::condition_variable timer_;
+        bool quit_;
+        std::thread thread_;
+    };
+
+    // The static state of one rb_* call site.
+    class BinaryLogSite
+    {
+    public:
+        constexpr BinaryLogSite(log_level level, const char* category, const char* format)
+                : filter_(level, category), format_(format), id_(0) {
+        }
+
+        // The flight recorder only takes text lines.
+        bool enabled() { return filter_.enabled() && !filter_.recorded_only(); }
+
+        uint32_t id() {
+            uint32_t id = id_.load(std::memory_order_acquire);
+            if (id == 0) {
+                id = BinaryLog::Instance().register_format(filter_.level(), format_);
+                id_.store(id, std::memory_order_release);
+            }
+            return id;
+        }
+
+    private:
+        LogSite filter_;
+        const char* const format_;
+        std::atomic<uint32_t> id_;
+    };
+
+    // Converts a binary log back to text. Throws std::runtime_error on a
+    // malformed file.
+    class BinaryLogDecoder
+    {
+    public:
+        BinaryLogDecoder();
+        void decode(std::istream& input, std::ostream& output);
+        static std::string format_message(const std::string& format, const char* args, size_t size);
+
+    private:
+        std::map<uint32_t, std::pair<log_level, std::string>> formats_;
+        std::map<uint64_t, std::string> threads_;
+        std::string application_name_;
+    };
+}
+
+void log_set_binary_file(const std::string& path,
+                         std::chrono::milliseconds flush_interval = rpp::BinaryLog::default_flush_interval);
+void log_close_binary_file();
+void log_flush_binary();
+
+#define RPP_BLOG_FORMAT(...) RPP_BLOG_FORMAT_(__VA_ARGS__, unused)
+#define RPP_BLOG_FORMAT_(format, ...) format
+
+// The format must be a string literal: only its id is written per message.
+#define RPP_BLOG_AT(level, ...) \
+    do { \
+        static rpp::BinaryLogSite rpp_blog_site_(level, RPP_LOG_CATEGORY, RPP_BLOG_FORMAT(__VA_ARGS__)); \
+        if (rpp_blog_site_.enabled()) \
+            rpp::BinaryLog::Instance().log(rpp_blog_site_.id(), __VA_ARGS__); \
+    } while (false)
+
+#define rb_err(...) RPP_BLOG_AT(rpp::log_level::ERROR, __VA_ARGS__)
+#define rb_warn(...) RPP_BLOG_AT(rpp::log_level::WARNING, __VA_ARGS__)
+#define rb_info(...) RPP_BLOG_AT(rpp::log_level::INFO, __VA_ARGS__)
+#define rb_debug(...) RPP_BLOG_AT(rpp::log_level::DEBUG, __VA_ARGS__)
+
+#endif
@@ -35,6 +35,7 @@ namespace rpp {
                 ~Clock() override = default;
                 double time() override;
                 std::string datetime_compact_string() override;
+                size_t datetime_compact(char* buffer, size_t size) override;
                 uint64_t timestamp() override;
             // TBD: Move this out of clock
                 void sleep(double seconds) override;
@@ -1,6 +1,7 @@
 #ifndef ROMI_ROVER_BUILD_AND_TEST_CLOCKACCESSOR_H
 #define ROMI_ROVER_BUILD_AND_TEST_CLOCKACCESSOR_H
 
+#include <atomic>
 #include <memory>
 #include <mutex>
 #include "Clock.h"
@@ -10,25 +11,30 @@ namespace rpp {
     class ClockAccessor
     {
             public:
+                // Once the clock is published, this is a single acquire load.
                 static const std::shared_ptr<IClock>& GetInstance()
                 {
-                    {
-                        std::scoped_lock lock(clock_mutex);
-                        if (g_clock == nullptr)
-                            g_clock = std::make_shared<rpp::Clock>();
-                    }
+                    if (g_published.load(std::memory_order_acquire) != nullptr)
+                        return g_clock;
+                    std::scoped_lock lock(clock_mutex);
+                    if (g_clock == nullptr)
+                        g_clock = std::make_shared<rpp::Clock>();
+                    g_published.store(g_clock.get(), std::memory_order_release);
                     return g_clock;
                 }
 
+                // For tests: must not race with threads using the clock.
                 static void SetInstance(const std::shared_ptr<IClock>& globalClock)
                 {
                     std::scoped_lock lock(clock_mutex);
                     g_clock = globalClock;
+                    g_published.store(g_clock.get(), std::memory_order_release);
                 }
 
             private:
                 static std::mutex clock_mutex;
                 static std::shared_ptr<IClock> g_clock;
+                static std::atomic<IClock*> g_published;
     };
 }
 
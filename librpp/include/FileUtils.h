@@ -9,6 +9,7 @@
 #include <cstring>
 #include <filesystem>
 
+#include "AsyncFileWriter.h"
 #include "ILinux.h"
 namespace fs = std::filesystem;
 
@@ -20,6 +21,11 @@ class FileUtils
 public:
     static void TryReadFileAsVector(const std::string &filename, std::vector <uint8_t> &out);
     static void TryWriteVectorAsFile(const std::string& filename, const std::vector<uint8_t>& in);
+    // Writes through io_uring, or a writer thread where it is unavailable.
+    // The returned writer submits a batch per submit() call.
+    static std::unique_ptr<rpp::AsyncFileWriter> TryOpenAsyncWriter(const std::string& filename,
+                                                                     bool append = false);
+    static void TryWriteVectorAsFileAsync(const std::string& filename, const std::vector<uint8_t>& in);
     static std::string TryReadFileAsString(const std::string& filePath);
     static void TryWriteStringAsFile(const std::string& filename, const std::string& output);
     static fs::path TryGetHomeDirectory(rpp::ILinux& linux);
@@ -0,0 +1,57 @@
+#ifndef ROMI_ROVER_BUILD_AND_TEST_FLIGHTRECORDER_H
+#define ROMI_ROVER_BUILD_AND_TEST_FLIGHTRECORDER_H
+
+#include <atomic>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// A circular buffer of the most recent log lines in a memory mapped file.
+// Recording a line is a reservation with one atomic add and a memcpy into
+// the shared mapping, so the lines survive a crash or a kill of the process
+// (but not of the machine). rpp-flightrec prints them back in order.
+//
+// File layout (host byte order): the magic "RPPFLT01", u64 capacity, u64
+// head (the number of bytes ever recorded), padding up to header_size and
+// then capacity bytes of ring. Byte n of the stream is at n % capacity.
+
+namespace rpp
+{
+    class FlightRecorder
+    {
+    public:
+        static constexpr size_t default_size = 4 * 1024 * 1024;
+        static constexpr size_t min_size = 4096;
+        static constexpr size_t header_size = 64;
+        static constexpr char magic[] = "RPPFLT01";
+        static constexpr size_t magic_size = 8;
+
+        // Creates (or truncates) the file. Throws std::runtime_error.
+        explicit FlightRecorder(const std::string& path, size_t size = default_size);
+        ~FlightRecorder();
+        FlightRecorder(const FlightRecorder&) = delete;
+        FlightRecorder& operator=(const FlightRecorder&) = delete;
+
+        // Lines longer than the ring are not recorded.
+        void record(std::string_view line);
+        uint64_t recorded() const;
+        size_t capacity() const { return capacity_; }
+        const std::string& path() const { return path_; }
+
+        // The last max_lines complete lines of a recorder file, oldest
+        // first and without their newline; all of them for 0. A line that
+        // was being written when the process died may be garbled. Throws
+        // std::runtime_error on a malformed file.
+        static std::vector<std::string> read_lines(const std::string& path, size_t max_lines = 0);
+
+    private:
+        const std::string path_;
+        const size_t capacity_;
+        int fd_;
+        char* map_;
+        std::atomic<uint64_t>* head_;
+        char* ring_;
+    };
+}
+
+#endif
@@ -24,6 +24,8 @@
 #ifndef _LIBR_I_CLOCK_H_
 #define _LIBR_I_CLOCK_H_
 
+#include <algorithm>
+#include <cstring>
 #include <string>
 namespace rpp {
 
@@ -35,6 +37,23 @@ namespace rpp {
 
         virtual double time() = 0;
         virtual std::string datetime_compact_string() = 0;
+
+        // Room for "YYYYMMDD-HHMMSS.mmm" and the terminating null.
+        static constexpr size_t datetime_compact_size = 20;
+
+        // Writes datetime_compact_string() into buffer, truncated and null
+        // terminated, and returns the number of characters written. Clock
+        // overrides this with an allocation free version; the default lets
+        // other clocks (and mocks) provide only datetime_compact_string().
+        virtual size_t datetime_compact(char* buffer, size_t size) {
+            if (size == 0)
+                return 0;
+            std::string datetime = datetime_compact_string();
+            size_t length = std::min(datetime.size(), size - 1);
+            memcpy(buffer, datetime.data(), length);
+            buffer[length] = '\0';
+            return length;
+        }
         virtual uint64_t timestamp() = 0;
         // TBD: Move this out of clock
         virtual void sleep(double seconds)= 0;
@@ -1,10 +1,73 @@
 #ifndef ROMI_ROVER_BUILD_AND_TEST_ILOGWRITER_H
 #define ROMI_ROVER_BUILD_AND_TEST_ILOGWRITER_H
 
+#include <chrono>
 #include <filesystem>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
 
 namespace rpp
 {
+    // What an asynchronous writer does with a message when its queue is full.
+    enum class log_overflow_policy
+    {
+        BLOCK = 1,      // Wait for the writer thread to make room.
+        DROP,           // Discard the message.
+        COUNT_AND_DROP  // Discard the message and report the number dropped in the log.
+    };
+
+    // The kind of writer Logger::log_to_file() asks the factory for.
+    enum class file_writer_type
+    {
+        STREAM = 1,     // std::ofstream, flushed after every write.
+        FD,             // Raw file descriptor, batches written with writev().
+        MMAP,           // Memory mapped, preallocated segments.
+        URING           // Submitted through io_uring, or a writer thread without it.
+    };
+
+    // How soon FileLogWriter puts a line on the disk. What a crash loses:
+    //
+    // BUFFERED:     lines are copied into a buffer of buffer_size, written
+    //               when it is full and at least every interval. A process
+    //               crash loses up to interval of lines, a power loss
+    //               whatever the kernel has not written back yet.
+    // LINE:         every line is flushed to the kernel. A process crash
+    //               loses nothing, a power loss as with BUFFERED.
+    // GROUP_COMMIT: as BUFFERED, and every flush ends with an fdatasync().
+    //               Both kinds of crash lose at most interval of lines.
+    //
+    // An ERROR line flushes BUFFERED and syncs GROUP_COMMIT at once.
+    enum class log_durability
+    {
+        BUFFERED = 1,
+        LINE,
+        GROUP_COMMIT
+    };
+
+    struct log_durability_policy
+    {
+        log_durability mode = log_durability::LINE;
+        size_t buffer_size = 64 * 1024;
+        std::chrono::milliseconds interval{100};
+    };
+
+    // When a log file is rotated. A rotated file is renamed to "<name>.<n>",
+    // where n grows with every rotation, and only the newest `keep` are kept.
+    struct log_rotation_policy
+    {
+        uint64_t max_bytes = 0;                 // 0: no size limit.
+        std::chrono::seconds interval{0};       // 0: no time limit.
+        size_t keep = 5;
+        // Called on a background thread with each rotated file once it is
+        // closed, before old files are removed. May compress or upload it.
+        std::function<void(const std::filesystem::path&)> archiver{};
+
+        bool enabled() const { return max_bytes > 0 || interval.count() > 0; }
+    };
+
     class ILogWriter
     {
     public:
@@ -13,6 +76,24 @@ namespace rpp
         virtual void open(std::string_view name) = 0;
         virtual void close() = 0;
         virtual void write(const std::string& message) = 0;
+
+        // Writes one formatted line. Writers that can do so without copying
+        // the line into a std::string override it.
+        virtual void write_line(std::string_view line) {
+            write(std::string(line));
+        }
+
+        // Writes several chunks of complete lines. Writers that can do this
+        // in a single system call override it.
+        virtual void write_batch(const std::vector<std::string_view>& chunks) {
+            for (auto chunk : chunks)
+                write(std::string(chunk));
+        }
+
+        // Called after an ERROR line when the logger has a durability policy.
+        // Writers that hold lines back make them durable; the others need
+        // not do anything.
+        virtual void sync() {}
     };
 
     class ILogWriterFactory
@@ -22,6 +103,16 @@ namespace rpp
         virtual ~ILogWriterFactory() = default;
         virtual std::shared_ptr<ILogWriter> create_console_writer() = 0;
         virtual std::shared_ptr<ILogWriter> create_file_writer() = 0;
+
+        // The writers for the other file_writer_types and for a durability
+        // policy. A factory that does not override them gets its
+        // create_file_writer() writer for every kind of file.
+        virtual std::shared_ptr<ILogWriter> create_durable_file_writer(const log_durability_policy& /* policy */) {
+            return create_file_writer();
+        }
+        virtual std::shared_ptr<ILogWriter> create_fd_file_writer() { return create_file_writer(); }
+        virtual std::shared_ptr<ILogWriter> create_mmap_file_writer() { return create_file_writer(); }
+        virtual std::shared_ptr<ILogWriter> create_uring_file_writer() { return create_file_writer(); }
     };
 }
 #endif
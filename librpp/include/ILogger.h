@@ -1,7 +1,13 @@
 #ifndef ROMI_ROVER_BUILD_AND_TEST_ILOGGER_H
 #define ROMI_ROVER_BUILD_AND_TEST_ILOGGER_H
 
+#include <chrono>
+#include <cstdarg>
 #include <filesystem>
+#include <initializer_list>
+#include <string_view>
+#include "ILogWriter.h"
+
 namespace rpp
 {
     enum class log_level
@@ -12,18 +18,45 @@ namespace rpp
         ERROR
     };
 
+    class LogField;
+    enum class log_record_format;
+
     class ILogger
     {
     public:
         ILogger() = default;
         virtual ~ILogger() = default;
         virtual void log(log_level level, const char* format, ...) = 0;
+        virtual void vlog(log_level level, const char* format, va_list ap) = 0;
+        // Logs a message that is already formatted.
+        virtual void log_message(log_level level, std::string_view message) = 0;
+        // Logs a structured record: the event name followed by its fields.
+        virtual void log_kv(log_level level, std::initializer_list<LogField> event_and_fields) = 0;
 
         virtual std::string get_log_file_path() = 0;
         virtual void set_application_name(std::string_view application_name) = 0;
         virtual void log_to_file(const std::string &log_path) = 0;
         virtual void log_to_console() = 0;
         virtual void move_log(std::filesystem::path newpath) = 0;
+        virtual void set_async(size_t queue_capacity, log_overflow_policy policy) = 0;
+        virtual void set_sync() = 0;
+        virtual void flush() = 0;
+        virtual void set_staging(size_t buffer_size, std::chrono::milliseconds flush_interval) = 0;
+        virtual void clear_staging() = 0;
+        virtual void set_file_writer_type(file_writer_type type) = 0;
+        virtual void set_rotation(const log_rotation_policy& policy) = 0;
+        virtual void set_durability(const log_durability_policy& policy) = 0;
+        virtual void set_record_format(log_record_format format) = 0;
+        // Extra destinations next to the console or file, each with its own
+        // minimum level and writer thread.
+        virtual void add_sink(std::string_view name, const std::shared_ptr<ILogWriter>& writer, log_level level,
+                              size_t queue_capacity, log_overflow_policy policy) = 0;
+        virtual bool remove_sink(std::string_view name) = 0;
+        virtual bool set_sink_level(std::string_view name, log_level level) = 0;
+        // Records every line at or above level, even below the output
+        // threshold, into a crash-surviving circular buffer file.
+        virtual void set_flight_recorder(const std::string& path, size_t size, log_level level) = 0;
+        virtual void clear_flight_recorder() = 0;
     };
 }
 #endif //ROMI_ROVER_BUILD_AND_TEST_ILOGGER_H
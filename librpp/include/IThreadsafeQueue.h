@@ -4,9 +4,35 @@
 #include <mutex>
 #include <optional>
 #include <queue>
+#include <type_traits>
+#include <utility>
+
+// The push() overloads of IThreadsafeQueue. A queue of move-only items has
+// no push(const T&), so copying one into it does not compile.
+template<typename T, bool Copyable = std::is_copy_constructible_v<T>>
+class IThreadsafeQueuePush {
+
+public:
+    virtual ~IThreadsafeQueuePush() = default;
+
+    virtual void push(const T &item) = 0;
+    // Copies unless the implementation overrides it.
+    virtual void push(T &&item) {
+        push(static_cast<const T &>(item));
+    }
+};
+
+template<typename T>
+class IThreadsafeQueuePush<T, false> {
+
+public:
+    virtual ~IThreadsafeQueuePush() = default;
+
+    virtual void push(T &&item) = 0;
+};
 
 template<typename T>
-class IThreadsafeQueue {
+class IThreadsafeQueue : public IThreadsafeQueuePush<T> {
 
 public:
     IThreadsafeQueue() = default;
@@ -14,7 +40,30 @@ public:
 
     [[nodiscard]] virtual unsigned long size() const = 0;
     virtual std::optional<T> pop() = 0;
-    virtual void push(const T &item) = 0;
+};
+
+// Implements both push() overloads with Queue::emplace(), for the queues of
+// this library.
+template<typename Queue, typename T, bool Copyable = std::is_copy_constructible_v<T>>
+class EmplacingThreadsafeQueue : public IThreadsafeQueue<T> {
+
+public:
+    void push(const T &item) override {
+        static_cast<Queue*>(this)->emplace(item);
+    }
+
+    void push(T &&item) override {
+        static_cast<Queue*>(this)->emplace(std::move(item));
+    }
+};
+
+template<typename Queue, typename T>
+class EmplacingThreadsafeQueue<Queue, T, false> : public IThreadsafeQueue<T> {
+
+public:
+    void push(T &&item) override {
+        static_cast<Queue*>(this)->emplace(std::move(item));
+    }
 };
 
 
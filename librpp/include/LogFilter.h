@@ -0,0 +1,143 @@
+#ifndef ROMI_ROVER_BUILD_AND_TEST_LOGFILTER_H
+#define ROMI_ROVER_BUILD_AND_TEST_LOGFILTER_H
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include "ILogger.h"
+
+// Define RPP_LOG_CATEGORY before including Logger.h to give the r_* calls in
+// a file a category for log_set_category_level().
+#ifndef RPP_LOG_CATEGORY
+#define RPP_LOG_CATEGORY nullptr
+#endif
+
+namespace rpp
+{
+    // The state of one r_* call site. Sites cache whether their level is
+    // enabled so that a disabled call costs a single relaxed load. A site
+    // below the output threshold is still enabled, but for the sinks only,
+    // while a sink takes its level, or recorded only, while the flight
+    // recorder captures it. LogFilter
+    // keeps a list of the sites that have been used and updates them when a
+    // threshold changes, so a site must have static storage duration.
+    class LogSite
+    {
+    public:
+        constexpr LogSite(log_level level, const char* category)
+                : level_(level), category_(category), state_(unknown), next_(nullptr) {
+        }
+        LogSite(const LogSite&) = delete;
+        LogSite& operator=(const LogSite&) = delete;
+
+        bool enabled() {
+            int state = state_.load(std::memory_order_relaxed);
+            if (state == unknown)
+                return initialise();
+            return state != off;
+        }
+
+        bool recorded_only() const { return state_.load(std::memory_order_relaxed) == recorded; }
+        bool sinks_only() const { return state_.load(std::memory_order_relaxed) == sinks; }
+
+        log_level level() const { return level_; }
+        const char* category() const { return category_; }
+
+    private:
+        friend class LogFilter;
+        static constexpr int unknown = 0;
+        static constexpr int off = 1;
+        static constexpr int on = 2;
+        static constexpr int recorded = 3;
+        static constexpr int sinks = 4;
+
+        bool initialise();
+
+        const log_level level_;
+        const char* const category_;
+        std::atomic<int> state_;
+        LogSite* next_;
+    };
+
+    // Runtime log thresholds: a minimum level for the primary console or file
+    // writer and optional per-category levels that override it. The sinks
+    // have levels of their own: a message is formatted when it passes the
+    // output threshold or the lowest sink level.
+    class LogFilter
+    {
+    public:
+        static void set_min_level(log_level level);
+        static log_level min_level();
+        static void set_category_level(std::string_view category, log_level level);
+        static void clear_category_levels();
+        static bool is_enabled(log_level level, const char* category);
+
+        // Messages at or above the record level reach the flight recorder
+        // even when they are below the output threshold.
+        static void set_record_level(log_level level);
+        static void clear_record_level();
+        static bool is_recorded(log_level level);
+
+        // The lowest level of any sink, kept up to date by Logger.
+        static void set_sink_level(log_level level);
+        static void clear_sink_level();
+        static bool reaches_sinks(log_level level);
+
+    private:
+        friend class LogSite;
+        static bool is_enabled_locked(log_level level, const char* category);
+        static int site_state_locked(log_level level, const char* category);
+        static void register_site(LogSite* site);
+        static void update_sites();
+
+        static std::mutex mutex_;
+        static std::atomic<int> min_level_;
+        static std::atomic<int> record_level_;
+        static std::atomic<int> sink_level_;
+        static std::map<std::string, log_level, std::less<>> category_levels_;
+        static LogSite* sites_;
+    };
+
+    // Marks the lines logged by this thread while it is in scope as
+    // recorded only: they go to the flight recorder and nowhere else.
+    class RecordOnlyScope
+    {
+    public:
+        explicit RecordOnlyScope(bool record_only) : previous_(active_) {
+            active_ = record_only;
+        }
+        ~RecordOnlyScope() { active_ = previous_; }
+        RecordOnlyScope(const RecordOnlyScope&) = delete;
+        RecordOnlyScope& operator=(const RecordOnlyScope&) = delete;
+
+        static bool active() { return active_; }
+
+    private:
+        const bool previous_;
+        static inline thread_local bool active_ = false;
+    };
+
+    // Marks the lines logged by this thread while it is in scope as below
+    // the output threshold: they go to the sinks that take their level, and
+    // to the flight recorder, but not to the primary writer.
+    class SinksOnlyScope
+    {
+    public:
+        explicit SinksOnlyScope(bool sinks_only) : previous_(active_) {
+            active_ = sinks_only;
+        }
+        ~SinksOnlyScope() { active_ = previous_; }
+        SinksOnlyScope(const SinksOnlyScope&) = delete;
+        SinksOnlyScope& operator=(const SinksOnlyScope&) = delete;
+
+        static bool active() { return active_; }
+
+    private:
+        const bool previous_;
+        static inline thread_local bool active_ = false;
+    };
+}
+
+#endif
@@ -0,0 +1,127 @@
+#ifndef ROMI_ROVER_BUILD_AND_TEST_LOGLIMITER_H
+#define ROMI_ROVER_BUILD_AND_TEST_LOGLIMITER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string_view>
+#include "ILogger.h"
+
+namespace rpp
+{
+    // Log storm suppression for one r_* call site. Both limits are off by
+    // default, and then allow() is a single relaxed load.
+    //
+    // Rate limit: a token bucket (kept as a theoretical arrival time, GCRA)
+    // lets a burst of messages through and then one per 1/rate seconds. It
+    // is checked, lock-free, before anything is formatted.
+    // Deduplication: a formatted message that is identical to the previous
+    // one from the same call site is counted instead of written. The count
+    // is reported as "message repeated N times in X s: <message>" when the
+    // site logs something else, when the thread logs from another site or
+    // when the window has passed. The comparison needs the formatted text,
+    // so it runs after formatting, under a lock of the call site.
+    //
+    // A limiter must have static storage duration.
+    class LogLimiter
+    {
+    public:
+        constexpr LogLimiter(log_level level, const char* file, int line)
+                : level_(level), file_(file), line_(line), tat_(0), suppressed_(0),
+                  suppressed_since_(0), mutex_(), registered_(false), next_(nullptr), has_last_(false),
+                  last_hash_(0), repeats_(0), repeat_start_(0), text_(), text_size_(0) {
+        }
+        LogLimiter(const LogLimiter&) = delete;
+        LogLimiter& operator=(const LogLimiter&) = delete;
+
+        bool allow() {
+            if (!active_.load(std::memory_order_relaxed))
+                return true;
+            return check();
+        }
+
+        // messages_per_second <= 0 turns the rate limit off.
+        static void set_rate_limit(double messages_per_second, size_t burst);
+        // A zero window turns deduplication off.
+        static void set_deduplication(std::chrono::milliseconds window);
+        // Reports the repeats counted at every call site. The next message
+        // of each site is written again.
+        static void flush();
+
+        // Called by the logger once the message of the current call site is
+        // formatted. True when it repeats the site's previous message and is
+        // not to be written. False outside of a Scope, and for every message
+        // after the first in one.
+        static bool is_repeat(std::string_view message);
+        // True when a message of this thread is waiting for is_repeat().
+        static bool checking() { return current_ != nullptr; }
+
+        // Makes limiter the current call site of the thread while deduplication
+        // is on.
+        class Scope
+        {
+        public:
+            explicit Scope(LogLimiter& limiter) {
+                if (window_ns_.load(std::memory_order_relaxed) > 0)
+                    current_ = &limiter;
+            }
+            ~Scope() { current_ = nullptr; }
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+        };
+
+    private:
+        static constexpr size_t max_text_size = 128;
+
+        struct repeat_report
+        {
+            uint64_t count;
+            double seconds;
+            char text[max_text_size];
+            size_t text_size;
+        };
+
+        bool check();
+        bool acquire_token(int64_t now);
+        void report_suppressed(int64_t now);
+        bool repeat(std::string_view message, int64_t now);
+        void report_repeats(int64_t now, bool forget);
+        void take_repeats(int64_t now, repeat_report& report);
+        void write_report(const repeat_report& report) const;
+        void register_site();
+        const char* file_name() const;
+        static int64_t now_ns();
+        static void update_active();
+
+        const log_level level_;
+        const char* const file_;
+        const int line_;
+        std::atomic<int64_t> tat_;
+        std::atomic<uint64_t> suppressed_;
+        std::atomic<int64_t> suppressed_since_;
+
+        // Deduplication state, guarded by mutex_.
+        std::mutex mutex_;
+        bool registered_;
+        LogLimiter* next_;
+        bool has_last_;
+        uint64_t last_hash_;
+        uint64_t repeats_;
+        int64_t repeat_start_;
+        char text_[max_text_size];
+        size_t text_size_;
+
+        static std::atomic<bool> active_;
+        static std::atomic<int64_t> interval_ns_;
+        static std::atomic<int64_t> tolerance_ns_;
+        static std::atomic<int64_t> window_ns_;
+        // The sites that have deduplicated, linked through next_.
+        static std::atomic<LogLimiter*> sites_;
+        static inline thread_local LogLimiter* current_ = nullptr;
+        // The site this thread last logged from.
+        static inline thread_local LogLimiter* previous_ = nullptr;
+    };
+}
+
+#endif
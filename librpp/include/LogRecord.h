@@ -0,0 +1,122 @@
+#ifndef ROMI_ROVER_BUILD_AND_TEST_LOGRECORD_H
+#define ROMI_ROVER_BUILD_AND_TEST_LOGRECORD_H
+
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include "ILogger.h"
+#include "StringFormat.h"
+
+// Structured log records: an event name and typed key-value fields, logged
+// with r_info_kv("motor", {"rpm", 1200}, {"current", 3.2}). Logger encodes
+// every line, structured or not, in the format chosen with
+// log_set_record_format():
+//
+// TEXT:       "DTC, LL, app, THREAD, motor rpm=1200 current=3.2"
+// JSON_LINES: {"time":1600000000123000000,"level":"INFO","app":"rover",
+//              "thread":"motor:3:1234","event":"motor","fields":{"rpm":1200,...}}
+//             A plain r_* message is written as "msg" instead of
+//             "event" and "fields". "time" is in nanoseconds.
+// BINARY:     u32 length of the rest of the record, u8 level, u64 time,
+//             then thread, app, event and message as u16 length +
+//             bytes, u8 field count and per field: u8 key length + key,
+//             a one byte tag and the value: 'i' i64, 'u' u64, 'f' f64,
+//             'b' u8, 's' u16 length + bytes. Host byte order.
+// THREAD is the ThreadIdentity field: "id:tid" or "name:id:tid".
+
+namespace rpp
+{
+    enum class log_record_format
+    {
+        TEXT = 1,
+        JSON_LINES,
+        BINARY
+    };
+
+    class LogField
+    {
+    public:
+        enum class field_type
+        {
+            NONE = 0,
+            INT,
+            UINT,
+            DOUBLE,
+            BOOL,
+            STRING
+        };
+
+        // A key without a value: the event name of a record.
+        LogField(const char* key) : LogField(std::string_view(key)) {}
+        LogField(const std::string& key) : LogField(std::string_view(key)) {}
+        explicit LogField(std::string_view key)
+                : key_(key), type_(field_type::NONE), int_(0), uint_(0), double_(0.0), string_() {
+        }
+
+        template <typename T>
+        LogField(std::string_view key, const T& value)
+                : key_(key), type_(field_type::NONE), int_(0), uint_(0), double_(0.0), string_() {
+            using U = std::decay_t<T>;
+            if constexpr (std::is_same_v<U, bool>) {
+                type_ = field_type::BOOL;
+                uint_ = value ? 1 : 0;
+            } else if constexpr (std::is_integral_v<U> && std::is_signed_v<U>) {
+                type_ = field_type::INT;
+                int_ = static_cast<int64_t>(value);
+            } else if constexpr (std::is_integral_v<U>) {
+                type_ = field_type::UINT;
+                uint_ = static_cast<uint64_t>(value);
+            } else if constexpr (std::is_floating_point_v<U>) {
+                type_ = field_type::DOUBLE;
+                double_ = static_cast<double>(value);
+            } else {
+                static_assert(std::is_convertible_v<const T&, std::string_view>,
+                              "log fields must be numbers, booleans or strings");
+                type_ = field_type::STRING;
+                string_ = std::string_view(value);
+            }
+        }
+
+        std::string_view key() const { return key_; }
+        field_type type() const { return type_; }
+        int64_t int_value() const { return int_; }
+        uint64_t uint_value() const { return uint_; }
+        double double_value() const { return double_; }
+        bool bool_value() const { return uint_ != 0; }
+        std::string_view string_value() const { return string_; }
+
+    private:
+        std::string_view key_;
+        field_type type_;
+        int64_t int_;
+        uint64_t uint_;
+        double double_;
+        std::string_view string_;
+    };
+
+    // A view of one log line. Nothing is owned; the strings and fields must
+    // outlive the record.
+    struct LogRecord
+    {
+        log_level level = log_level::INFO;
+        uint64_t timestamp = 0;
+        std::string_view thread{};
+        std::string_view application{};
+        std::string_view event{};
+        std::string_view message{};
+        const LogField* fields = nullptr;
+        size_t field_count = 0;
+    };
+
+    constexpr size_t log_line_buffer_size = 1024;
+    using LogBuffer = StringUtils::FormatBuffer<log_line_buffer_size>;
+
+    // Appends the message, or the event and its fields, as text.
+    void encode_text_body(const LogRecord& record, LogBuffer& out);
+    void encode_json_line(const LogRecord& record, LogBuffer& out);
+    void encode_binary_record(const LogRecord& record, LogBuffer& out);
+}
+
+#endif
@@ -0,0 +1,102 @@
+#ifndef ROMI_ROVER_BUILD_AND_TEST_LOGSEARCH_H
+#define ROMI_ROVER_BUILD_AND_TEST_LOGSEARCH_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "ILogger.h"
+
+// Searches TEXT format log files ("DTC, LL, app, THREAD, message") by time,
+// level and application without reading the whole file. The file is memory
+// mapped and a sparse index keeps, for every block of about stride bytes,
+// the offset of its first line and the lowest and highest timestamp in it.
+// A query binary-searches the index for the first block that can hold its
+// start time. From there it reads only the blocks whose time range overlaps
+// the query's.
+//
+// Lines need not be in time order: with staging, a thread's lines can reach
+// the file after newer lines of other threads. A line without a timestamp,
+// such as the rest of a multi-line message, goes with the line before it.
+//
+// The index is kept next to the log as "<log>.idx": the magic "RPPLIX01",
+// u64 stride, u64 device, u64 inode, u64 number of bytes indexed, u64 entry
+// count and per entry u64 offset, u64 lowest and u64 highest timestamp, in
+// host byte order. It is brought up to date as the log grows and rebuilt
+// when the log has been replaced or truncated.
+
+namespace rpp
+{
+    // Timestamps are compact datetimes as numbers: "20261016-235939.620"
+    // is 20261016235939620.
+    struct log_query
+    {
+        uint64_t from = 0;                      // Inclusive.
+        uint64_t to = UINT64_MAX;               // Exclusive.
+        log_level level = log_level::DEBUG;     // The lowest level shown.
+        std::string application{};              // Empty: every application.
+    };
+
+    class LogSearch
+    {
+    public:
+        static constexpr size_t default_stride = 64 * 1024;
+        static constexpr char magic[] = "RPPLIX01";
+        static constexpr size_t magic_size = 8;
+
+        // Maps the log and loads or builds its index. Throws std::runtime_error.
+        explicit LogSearch(const std::string& path, size_t stride = default_stride);
+        ~LogSearch();
+        LogSearch(const LogSearch&) = delete;
+        LogSearch& operator=(const LogSearch&) = delete;
+
+        // Indexes the lines appended since the last call, or everything if
+        // the file was replaced or truncated. Returns the bytes indexed.
+        uint64_t refresh();
+        // Writes the index to index_path(). Throws std::runtime_error.
+        void save_index() const;
+
+        // Calls found with every matching line, newline included, in file
+        // order. Returns the number of lines found.
+        size_t search(const log_query& query, const std::function<void(std::string_view)>& found) const;
+
+        size_t index_entries() const { return entries_.size(); }
+        uint64_t indexed_size() const { return indexed_size_; }
+        const std::string& path() const { return path_; }
+
+        static std::string index_path(const std::string& log_path);
+        // Accepts a compact datetime or a prefix of one of at least the
+        // date: "20261016", "20261016-2359". Throws std::invalid_argument.
+        static uint64_t parse_time(std::string_view datetime);
+
+    private:
+        struct Entry
+        {
+            uint64_t offset;
+            uint64_t min_time;
+            uint64_t max_time;
+        };
+
+        void map();
+        void unmap();
+        bool load_index();
+        bool index_matches_file() const;
+        void reset_index();
+        std::string_view mapped(uint64_t begin, uint64_t end) const;
+
+        const std::string path_;
+        const size_t stride_;
+        int fd_;
+        const char* map_;
+        size_t map_size_;
+        uint64_t device_;
+        uint64_t inode_;
+        std::vector<Entry> entries_;
+        // The highest time up to and including each entry, for the search.
+        std::vector<uint64_t> max_so_far_;
+        uint64_t indexed_size_;
+    };
+}
+
+#endif
@@ -0,0 +1,104 @@
+#ifndef ROMI_ROVER_BUILD_AND_TEST_LOGSINK_H
+#define ROMI_ROVER_BUILD_AND_TEST_LOGSINK_H
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "ILogger.h"
+
+namespace rpp
+{
+    // A formatted line shared by every sink that writes it.
+    using shared_log_line = std::shared_ptr<const std::string>;
+
+    // One extra destination of the log, with its own minimum level, queue
+    // and writer thread, so a slow sink does not hold up the others. The
+    // sink owns the writer, which must already be open, and closes it once
+    // its queue is drained.
+    class LogSink
+    {
+    public:
+        static constexpr size_t default_capacity = 8192;
+
+        LogSink(std::string_view name, const std::shared_ptr<ILogWriter>& writer, log_level level,
+                size_t capacity = default_capacity,
+                log_overflow_policy policy = log_overflow_policy::COUNT_AND_DROP);
+        ~LogSink();
+        LogSink(const LogSink&) = delete;
+        LogSink& operator=(const LogSink&) = delete;
+
+        const std::string& name() const { return name_; }
+        log_level level() const { return level_.load(std::memory_order_relaxed); }
+        void set_level(log_level level) { level_.store(level, std::memory_order_relaxed); }
+        bool accepts(log_level level) const { return level >= this->level(); }
+
+        // Queues the line without copying it.
+        void post(const shared_log_line& line);
+        // Blocks until every line posted before the call has been written.
+        void flush();
+        uint64_t dropped() const;
+
+    private:
+        void run();
+        void stop();
+
+        const std::string name_;
+        const std::shared_ptr<ILogWriter> writer_;
+        std::atomic<log_level> level_;
+        const size_t capacity_;
+        const log_overflow_policy policy_;
+
+        std::mutex queue_mutex_;
+        std::condition_variable not_empty_;
+        std::condition_variable not_full_;
+        std::condition_variable written_;
+        std::vector<shared_log_line> queue_;
+        uint64_t enqueued_;
+        uint64_t completed_;
+        bool quit_;
+        std::atomic<uint64_t> dropped_;
+        uint64_t reported_dropped_;
+        std::thread thread_;
+    };
+
+    // The registry of sinks. A line is formatted once by Logger and handed
+    // to every sink whose level accepts it. Publishing reads a copy-on-write
+    // list and takes no lock shared with add() or remove().
+    class LogSinks
+    {
+    public:
+        LogSinks();
+        LogSinks(const LogSinks&) = delete;
+        LogSinks& operator=(const LogSinks&) = delete;
+
+        // Replaces a sink with the same name.
+        void add(const std::shared_ptr<LogSink>& sink);
+        bool remove(std::string_view name);
+        bool set_level(std::string_view name, log_level level);
+        std::shared_ptr<LogSink> find(std::string_view name) const;
+        // The lowest level of the sinks; false when there are none.
+        bool min_level(log_level& level) const;
+        void clear();
+        bool empty() const { return count_.load(std::memory_order_acquire) == 0; }
+
+        void publish(log_level level, std::string_view line);
+        void flush();
+
+    private:
+        using sink_list = std::vector<std::shared_ptr<LogSink>>;
+
+        std::shared_ptr<const sink_list> load() const;
+        void store(const std::shared_ptr<const sink_list>& sinks);
+
+        std::mutex mutex_;
+        std::shared_ptr<const sink_list> sinks_;
+        std::atomic<size_t> count_;
+    };
+}
+
+#endif
@@ -0,0 +1,83 @@
+#ifndef ROMI_ROVER_BUILD_AND_TEST_LOGSTAGING_H
+#define ROMI_ROVER_BUILD_AND_TEST_LOGSTAGING_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "ILogWriter.h"
+
+namespace rpp
+{
+    // Per-thread staging buffers for formatted log lines. A thread appends to
+    // its own buffer, which no other logging thread touches. A buffer is
+    // handed to the writer when it is full, and a timer thread hands over all
+    // pending buffers in one write_batch() call every flush interval. Lines
+    // of one thread keep their order; lines of different threads are ordered
+    // by their timestamps.
+    //
+    // The logger keeps one staging for good: a logging thread may still hold
+    // it after it is turned off. stop() and start() turn the timer thread
+    // off and on again.
+    class LogStaging
+    {
+    public:
+        static constexpr size_t default_buffer_size = 64 * 1024;
+        static constexpr std::chrono::milliseconds default_flush_interval{100};
+
+        LogStaging(size_t buffer_size, std::chrono::milliseconds flush_interval);
+        ~LogStaging();
+        LogStaging(const LogStaging&) = delete;
+        LogStaging& operator=(const LogStaging&) = delete;
+
+        // Restarts the timer thread with new settings. Lines already staged
+        // are kept.
+        void start(size_t buffer_size, std::chrono::milliseconds flush_interval);
+        // Stops the timer thread. Lines are only written by flush() and by
+        // append() on a full buffer until the next start().
+        void stop();
+        // Pending lines are written to the previous writer first. While the
+        // writer is null, lines are kept.
+        void set_writer(const std::shared_ptr<ILogWriter>& writer);
+        void append(std::string_view line);
+        void flush();
+        // Flushes, then asks the writer to sync.
+        void sync();
+
+    private:
+        struct Buffer
+        {
+            Buffer() : mutex(), data() {}
+            std::mutex mutex;
+            std::string data;
+        };
+
+        Buffer& thread_buffer();
+        void flush_locked();
+        void run();
+
+        const uint64_t id_;
+        std::atomic<size_t> buffer_size_;
+        // Only changed while the timer thread is stopped.
+        std::chrono::milliseconds flush_interval_;
+
+        // Serialises flushes and guards the members below.
+        std::mutex flush_mutex_;
+        std::shared_ptr<ILogWriter> writer_;
+        std::vector<std::shared_ptr<Buffer>> buffers_;
+        std::vector<std::string> pending_;
+        std::vector<std::string_view> chunks_;
+
+        std::mutex timer_mutex_;
+        std::condition_variable timer_;
+        bool quit_;
+        std::thread thread_;
+    };
+}
+
+#endif
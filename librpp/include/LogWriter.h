@@ -1,9 +1,14 @@
 #ifndef ROMI_ROVER_BUILD_AND_TEST_LOGWRITER_H
 #define ROMI_ROVER_BUILD_AND_TEST_LOGWRITER_H
 
+#include <atomic>
+#include <condition_variable>
 #include <filesystem>
 #include <iostream>
 #include <fstream>
+#include <mutex>
+#include <thread>
+#include "AsyncFileWriter.h"
 #include "ILogWriter.h"
 
 namespace rpp
@@ -19,18 +24,147 @@ namespace rpp
         void write(const std::string& message) override{
             std::cout << message << std::flush;
         };
+        void write_line(std::string_view line) override{
+            std::cout << line << std::flush;
+        };
+    };
+
+    // Discards everything. Measures the cost of logging without any I/O.
+    class NullLogWriter : public ILogWriter
+    {
+    public:
+        NullLogWriter() = default;
+        ~NullLogWriter() override = default;
+        void open(const std::string_view name) override {(void)name;};
+        void close() override {};
+        void write(const std::string& message) override {(void)message;};
+        void write_line(std::string_view line) override {(void)line;};
+        void write_batch(const std::vector<std::string_view>& chunks) override {(void)chunks;};
     };
 
+    // Writes through a std::ofstream. The durability policy decides when the
+    // stream is flushed and the file synced; BUFFERED and GROUP_COMMIT do it
+    // on a timer thread. The file is synced through a second descriptor, as
+    // the stream does not expose its own.
     class FileLogWriter : public ILogWriter
     {
     private:
+        const log_durability_policy policy_;
+        std::vector<char> buffer_;
         std::ofstream write_stream;
+        int sync_fd_;
+        // Guards the stream against the timer thread.
+        std::mutex mutex_;
+        // Held around fdatasync(), which runs without mutex_.
+        std::mutex sync_mutex_;
+        std::condition_variable timer_;
+        bool dirty_;
+        bool quit_;
+        std::thread thread_;
+
+        void written();
+        void sync_file();
+        void run();
     public:
-        FileLogWriter();
-        ~FileLogWriter() override = default;
+        explicit FileLogWriter(const log_durability_policy& policy = log_durability_policy());
+        ~FileLogWriter() override;
+        FileLogWriter(const FileLogWriter&) = delete;
+        FileLogWriter& operator=(const FileLogWriter&) = delete;
         void open(std::string_view file_name) override;
         void close() override;
         void write(const std::string& message) override;
+        void write_line(std::string_view line) override;
+        void write_batch(const std::vector<std::string_view>& chunks) override;
+        void sync() override;
+        const log_durability_policy& durability() const { return policy_; }
+    };
+
+    // Appends to a file through a raw descriptor. A batch of chunks is
+    // written with a single writev() call.
+    class FdLogWriter : public ILogWriter
+    {
+    private:
+        int fd_;
+        void write_all(const char* data, size_t size);
+    public:
+        FdLogWriter();
+        ~FdLogWriter() override;
+        FdLogWriter(const FdLogWriter&) = delete;
+        FdLogWriter& operator=(const FdLogWriter&) = delete;
+        void open(std::string_view file_name) override;
+        void close() override;
+        void write(const std::string& message) override;
+        void write_line(std::string_view line) override;
+        void write_batch(const std::vector<std::string_view>& chunks) override;
+    };
+
+    // Appends to a file by copying into a shared memory mapping. The file is
+    // grown one preallocated segment at a time and the next segment is mapped
+    // when the current one is full, so a write is a memcpy rather than a
+    // system call. close() trims the unused part of the last segment.
+    class MmapLogWriter : public ILogWriter
+    {
+    public:
+        static constexpr size_t default_segment_size = 4 * 1024 * 1024;
+
+        explicit MmapLogWriter(size_t segment_size = default_segment_size);
+        ~MmapLogWriter() override;
+        MmapLogWriter(const MmapLogWriter&) = delete;
+        MmapLogWriter& operator=(const MmapLogWriter&) = delete;
+        void open(std::string_view file_name) override;
+        void close() override;
+        void write(const std::string& message) override;
+        void write_line(std::string_view line) override;
+        void write_batch(const std::vector<std::string_view>& chunks) override;
+        // The number of bytes in the file that hold log data.
+        uint64_t size() const;
+
+    private:
+        void append(const char* data, size_t length);
+        bool map_segment(uint64_t offset);
+        void unmap_segment();
+
+        const size_t segment_size_;
+        int fd_;
+        char* map_;
+        uint64_t map_offset_;
+        std::atomic<uint64_t> tail_;
+    };
+
+    // Appends to a file through an AsyncFileWriter: lines are copied into
+    // registered buffers, and the caller does not wait for the disk. A full
+    // buffer is submitted at once; the partly filled one on a timer thread
+    // every interval, on sync() and on close(), so that one io_uring_enter()
+    // call carries many lines. On kernels without io_uring a writer thread
+    // does the pwrite() calls.
+    class UringLogWriter : public ILogWriter
+    {
+    public:
+        explicit UringLogWriter(async_io_backend backend = async_io_backend::AUTO,
+                                std::chrono::milliseconds interval = std::chrono::milliseconds(100));
+        ~UringLogWriter() override;
+        UringLogWriter(const UringLogWriter&) = delete;
+        UringLogWriter& operator=(const UringLogWriter&) = delete;
+        void open(std::string_view file_name) override;
+        void close() override;
+        void write(const std::string& message) override;
+        void write_line(std::string_view line) override;
+        void write_batch(const std::vector<std::string_view>& chunks) override;
+        // Submits the held lines and waits until they are on the file.
+        void sync() override;
+        async_io_backend backend() const { return writer_.backend(); }
+
+    private:
+        void run();
+
+        AsyncFileWriter writer_;
+        const std::chrono::milliseconds interval_;
+        // Guards writer_ against the timer thread.
+        std::mutex mutex_;
+        std::condition_variable timer_;
+        bool dirty_;
+        bool quit_;
+        std::thread thread_;
     };
 
     class LogWriterFactory : public ILogWriterFactory
@@ -40,6 +174,10 @@ namespace rpp
         ~LogWriterFactory() override = default;
         std::shared_ptr<ILogWriter> create_console_writer() override;
         std::shared_ptr<ILogWriter> create_file_writer() override;
+        std::shared_ptr<ILogWriter> create_durable_file_writer(const log_durability_policy& policy) override;
+        std::shared_ptr<ILogWriter> create_fd_file_writer() override;
+        std::shared_ptr<ILogWriter> create_mmap_file_writer() override;
+        std::shared_ptr<ILogWriter> create_uring_file_writer() override;
     };
 
 }
@@ -5,7 +5,14 @@
 #include <fstream>
 #include <map>
 #include "ILogWriter.h"
+#include "AsyncLogWriter.h"
+#include "FlightRecorder.h"
+#include "LogStaging.h"
 #include "ILogger.h"
+#include "LogFilter.h"
+#include "LogLimiter.h"
+#include "LogRecord.h"
+#include "LogSink.h"
 #include "StringUtils.h"
 
 namespace rpp
@@ -18,26 +25,91 @@ namespace rpp
         std::string application_name_;
         static std::recursive_mutex log_mutex_;
         static std::shared_ptr<ILogger> logger_;
-        std::map<log_level, std::string> log_level_names_;
+        static std::atomic<ILogger*> published_;
+        // Taken before log_mutex_ by the calls that replace the writer, so
+        // that move_log() can do its I/O without holding log_mutex_.
+        std::recursive_mutex switch_mutex_;
         const std::shared_ptr<ILogWriterFactory> logWriterFactory_;
         std::shared_ptr<ILogWriter> logWriter_;
+        bool async_;
+        size_t async_capacity_;
+        log_overflow_policy async_policy_;
+        file_writer_type file_writer_type_;
+        log_rotation_policy rotation_;
+        log_durability_policy durability_;
+        // Set when ERROR lines are to be synced.
+        std::atomic<bool> sync_errors_;
+        std::atomic<log_record_format> record_format_;
+        LogSinks sinks_;
+        // Read with std::atomic_load, so that a thread that is recording
+        // keeps the old recorder, and its mapping, alive until it is done.
+        // recording_ spares the other lines the load.
+        std::shared_ptr<FlightRecorder> recorder_;
+        std::atomic<bool> recording_;
+        // Declared last so that pending lines are written before the writer goes.
+        std::atomic<LogStaging*> staging_;
+        // Created by the first set_staging() and then reused, because a thread
+        // may still be appending to it after clear_staging().
+        std::unique_ptr<LogStaging> staging_instance_;
 
     private:
         explicit Logger(const std::shared_ptr<ILogWriterFactory>& logWriterFactory);
+        static void reset_instance(const std::shared_ptr<ILogger>& logger);
+        std::shared_ptr<ILogWriter> wrap_writer(const std::shared_ptr<ILogWriter>& writer);
+        std::shared_ptr<ILogWriter> create_file_writer();
+        static std::shared_ptr<ILogWriter> create_file_writer(const std::shared_ptr<ILogWriterFactory>& factory,
+                                                              file_writer_type type,
+                                                              const log_durability_policy& durability);
+        void detach_writer();
+        void open_file_writer(const std::string& log_path);
+        void replace_writer(const std::shared_ptr<ILogWriter>& writer);
+        size_t format_prefix(char* line, size_t size, log_level level);
+        void log_record(const LogRecord& record);
+        void write_line(log_level level, std::string_view line);
+        void update_sink_level();
 
     public:
-        ~Logger() override = default;
+        // Lines up to this size are assembled in a thread local buffer
+        // without touching the heap.
+        static constexpr size_t line_buffer_size = log_line_buffer_size;
+
+        ~Logger() override;
         Logger(Logger &other) = delete;
         void operator=(const Logger &) = delete;
-        static std::shared_ptr<ILogger> Instance();
+        // Once the logger is published, this is a single acquire load: no
+        // lock and no reference count.
+        static const std::shared_ptr<ILogger>& Instance();
+        // Replaces the logger with a new one that creates its writers through
+        // factory, for example to put another writer behind the console.
+        // Must not race with threads that are logging.
+        static void set_writer_factory(const std::shared_ptr<ILogWriterFactory>& factory);
         void move_log(std::filesystem::path newpath) override;
         void log(log_level level, const char* format, ...) override;
+        void vlog(log_level level, const char* format, va_list ap) override;
+        void log_message(log_level level, std::string_view message) override;
+        void log_kv(log_level level, std::initializer_list<LogField> event_and_fields) override;
         std::string get_log_file_path() override;
         void set_application_name(std::string_view application_name) override;
         void log_to_file(const std::string &log_path) override;
         void log_to_console() override;
+        void set_async(size_t queue_capacity, log_overflow_policy policy) override;
+        void set_sync() override;
+        void flush() override;
+        void set_staging(size_t buffer_size, std::chrono::milliseconds flush_interval) override;
+        void clear_staging() override;
+        void set_file_writer_type(file_writer_type type) override;
+        void set_rotation(const log_rotation_policy& policy) override;
+        void set_durability(const log_durability_policy& policy) override;
+        void set_record_format(log_record_format format) override;
+        void add_sink(std::string_view name, const std::shared_ptr<ILogWriter>& writer, log_level level,
+                      size_t queue_capacity, log_overflow_policy policy) override;
+        bool remove_sink(std::string_view name) override;
+        bool set_sink_level(std::string_view name, log_level level) override;
+        void set_flight_recorder(const std::string& path, size_t size, log_level level) override;
+        void clear_flight_recorder() override;
     public:
         // The only real way to test a singleton with Dependency injection. Best of all evils.
+        // They must not race with threads that are logging.
         friend void set_instance(const std::shared_ptr<ILogWriterFactory>& factory);
         friend void clear_instance();
 
@@ -51,26 +123,148 @@ void log_set_application(std::string_view application_name);
 int log_set_file(const std::string &path);
 std::string log_get_file();
 void log_set_console();
+void log_set_writer_factory(const std::shared_ptr<rpp::ILogWriterFactory>& factory);
 void log_move(std::filesystem::path newpath);
+void log_set_async(size_t queue_capacity = rpp::AsyncLogWriter::default_capacity,
+                   rpp::log_overflow_policy policy = rpp::log_overflow_policy::BLOCK);
+void log_set_sync();
+void log_flush();
+void log_set_staging(size_t buffer_size = rpp::LogStaging::default_buffer_size,
+                     std::chrono::milliseconds flush_interval = rpp::LogStaging::default_flush_interval);
+void log_clear_staging();
+void log_set_file_writer_type(rpp::file_writer_type type);
+void log_set_rotation(const rpp::log_rotation_policy& policy);
+// Applies to the STREAM file writer.
+void log_set_durability(const rpp::log_durability_policy& policy);
+void log_set_record_format(rpp::log_record_format format);
 
-template <typename ...Args>
-void r_err(const std::string format, Args && ...args) {
-    rpp::Logger::Instance()->log(rpp::log_level::ERROR, format.c_str(), std::forward<Args>(args)...);
-}
+// The sink owns the writer, which must already be open. Each sink has its
+// own level, independent of the one log_set_level() sets for the primary
+// console or file writer: with the console at WARNING and a file sink at
+// DEBUG, the console only gets warnings and errors.
+void log_add_sink(std::string_view name, const std::shared_ptr<rpp::ILogWriter>& writer, rpp::log_level level,
+                  size_t queue_capacity = rpp::LogSink::default_capacity,
+                  rpp::log_overflow_policy policy = rpp::log_overflow_policy::COUNT_AND_DROP);
+bool log_remove_sink(std::string_view name);
+bool log_set_sink_level(std::string_view name, rpp::log_level level);
 
-template <typename ...Args>
-void r_warn(const std::string format, Args && ...args){
-    rpp::Logger::Instance()->log(rpp::log_level::WARNING, format.c_str(), std::forward<Args>(args)...);
-}
+// Throws std::runtime_error when the file cannot be created.
+void log_set_flight_recorder(const std::string& path, size_t size = rpp::FlightRecorder::default_size,
+                             rpp::log_level level = rpp::log_level::DEBUG);
+void log_clear_flight_recorder();
 
-template <typename ...Args>
-void r_info(const std::string format, Args && ...args){
-    rpp::Logger::Instance()->log(rpp::log_level::INFO, format.c_str(), std::forward<Args>(args)...);
-}
+void log_set_rate_limit(double messages_per_second, size_t burst);
+void log_set_deduplication(std::chrono::milliseconds window);
 
-template <typename ...Args>
-void r_debug(const std::string format, Args && ...args) {
-    rpp::Logger::Instance()->log(rpp::log_level::DEBUG, format.c_str(), std::forward<Args>(args)...);
+void log_set_level(rpp::log_level level);
+void log_set_category_level(std::string_view category, rpp::log_level level);
+
+namespace rpp
+{
+    // Logs without consulting the minimum level. Used by the r_* macros, whose
+    // call site has already been checked against the filter.
+    void log_unfiltered(log_level level, const char* format, ...);
+
+    template <typename ...Args>
+    void log_at(log_level level, const char* format, Args && ...args) {
+        log_unfiltered(level, format, std::forward<Args>(args)...);
+    }
+
+    template <typename ...Args>
+    void log_at(log_level level, const std::string& format, Args && ...args) {
+        log_unfiltered(level, format.c_str(), std::forward<Args>(args)...);
+    }
+
+    // The thread's buffer for messages formatted by the overload below.
+    StringUtils::FormatBuffer<Logger::line_buffer_size>& log_format_buffer();
+
+    // A format wrapped in RPP_FMT() is checked at compile time and formatted
+    // without printf: r_info(RPP_FMT("speed %d"), speed).
+    template <typename Format, typename ...Args,
+              typename = std::enable_if_t<StringUtils::format::is_format_string_v<Format>>>
+    void log_at(log_level level, Format format, const Args& ...args) {
+        auto& buffer = log_format_buffer();
+        buffer.clear();
+        StringUtils::format_to(buffer, format, args...);
+        Logger::Instance()->log_message(level, buffer.view());
+    }
 }
 
+// Levels below RPP_LOG_MIN_LEVEL (1 = DEBUG ... 4 = ERROR) are compiled out.
+#ifndef RPP_LOG_MIN_LEVEL
+#define RPP_LOG_MIN_LEVEL 1
+#endif
+
+#define RPP_LOG_AT(level, ...) \
+    do { \
+        static rpp::LogSite rpp_log_site_(level, RPP_LOG_CATEGORY); \
+        static rpp::LogLimiter rpp_log_limiter_(level, __FILE__, __LINE__); \
+        if (rpp_log_site_.enabled() && rpp_log_limiter_.allow()) { \
+            rpp::RecordOnlyScope rpp_record_only_(rpp_log_site_.recorded_only()); \
+            rpp::SinksOnlyScope rpp_sinks_only_(rpp_log_site_.sinks_only()); \
+            rpp::LogLimiter::Scope rpp_limiter_scope_(rpp_log_limiter_); \
+            rpp::log_at(level, __VA_ARGS__); \
+        } \
+    } while (false)
+
+// Keeps the arguments referenced, so compiling a level out does not cause
+// unused variable warnings, without ever evaluating them.
+#define RPP_LOG_DISCARD(level, ...) \
+    do { \
+        if (false) \
+            rpp::log_at(level, __VA_ARGS__); \
+    } while (false)
+
+// The arguments are the event name and then {key, value} fields:
+// r_info_kv("motor", {"rpm", 1200}, {"current", 3.2}).
+#define RPP_LOG_KV_AT(level, ...) \
+    do { \
+        static rpp::LogSite rpp_log_site_(level, RPP_LOG_CATEGORY); \
+        static rpp::LogLimiter rpp_log_limiter_(level, __FILE__, __LINE__); \
+        if (rpp_log_site_.enabled() && rpp_log_limiter_.allow()) { \
+            rpp::RecordOnlyScope rpp_record_only_(rpp_log_site_.recorded_only()); \
+            rpp::SinksOnlyScope rpp_sinks_only_(rpp_log_site_.sinks_only()); \
+            rpp::LogLimiter::Scope rpp_limiter_scope_(rpp_log_limiter_); \
+            rpp::Logger::Instance()->log_kv(level, {__VA_ARGS__}); \
+        } \
+    } while (false)
+
+#define RPP_LOG_KV_DISCARD(level, ...) \
+    do { \
+        if (false) \
+            rpp::Logger::Instance()->log_kv(level, {__VA_ARGS__}); \
+    } while (false)
+
+#if RPP_LOG_MIN_LEVEL <= 4
+#define r_err(...) RPP_LOG_AT(rpp::log_level::ERROR, __VA_ARGS__)
+#define r_err_kv(...) RPP_LOG_KV_AT(rpp::log_level::ERROR, __VA_ARGS__)
+#else
+#define r_err(...) RPP_LOG_DISCARD(rpp::log_level::ERROR, __VA_ARGS__)
+#define r_err_kv(...) RPP_LOG_KV_DISCARD(rpp::log_level::ERROR, __VA_ARGS__)
+#endif
+
+#if RPP_LOG_MIN_LEVEL <= 3
+#define r_warn(...) RPP_LOG_AT(rpp::log_level::WARNING, __VA_ARGS__)
+#define r_warn_kv(...) RPP_LOG_KV_AT(rpp::log_level::WARNING, __VA_ARGS__)
+#else
+#define r_warn(...) RPP_LOG_DISCARD(rpp::log_level::WARNING, __VA_ARGS__)
+#define r_warn_kv(...) RPP_LOG_KV_DISCARD(rpp::log_level::WARNING, __VA_ARGS__)
+#endif
+
+#if RPP_LOG_MIN_LEVEL <= 2
+#define r_info(...) RPP_LOG_AT(rpp::log_level::INFO, __VA_ARGS__)
+#define r_info_kv(...) RPP_LOG_KV_AT(rpp::log_level::INFO, __VA_ARGS__)
+#else
+#define r_info(...) RPP_LOG_DISCARD(rpp::log_level::INFO, __VA_ARGS__)
+#define r_info_kv(...) RPP_LOG_KV_DISCARD(rpp::log_level::INFO, __VA_ARGS__)
+#endif
+
+#if RPP_LOG_MIN_LEVEL <= 1
+#define r_debug(...) RPP_LOG_AT(rpp::log_level::DEBUG, __VA_ARGS__)
+#define r_debug_kv(...) RPP_LOG_KV_AT(rpp::log_level::DEBUG, __VA_ARGS__)
+#else
+#define r_debug(...) RPP_LOG_DISCARD(rpp::log_level::DEBUG, __VA_ARGS__)
+#define r_debug_kv(...) RPP_LOG_KV_DISCARD(rpp::log_level::DEBUG, __VA_ARGS__)
+#endif
+
 #endif
@@ -0,0 +1,198 @@
+#ifndef ROMI_ROVER_BUILD_AND_TEST_MPMCQUEUE_H
+#define ROMI_ROVER_BUILD_AND_TEST_MPMCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "IThreadsafeQueue.h"
+
+// A bounded lock-free queue for any number of producers and consumers.
+// Every slot carries a sequence number that says whose turn it is: a
+// producer claims the slot at the tail with a compare-and-swap once the
+// slot is free for that lap, writes the item and publishes it by bumping
+// the sequence; a consumer does the same at the head. Nothing is allocated
+// after construction. The capacity is rounded up to a power of two.
+//
+// push() waits, yielding, while the queue is full; try_push() does not.
+template<typename T>
+class MPMCQueue : public EmplacingThreadsafeQueue<MPMCQueue<T>, T> {
+public:
+    static constexpr size_t cache_line_size = 64;
+
+    explicit MPMCQueue(size_t capacity)
+            : mask_(round_up(capacity) - 1), slots_(new Slot[mask_ + 1]), tail_(0), head_(0) {
+        for (size_t i = 0; i <= mask_; i++)
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    MPMCQueue(const MPMCQueue<T> &) = delete;
+    MPMCQueue& operator=(const MPMCQueue<T> &) = delete;
+
+    ~MPMCQueue() override {
+        while (try_pop_into(nullptr)) {
+        }
+    }
+
+    size_t capacity() const {
+        return mask_ + 1;
+    }
+
+    // Approximate while other threads push or pop.
+    [[nodiscard]] unsigned long size() const override {
+        size_t head = head_.value.load(std::memory_order_acquire);
+        size_t tail = tail_.value.load(std::memory_order_acquire);
+        return (tail > head) ? tail - head : 0;
+    }
+
+    std::optional<T> pop() override {
+        std::optional<T> item;
+        try_pop_into(&item);
+        return item;
+    }
+
+    template<typename... Args>
+    void emplace(Args&&... args) {
+        while (!try_emplace(std::forward<Args>(args)...))
+            std::this_thread::yield();
+    }
+
+    bool try_push(const T &item) {
+        return try_emplace(item);
+    }
+
+    bool try_push(T &&item) {
+        return try_emplace(std::move(item));
+    }
+
+    template<typename... Args>
+    bool try_emplace(Args&&... args) {
+        size_t position;
+        if (claim(tail_, 0, 1, position) == 0)
+            return false;
+        Slot& slot = slots_[position & mask_];
+        new (slot.storage) T(std::forward<Args>(args)...);
+        slot.sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Pushes a range of forward iterators, claiming as many free slots as
+    // there are with one compare-and-swap. Yields while the queue is full.
+    template<typename ForwardIt>
+    void push_bulk(ForwardIt first, ForwardIt last) {
+        while (first != last) {
+            size_t position;
+            size_t count = claim(tail_, 0, static_cast<size_t>(std::distance(first, last)), position);
+            if (count == 0)
+                std::this_thread::yield();
+            for (size_t i = 0; i < count; i++, ++first) {
+                Slot& slot = slots_[(position + i) & mask_];
+                new (slot.storage) T(*first);
+                slot.sequence.store(position + i + 1, std::memory_order_release);
+            }
+        }
+    }
+
+    // Moves up to max_items from the head to out, claiming them with one
+    // compare-and-swap. Returns the number moved.
+    template<typename OutputIt>
+    size_t try_drain(OutputIt out, size_t max_items) {
+        size_t position;
+        size_t count = claim(head_, 1, max_items, position);
+        for (size_t i = 0; i < count; i++) {
+            Slot& slot = slots_[(position + i) & mask_];
+            T* value = std::launder(reinterpret_cast<T*>(slot.storage));
+            *out++ = std::move(*value);
+            value->~T();
+            slot.sequence.store(position + i + mask_ + 1, std::memory_order_release);
+        }
+        return count;
+    }
+
+    // Appends the items to out, up to one capacity's worth so that busy
+    // producers cannot keep it going. Returns the number moved.
+    size_t drain_all(std::vector<T>& out) {
+        size_t total = 0;
+        size_t count;
+        while (total < capacity() && (count = try_drain(std::back_inserter(out), capacity() - total)) > 0)
+            total += count;
+        return total;
+    }
+
+private:
+    struct Slot {
+        std::atomic<size_t> sequence{0};
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    // Keeps the producers' and the consumers' index on lines of their own.
+    struct alignas(cache_line_size) PaddedIndex {
+        explicit PaddedIndex(size_t start) : value(start) {}
+        std::atomic<size_t> value;
+    };
+
+    static size_t round_up(size_t capacity) {
+        size_t rounded = 2;
+        while (rounded < capacity)
+            rounded *= 2;
+        return rounded;
+    }
+
+    // Claims up to wanted consecutive slots from index on. A slot is ready
+    // for the claim when its sequence is its position plus ready: 0 for a
+    // free slot (producers), 1 for a published item (consumers). The
+    // sequences are checked before the compare-and-swap, and only the
+    // owner of a position changes its slot's sequence, so a successful
+    // swap owns every slot counted. Returns the number claimed; 0 when the
+    // queue is full (or empty).
+    size_t claim(PaddedIndex& index, size_t ready, size_t wanted, size_t& position) {
+        position = index.value.load(std::memory_order_relaxed);
+        if (wanted == 0)
+            return 0;
+        while (true) {
+            size_t count = 0;
+            std::ptrdiff_t lap = 0;
+            while (count < wanted) {
+                size_t sequence = slots_[(position + count) & mask_].sequence.load(std::memory_order_acquire);
+                lap = static_cast<std::ptrdiff_t>(sequence - (position + count + ready));
+                if (lap != 0)
+                    break;
+                count++;
+            }
+            if (count > 0) {
+                if (index.value.compare_exchange_weak(position, position + count, std::memory_order_relaxed))
+                    return count;
+            } else if (lap < 0) {
+                return 0;
+            } else {
+                position = index.value.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Moves the head item into item, or destroys it if item is null.
+    bool try_pop_into(std::optional<T>* item) {
+        size_t position;
+        if (claim(head_, 1, 1, position) == 0)
+            return false;
+        Slot& slot = slots_[position & mask_];
+        T* value = std::launder(reinterpret_cast<T*>(slot.storage));
+        if (item != nullptr)
+            item->emplace(std::move(*value));
+        value->~T();
+        slot.sequence.store(position + mask_ + 1, std::memory_order_release);
+        return true;
+    }
+
+    const size_t mask_;
+    std::unique_ptr<Slot[]> slots_;
+    PaddedIndex tail_;
+    PaddedIndex head_;
+};
+
+
+#endif //ROMI_ROVER_BUILD_AND_TEST_MPMCQUEUE_H
@@ -0,0 +1,162 @@
+#ifndef ROMI_ROVER_BUILD_AND_TEST_RINGSTORAGE_H
+#define ROMI_ROVER_BUILD_AND_TEST_RINGSTORAGE_H
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+// A growable ring of element slots, for use as the container of a
+// std::queue (and so of ThreadsafeQueue). Popping destroys the element but
+// keeps its slot for the next push, so once the ring has grown to the
+// largest backlog it is asked to hold, pushing and popping do not touch
+// the allocator. When full it doubles, moving the elements across; it
+// never shrinks. The capacity is rounded up to a power of two.
+template<typename T>
+class RingStorage {
+public:
+    using value_type = T;
+    using size_type = size_t;
+    using reference = T&;
+    using const_reference = const T&;
+
+    RingStorage() = default;
+
+    explicit RingStorage(size_t capacity) {
+        reserve(capacity);
+    }
+
+    RingStorage(const RingStorage<T> &) = delete;
+    RingStorage& operator=(const RingStorage<T> &) = delete;
+
+    RingStorage(RingStorage<T>&& other) noexcept
+            : slots_(std::move(other.slots_)), mask_(other.mask_), head_(other.head_), size_(other.size_) {
+        other.mask_ = 0;
+        other.head_ = 0;
+        other.size_ = 0;
+    }
+
+    RingStorage& operator=(RingStorage<T>&& other) noexcept {
+        if (this != &other) {
+            clear();
+            slots_ = std::move(other.slots_);
+            mask_ = other.mask_;
+            head_ = other.head_;
+            size_ = other.size_;
+            other.mask_ = 0;
+            other.head_ = 0;
+            other.size_ = 0;
+        }
+        return *this;
+    }
+
+    ~RingStorage() {
+        clear();
+    }
+
+    [[nodiscard]] bool empty() const {
+        return size_ == 0;
+    }
+
+    size_t size() const {
+        return size_;
+    }
+
+    size_t capacity() const {
+        return slots_ ? mask_ + 1 : 0;
+    }
+
+    T& front() {
+        return *at(head_);
+    }
+
+    const T& front() const {
+        return *at(head_);
+    }
+
+    T& back() {
+        return *at(head_ + size_ - 1);
+    }
+
+    const T& back() const {
+        return *at(head_ + size_ - 1);
+    }
+
+    void push_back(const T& item) {
+        emplace_back(item);
+    }
+
+    void push_back(T&& item) {
+        emplace_back(std::move(item));
+    }
+
+    template<typename... Args>
+    T& emplace_back(Args&&... args) {
+        if (size_ == capacity())
+            reserve(size_ + 1);
+        T* item = new (slot(head_ + size_)) T(std::forward<Args>(args)...);
+        size_++;
+        return *item;
+    }
+
+    void pop_front() {
+        at(head_)->~T();
+        head_ = (head_ + 1) & mask_;
+        size_--;
+    }
+
+    void clear() {
+        while (size_ > 0)
+            pop_front();
+        head_ = 0;
+    }
+
+    // Makes room for at least capacity elements without allocating again.
+    void reserve(size_t capacity) {
+        if (capacity <= this->capacity())
+            return;
+        size_t rounded = 1;
+        while (rounded < capacity)
+            rounded <<= 1;
+        std::unique_ptr<Slot[]> slots(new Slot[rounded]);
+        for (size_t i = 0; i < size_; i++) {
+            new (slots[i].storage) T(std::move(*at(head_ + i)));
+            at(head_ + i)->~T();
+        }
+        slots_ = std::move(slots);
+        mask_ = rounded - 1;
+        head_ = 0;
+    }
+
+    void swap(RingStorage<T>& other) noexcept {
+        std::swap(slots_, other.slots_);
+        std::swap(mask_, other.mask_);
+        std::swap(head_, other.head_);
+        std::swap(size_, other.size_);
+    }
+
+private:
+    struct Slot {
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    void* slot(size_t position) const {
+        return slots_[position & mask_].storage;
+    }
+
+    T* at(size_t position) const {
+        return std::launder(reinterpret_cast<T*>(slot(position)));
+    }
+
+    std::unique_ptr<Slot[]> slots_{};
+    size_t mask_{0};
+    size_t head_{0};
+    size_t size_{0};
+};
+
+template<typename T>
+void swap(RingStorage<T>& a, RingStorage<T>& b) noexcept {
+    a.swap(b);
+}
+
+#endif //ROMI_ROVER_BUILD_AND_TEST_RINGSTORAGE_H
@@ -0,0 +1,79 @@
+#ifndef ROMI_ROVER_BUILD_AND_TEST_ROTATINGLOGWRITER_H
+#define ROMI_ROVER_BUILD_AND_TEST_ROTATINGLOGWRITER_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "ILogWriter.h"
+
+namespace rpp
+{
+    // Decorator that rotates a log file by size or age. The writer that does
+    // the I/O is created with create_writer() for every file. A background
+    // thread opens the next writer ahead of time at "<name>.next", so that
+    // rotating only swaps the writers. The background thread then renames
+    // the current file to "<name>.<n>" and "<name>.next" to the current
+    // name, closes the old writer, archives it and removes old files.
+    class RotatingLogWriter : public ILogWriter
+    {
+    public:
+        RotatingLogWriter(std::function<std::shared_ptr<ILogWriter>()> create_writer,
+                          log_rotation_policy policy);
+        ~RotatingLogWriter() override;
+        RotatingLogWriter(const RotatingLogWriter&) = delete;
+        RotatingLogWriter& operator=(const RotatingLogWriter&) = delete;
+
+        void open(std::string_view name) override;
+        void close() override;
+        void write(const std::string& message) override;
+        void write_line(std::string_view line) override;
+        void write_batch(const std::vector<std::string_view>& chunks) override;
+        void sync() override;
+
+        // Waits for the next writer only if the background thread has not
+        // opened it yet.
+        void rotate();
+        // Blocks until every rotated file has been renamed, closed, archived
+        // and pruned.
+        void flush();
+
+        // The rotated files of path, ordered oldest first.
+        static std::vector<std::pair<uint64_t, std::filesystem::path>>
+        rotated_files(const std::filesystem::path& path);
+
+    private:
+        void written(uint64_t bytes);
+        void run();
+        // Closes, archives and prunes a rotated file.
+        void retire(std::shared_ptr<ILogWriter> writer, const std::filesystem::path& path);
+        void prepare_next();
+
+        const std::function<std::shared_ptr<ILogWriter>()> create_writer_;
+        const log_rotation_policy policy_;
+        std::filesystem::path path_;
+        std::filesystem::path next_path_;
+        std::shared_ptr<ILogWriter> writer_;
+        uint64_t bytes_;
+        double next_rotation_;
+        uint64_t next_index_;
+
+        std::mutex retired_mutex_;
+        std::condition_variable retired_ready_;
+        std::condition_variable retired_done_;
+        std::deque<std::pair<std::shared_ptr<ILogWriter>, std::filesystem::path>> retired_;
+        // The writer open at next_path_, once the background thread has
+        // opened it. preparing_ is set until then.
+        std::shared_ptr<ILogWriter> next_;
+        bool preparing_;
+        bool busy_;
+        bool quit_;
+        std::thread thread_;
+    };
+}
+
+#endif
@@ -0,0 +1,180 @@
+#ifndef ROMI_ROVER_BUILD_AND_TEST_SPSCQUEUE_H
+#define ROMI_ROVER_BUILD_AND_TEST_SPSCQUEUE_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "IThreadsafeQueue.h"
+
+// A bounded queue for exactly one producer thread and one consumer thread.
+// try_push() and pop() are wait-free: an acquire load of the other side's
+// index and a release store of their own. Each side keeps a copy of the
+// other side's index and only reloads it when the queue looks full (or
+// empty), so the two cache lines are not passed back and forth on every
+// item.
+//
+// The capacity is a power of two: Capacity when it is given, else the
+// constructor's argument rounded up. push() waits, yielding, while the
+// queue is full.
+template<typename T, size_t Capacity = 0>
+class SPSCQueue : public EmplacingThreadsafeQueue<SPSCQueue<T, Capacity>, T> {
+public:
+    static_assert(Capacity == 0 || (Capacity & (Capacity - 1)) == 0, "the capacity must be a power of two");
+    static constexpr size_t cache_line_size = 64;
+
+    explicit SPSCQueue(size_t capacity = Capacity)
+            : mask_((Capacity != 0 ? Capacity : round_up(capacity)) - 1), slots_(new Slot[mask_ + 1]),
+              producer_(), consumer_() {
+    }
+
+    SPSCQueue(const SPSCQueue &) = delete;
+    SPSCQueue& operator=(const SPSCQueue &) = delete;
+
+    ~SPSCQueue() override {
+        while (try_pop_into(nullptr)) {
+        }
+    }
+
+    size_t capacity() const {
+        return mask() + 1;
+    }
+
+    // Approximate while the other thread pushes or pops.
+    [[nodiscard]] unsigned long size() const override {
+        size_t head = consumer_.index.load(std::memory_order_acquire);
+        size_t tail = producer_.index.load(std::memory_order_acquire);
+        return (tail > head) ? tail - head : 0;
+    }
+
+    // Consumer thread only.
+    std::optional<T> pop() override {
+        std::optional<T> item;
+        try_pop_into(&item);
+        return item;
+    }
+
+    // Producer thread only, as are push() and push_bulk().
+    template<typename... Args>
+    void emplace(Args&&... args) {
+        while (!try_emplace(std::forward<Args>(args)...))
+            std::this_thread::yield();
+    }
+
+    bool try_push(const T &item) {
+        return try_emplace(item);
+    }
+
+    bool try_push(T &&item) {
+        return try_emplace(std::move(item));
+    }
+
+    template<typename... Args>
+    bool try_emplace(Args&&... args) {
+        size_t tail = producer_.index.load(std::memory_order_relaxed);
+        if (tail - producer_.other == capacity()) {
+            producer_.other = consumer_.index.load(std::memory_order_acquire);
+            if (tail - producer_.other == capacity())
+                return false;
+        }
+        new (slots_[tail & mask()].storage) T(std::forward<Args>(args)...);
+        producer_.index.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Producer thread only. Fills the free slots and publishes them with
+    // one store. Yields while the queue is full.
+    template<typename InputIt>
+    void push_bulk(InputIt first, InputIt last) {
+        while (first != last) {
+            size_t tail = producer_.index.load(std::memory_order_relaxed);
+            if (tail - producer_.other == capacity())
+                producer_.other = consumer_.index.load(std::memory_order_acquire);
+            size_t free = capacity() - (tail - producer_.other);
+            if (free == 0) {
+                std::this_thread::yield();
+                continue;
+            }
+            size_t count = 0;
+            for (; count < free && first != last; count++, ++first)
+                new (slots_[(tail + count) & mask()].storage) T(*first);
+            producer_.index.store(tail + count, std::memory_order_release);
+        }
+    }
+
+    // Consumer thread only. Moves up to max_items to out and frees their
+    // slots with one store. Returns the number moved.
+    template<typename OutputIt>
+    size_t try_drain(OutputIt out, size_t max_items) {
+        size_t head = consumer_.index.load(std::memory_order_relaxed);
+        if (consumer_.other - head < max_items)
+            consumer_.other = producer_.index.load(std::memory_order_acquire);
+        size_t count = std::min(max_items, consumer_.other - head);
+        for (size_t i = 0; i < count; i++) {
+            T* value = std::launder(reinterpret_cast<T*>(slots_[(head + i) & mask()].storage));
+            *out++ = std::move(*value);
+            value->~T();
+        }
+        if (count > 0)
+            consumer_.index.store(head + count, std::memory_order_release);
+        return count;
+    }
+
+    // Consumer thread only. Appends the items to out, up to one capacity's
+    // worth. Returns the number moved.
+    size_t drain_all(std::vector<T>& out) {
+        return try_drain(std::back_inserter(out), capacity());
+    }
+
+private:
+    struct Slot {
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    // One side's index and its copy of the other side's, on a line of its own.
+    struct alignas(cache_line_size) Side {
+        std::atomic<size_t> index{0};
+        size_t other = 0;
+    };
+
+    static size_t round_up(size_t capacity) {
+        size_t rounded = 2;
+        while (rounded < capacity)
+            rounded *= 2;
+        return rounded;
+    }
+
+    // A constant when the capacity is known at compile time.
+    size_t mask() const {
+        return Capacity != 0 ? Capacity - 1 : mask_;
+    }
+
+    // Moves the head item into item, or destroys it if item is null.
+    bool try_pop_into(std::optional<T>* item) {
+        size_t head = consumer_.index.load(std::memory_order_relaxed);
+        if (head == consumer_.other) {
+            consumer_.other = producer_.index.load(std::memory_order_acquire);
+            if (head == consumer_.other)
+                return false;
+        }
+        T* value = std::launder(reinterpret_cast<T*>(slots_[head & mask()].storage));
+        if (item != nullptr)
+            item->emplace(std::move(*value));
+        value->~T();
+        consumer_.index.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    const size_t mask_;
+    std::unique_ptr<Slot[]> slots_;
+    Side producer_;
+    Side consumer_;
+};
+
+
+#endif //ROMI_ROVER_BUILD_AND_TEST_SPSCQUEUE_H
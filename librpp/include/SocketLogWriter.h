@@ -0,0 +1,103 @@
+#ifndef ROMI_ROVER_BUILD_AND_TEST_SOCKETLOGWRITER_H
+#define ROMI_ROVER_BUILD_AND_TEST_SOCKETLOGWRITER_H
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "ILinux.h"
+#include "ILogWriter.h"
+
+namespace rpp
+{
+    // Sends log lines to a local collector (see LogCollector) over a
+    // SOCK_SEQPACKET Unix socket. Lines are packed into packets of at most
+    // packet_size bytes (up to max_packet_size), never splitting a line
+    // between packets. A line longer than max_packet_size is dropped and
+    // counted. The writer never blocks: when the collector is slow or
+    // missing, packets are dropped and their lines counted. The count is
+    // reported to the collector once a packet gets through again. While
+    // disconnected, it tries to reconnect at most once per
+    // reconnect_interval.
+    class SocketLogWriter : public ILogWriter
+    {
+    public:
+        static constexpr size_t default_packet_size = 32 * 1024;
+        // The largest packet a LogCollector receives whole.
+        static constexpr size_t max_packet_size = 64 * 1024;
+        static constexpr std::chrono::milliseconds reconnect_interval{1000};
+
+        explicit SocketLogWriter(const std::shared_ptr<ILinux>& linux, size_t packet_size = default_packet_size);
+        ~SocketLogWriter() override;
+        SocketLogWriter(const SocketLogWriter&) = delete;
+        SocketLogWriter& operator=(const SocketLogWriter&) = delete;
+
+        // The name is the path of the collector's socket.
+        void open(std::string_view name) override;
+        void close() override;
+        void write(const std::string& message) override;
+        void write_line(std::string_view line) override;
+        void write_batch(const std::vector<std::string_view>& chunks) override;
+
+        bool connected() const;
+        // The number of lines dropped so far.
+        uint64_t dropped() const;
+
+    private:
+        void append(std::string_view lines);
+        void send_packet();
+        bool send(std::string_view packet);
+        bool connect();
+        void disconnect();
+
+        const std::shared_ptr<ILinux> linux_;
+        const size_t packet_size_;
+        std::string path_;
+        int fd_;
+        std::string packet_;
+        std::atomic<uint64_t> dropped_;
+        uint64_t reported_dropped_;
+        std::chrono::steady_clock::time_point next_connect_;
+    };
+
+    // The receiving end of SocketLogWriter: accepts any number of writers on
+    // a Unix socket and writes their packets, whole, to one ILogWriter, so a
+    // single process does the disk I/O for all of them. A packet larger than
+    // max_packet_size is dropped, counted and reported in the output.
+    class LogCollector
+    {
+    public:
+        static constexpr size_t max_packet_size = SocketLogWriter::max_packet_size;
+
+        LogCollector(const std::shared_ptr<ILinux>& linux, const std::shared_ptr<ILogWriter>& writer);
+        ~LogCollector();
+        LogCollector(const LogCollector&) = delete;
+        LogCollector& operator=(const LogCollector&) = delete;
+
+        // Replaces a stale socket file. Throws std::runtime_error.
+        void listen(const std::string& socket_path);
+        void close();
+        // Waits up to timeout_ms for connections and packets and writes the
+        // packets received. Returns the number of packets written.
+        size_t poll(int timeout_ms);
+        size_t clients() const { return clients_.size(); }
+        // The number of packets dropped because they were too large.
+        uint64_t dropped() const { return dropped_; }
+
+    private:
+        void accept();
+        size_t receive(int fd, bool& closed);
+
+        const std::shared_ptr<ILinux> linux_;
+        const std::shared_ptr<ILogWriter> writer_;
+        std::string path_;
+        int listen_fd_;
+        std::vector<int> clients_;
+        std::vector<char> buffer_;
+        uint64_t dropped_;
+    };
+}
+
+#endif
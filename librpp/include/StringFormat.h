@@ -0,0 +1,486 @@
+#ifndef __RRPP_STRING_FORMAT_H
+#define __RRPP_STRING_FORMAT_H
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// A printf compatible formatter for variadic templates. A format wrapped in
+// RPP_FMT() is parsed and checked against the argument types at compile
+// time; the output is written in one pass, numbers with std::to_chars.
+//
+//     std::string s = StringUtils::string_format(RPP_FMT("%s=%5.2f"), name, value);
+//     r_info(RPP_FMT("speed %d"), speed);
+//
+// Supported: flags "-+ 0#", a numeric width and precision, the length
+// modifiers hh h l ll j z t L, and the conversions d i u o x X c s p f F e E
+// g G a A and %%. A '*' width or precision is not supported. long double
+// arguments are formatted as double.
+
+namespace StringUtils
+{
+    namespace format
+    {
+        // The largest width or precision accepted.
+        constexpr int max_width = 1000;
+        // Room for the text of any number, without width padding: the
+        // largest precision, the 309 integer digits of DBL_MAX in %f, and the
+        // sign, prefix, point and exponent.
+        constexpr size_t max_number_size = max_width + 320;
+
+        struct spec
+        {
+            size_t literal_begin = 0;
+            size_t literal_end = 0;
+            // 0 for the text after the last conversion, '%' for "%%".
+            char conversion = 0;
+            // 'H' for hh, 'q' for ll, otherwise the modifier itself.
+            char length = 0;
+            bool left = false;
+            bool plus = false;
+            bool space = false;
+            bool zero = false;
+            bool alternate = false;
+            bool valid = true;
+            int width = -1;
+            int precision = -1;
+            size_t arg = 0;
+            size_t end = 0;
+        };
+
+        enum class error
+        {
+            none = 0,
+            bad_specifier,
+            too_few_arguments,
+            too_many_arguments,
+            type_mismatch
+        };
+
+        enum class kind
+        {
+            integer = 1,
+            floating,
+            string,
+            pointer,
+            other
+        };
+
+        constexpr bool is_digit(char c) {
+            return c >= '0' && c <= '9';
+        }
+
+        constexpr bool is_conversion(char c) {
+            return std::string_view("diouxXcspfFeEgGaA%").find(c) != std::string_view::npos;
+        }
+
+        constexpr int parse_number(std::string_view format, size_t& pos) {
+            int value = 0;
+            while (pos < format.size() && is_digit(format[pos])) {
+                if (value <= max_width)
+                    value = value * 10 + (format[pos] - '0');
+                pos++;
+            }
+            return value;
+        }
+
+        // Parses the literal text at pos and the conversion that follows it.
+        constexpr spec parse_next(std::string_view format, size_t pos) {
+            spec result{};
+            result.literal_begin = pos;
+            while (pos < format.size() && format[pos] != '%')
+                pos++;
+            result.literal_end = pos;
+            if (pos == format.size()) {
+                result.end = pos;
+                return result;
+            }
+            pos++;
+
+            bool flags = true;
+            while (flags && pos < format.size()) {
+                char c = format[pos];
+                if (c == '-')
+                    result.left = true;
+                else if (c == '+')
+                    result.plus = true;
+                else if (c == ' ')
+                    result.space = true;
+                else if (c == '0')
+                    result.zero = true;
+                else if (c == '#')
+                    result.alternate = true;
+                else
+                    flags = false;
+                if (flags)
+                    pos++;
+            }
+            if (pos < format.size() && is_digit(format[pos]))
+                result.width = parse_number(format, pos);
+            if (pos < format.size() && format[pos] == '.') {
+                pos++;
+                result.precision = parse_number(format, pos);
+            }
+            if (pos < format.size() && (format[pos] == 'h' || format[pos] == 'l')) {
+                result.length = format[pos++];
+                if (pos < format.size() && format[pos] == result.length) {
+                    result.length = (result.length == 'h') ? 'H' : 'q';
+                    pos++;
+                }
+            } else if (pos < format.size() && std::string_view("jztLq").find(format[pos]) != std::string_view::npos) {
+                result.length = format[pos++];
+            }
+
+            if (pos == format.size() || !is_conversion(format[pos])
+                || result.width > max_width || result.precision > max_width) {
+                result.valid = false;
+                result.conversion = '%';
+                result.end = format.size();
+                return result;
+            }
+            result.conversion = format[pos];
+            result.end = pos + 1;
+            return result;
+        }
+
+        // The number of conversions, "%%" included.
+        constexpr size_t count_specs(std::string_view format) {
+            size_t count = 0;
+            size_t pos = 0;
+            while (true) {
+                spec next = parse_next(format, pos);
+                if (next.conversion == 0 || !next.valid)
+                    return count;
+                count++;
+                pos = next.end;
+            }
+        }
+
+        // The conversions followed by the trailing text, with the index of
+        // the argument of each conversion.
+        template <size_t N>
+        constexpr std::array<spec, N + 1> parse(std::string_view format) {
+            std::array<spec, N + 1> specs{};
+            size_t pos = 0;
+            size_t arg = 0;
+            for (size_t i = 0; i <= N; i++) {
+                specs[i] = parse_next(format, pos);
+                if (specs[i].conversion != 0 && specs[i].conversion != '%')
+                    specs[i].arg = arg++;
+                pos = specs[i].end;
+            }
+            return specs;
+        }
+
+        template <typename T>
+        constexpr kind kind_of() {
+            using U = std::remove_cv_t<std::remove_reference_t<T>>;
+            if constexpr (std::is_array_v<U>) {
+                return std::is_same_v<std::remove_cv_t<std::remove_extent_t<U>>, char> ? kind::string : kind::other;
+            } else if constexpr (std::is_same_v<U, const char*> || std::is_same_v<U, char*>
+                                 || std::is_same_v<U, std::string> || std::is_same_v<U, std::string_view>) {
+                return kind::string;
+            } else if constexpr (std::is_integral_v<U>) {
+                return kind::integer;
+            } else if constexpr (std::is_floating_point_v<U>) {
+                return kind::floating;
+            } else if constexpr ((std::is_pointer_v<U> && !std::is_function_v<std::remove_pointer_t<U>>)
+                                 || std::is_null_pointer_v<U>) {
+                return kind::pointer;
+            } else {
+                return kind::other;
+            }
+        }
+
+        constexpr bool accepts(char conversion, kind argument) {
+            if (std::string_view("diouxXc").find(conversion) != std::string_view::npos)
+                return argument == kind::integer;
+            if (std::string_view("fFeEgGaA").find(conversion) != std::string_view::npos)
+                return argument == kind::floating;
+            if (conversion == 's')
+                return argument == kind::string;
+            if (conversion == 'p')
+                return argument == kind::pointer || argument == kind::string;
+            return false;
+        }
+
+        template <size_t N>
+        constexpr error check(std::string_view format, const std::array<kind, N>& kinds) {
+            size_t pos = 0;
+            size_t arg = 0;
+            while (true) {
+                spec next = parse_next(format, pos);
+                if (!next.valid)
+                    return error::bad_specifier;
+                if (next.conversion == 0)
+                    break;
+                if (next.conversion != '%') {
+                    if (arg == N)
+                        return error::too_few_arguments;
+                    if (!accepts(next.conversion, kinds[arg]))
+                        return error::type_mismatch;
+                    arg++;
+                }
+                pos = next.end;
+            }
+            return (arg < N) ? error::too_many_arguments : error::none;
+        }
+
+        // Write the text of a number into buffer (max_number_size) and return
+        // its length. prefix is set to the length of the sign and "0x" part,
+        // after which zero padding goes.
+        size_t format_integer(char* buffer, const spec& s, uint64_t magnitude, bool negative, size_t& prefix);
+        size_t format_float(char* buffer, const spec& s, double value, size_t& prefix);
+
+        template <typename Out>
+        void append_padded(Out& out, const spec& s, const char* text, size_t size, size_t prefix, bool zero_pad) {
+            size_t width = (s.width > 0) ? static_cast<size_t>(s.width) : 0;
+            size_t padding = (width > size) ? width - size : 0;
+            if (padding == 0) {
+                out.append(text, size);
+            } else if (s.left) {
+                out.append(text, size);
+                out.append(padding, ' ');
+            } else if (zero_pad) {
+                out.append(text, prefix);
+                out.append(padding, '0');
+                out.append(text + prefix, size - prefix);
+            } else {
+                out.append(padding, ' ');
+                out.append(text, size);
+            }
+        }
+
+        template <typename T>
+        std::string_view as_string(const T& value) {
+            using U = std::remove_cv_t<T>;
+            if constexpr (std::is_same_v<U, std::string> || std::is_same_v<U, std::string_view>) {
+                return std::string_view(value);
+            } else {
+                const char* s = value;
+                return (s == nullptr) ? std::string_view("(null)") : std::string_view(s);
+            }
+        }
+
+        template <typename Out, typename T>
+        void write_integer(Out& out, const spec& s, T value) {
+            if (s.conversion == 'c') {
+                char c = static_cast<char>(value);
+                append_padded(out, s, &c, 1, 0, false);
+                return;
+            }
+
+            bool is_signed = (s.conversion == 'd' || s.conversion == 'i');
+            uint64_t magnitude = 0;
+            bool negative = false;
+            if (is_signed && std::is_signed_v<T>) {
+                auto v = static_cast<int64_t>(value);
+                if (s.length == 'H')
+                    v = static_cast<signed char>(v);
+                else if (s.length == 'h')
+                    v = static_cast<short>(v);
+                negative = (v < 0);
+                magnitude = negative ? (0 - static_cast<uint64_t>(v)) : static_cast<uint64_t>(v);
+            } else {
+                magnitude = static_cast<uint64_t>(static_cast<std::make_unsigned_t<T>>(value));
+                if (s.length == 'H')
+                    magnitude = static_cast<unsigned char>(magnitude);
+                else if (s.length == 'h')
+                    magnitude = static_cast<unsigned short>(magnitude);
+            }
+
+            char buffer[max_number_size];
+            size_t prefix = 0;
+            size_t size = format_integer(buffer, s, magnitude, negative, prefix);
+            append_padded(out, s, buffer, size, prefix, s.zero && !s.left && s.precision < 0);
+        }
+
+        template <typename Out, typename T>
+        void write_arg(Out& out, const spec& s, const T& value) {
+            constexpr kind argument = kind_of<T>();
+            if constexpr (argument == kind::integer) {
+                if constexpr (std::is_same_v<T, bool>)
+                    write_integer(out, s, static_cast<int>(value));
+                else
+                    write_integer(out, s, value);
+            } else if constexpr (argument == kind::floating) {
+                char buffer[max_number_size];
+                size_t prefix = 0;
+                auto v = static_cast<double>(value);
+                size_t size = format_float(buffer, s, v, prefix);
+                append_padded(out, s, buffer, size, prefix, s.zero && !s.left && std::isfinite(v));
+            } else if constexpr (argument == kind::string) {
+                if (s.conversion == 'p') {
+                    write_arg(out, s, static_cast<const void*>(as_string(value).data()));
+                    return;
+                }
+                std::string_view text = as_string(value);
+                if (s.precision >= 0)
+                    text = text.substr(0, static_cast<size_t>(s.precision));
+                append_padded(out, s, text.data(), text.size(), 0, false);
+            } else if constexpr (argument == kind::pointer) {
+                const void* p = value;
+                if (p == nullptr) {
+                    append_padded(out, s, "(nil)", 5, 0, false);
+                } else {
+                    spec hex = s;
+                    hex.conversion = 'x';
+                    hex.alternate = true;
+                    hex.precision = -1;
+                    char buffer[max_number_size];
+                    size_t prefix = 0;
+                    size_t size = format_integer(buffer, hex, reinterpret_cast<uintptr_t>(p), false, prefix);
+                    append_padded(out, s, buffer, size, prefix, false);
+                }
+            }
+        }
+
+        template <typename Out>
+        void append_literal(Out& out, std::string_view format, const spec& s) {
+            if (s.literal_end > s.literal_begin)
+                out.append(format.data() + s.literal_begin, s.literal_end - s.literal_begin);
+        }
+
+        // A format string known at compile time, see RPP_FMT().
+        struct format_string
+        {
+        };
+
+        template <typename T>
+        constexpr bool is_format_string_v = std::is_base_of_v<format_string, T>;
+
+        template <typename Format>
+        constexpr size_t spec_count = count_specs(Format::value());
+
+        template <typename Format>
+        constexpr std::array<spec, spec_count<Format> + 1> specs = parse<spec_count<Format>>(Format::value());
+
+        template <typename Format, size_t I, typename Out, typename Tuple>
+        void write_spec(Out& out, const Tuple& args) {
+            constexpr spec s = specs<Format>[I];
+            append_literal(out, Format::value(), s);
+            if constexpr (s.conversion == '%')
+                out.append(1, '%');
+            else if constexpr (s.conversion != 0)
+                write_arg(out, s, std::get<s.arg>(args));
+        }
+
+        template <typename Format, typename Out, typename Tuple, size_t ...I>
+        void write_specs(Out& out, const Tuple& args, std::index_sequence<I...>) {
+            (write_spec<Format, I>(out, args), ...);
+        }
+
+        template <typename F, typename ...Args>
+        void visit_arg(size_t index, F&& f, const Args& ...args) {
+            size_t i = 0;
+            ((i++ == index ? f(args) : void()), ...);
+        }
+    }
+
+    // Appends the formatted text to out. Out is a std::string or anything
+    // with the same append(const char*, size_t) and append(size_t, char).
+    template <typename Format, typename Out, typename ...Args,
+              typename = std::enable_if_t<format::is_format_string_v<Format>>>
+    void format_to(Out& out, Format, const Args& ...args) {
+        constexpr std::array<format::kind, sizeof...(Args)> kinds{format::kind_of<Args>()...};
+        constexpr format::error result = format::check(Format::value(), kinds);
+        static_assert(result != format::error::bad_specifier, "format: unsupported conversion specifier");
+        static_assert(result != format::error::too_few_arguments, "format: too few arguments");
+        static_assert(result != format::error::too_many_arguments, "format: too many arguments");
+        static_assert(result != format::error::type_mismatch, "format: argument type does not match its conversion");
+        format::write_specs<Format>(out, std::forward_as_tuple(args...),
+                                    std::make_index_sequence<format::spec_count<Format> + 1>());
+    }
+
+    // The same for a format only known at run time. Returns false, having
+    // appended nothing, if the format does not match the arguments.
+    template <typename Out, typename ...Args>
+    bool format_to(Out& out, std::string_view format_text, const Args& ...args) {
+        constexpr std::array<format::kind, sizeof...(Args)> kinds{format::kind_of<Args>()...};
+        if (format::check(format_text, kinds) != format::error::none)
+            return false;
+        size_t pos = 0;
+        size_t arg = 0;
+        while (true) {
+            format::spec s = format::parse_next(format_text, pos);
+            format::append_literal(out, format_text, s);
+            if (s.conversion == 0)
+                return true;
+            if (s.conversion == '%')
+                out.append(1, '%');
+            else
+                format::visit_arg(arg++, [&out, &s](const auto& value) { format::write_arg(out, s, value); }, args...);
+            pos = s.end;
+        }
+    }
+
+    // Output with N characters of inline storage that moves to the heap
+    // only when a longer text is written. clear() keeps the heap capacity.
+    template <size_t N>
+    class FormatBuffer
+    {
+    public:
+        FormatBuffer() : inline_(), size_(0), heap_() {
+        }
+
+        void append(const char* text, size_t size) {
+            if (heap_.empty() && size_ + size <= N) {
+                memcpy(inline_ + size_, text, size);
+                size_ += size;
+            } else {
+                spill();
+                heap_.append(text, size);
+            }
+        }
+
+        void append(size_t count, char c) {
+            if (heap_.empty() && size_ + count <= N) {
+                memset(inline_ + size_, c, count);
+                size_ += count;
+            } else {
+                spill();
+                heap_.append(count, c);
+            }
+        }
+
+        // Replaces size characters at pos, which must already be written.
+        void overwrite(size_t pos, const char* text, size_t size) {
+            memcpy(heap_.empty() ? inline_ + pos : &heap_[pos], text, size);
+        }
+
+        void clear() {
+            size_ = 0;
+            heap_.clear();
+        }
+
+        std::string_view view() const {
+            return heap_.empty() ? std::string_view(inline_, size_) : std::string_view(heap_);
+        }
+
+    private:
+        void spill() {
+            if (heap_.empty() && size_ > 0)
+                heap_.assign(inline_, size_);
+        }
+
+        char inline_[N];
+        size_t size_;
+        std::string heap_;
+    };
+}
+
+#define RPP_FMT(text) \
+    [] { \
+        struct rpp_format_string_ : StringUtils::format::format_string { \
+            static constexpr std::string_view value() { return text; } \
+        }; \
+        return rpp_format_string_{}; \
+    }()
+
+#endif
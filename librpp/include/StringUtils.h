@@ -2,6 +2,7 @@
 #include <string>
 #include <vector>
 #include <cstdarg>
+#include "StringFormat.h"
 
 #ifndef __RRPP_STRING_UTILS_H
 #define __RRPP_STRING_UTILS_H
@@ -20,6 +21,9 @@ namespace StringUtils
     char *rprintf(char *buffer, size_t len, const char *format, ...);
 
 
+    // A format only known at run time goes to snprintf, which converts the
+    // arguments as printf always has. Wrap literals in RPP_FMT() to use the
+    // checked engine instead (see StringFormat.h).
     template <typename ...Args>
     std::string string_format(const std::string& format, Args && ...args)
     {
@@ -31,6 +35,16 @@ namespace StringUtils
         return std::string(output.data());
 #pragma GCC diagnostic pop
     }
+
+    // Checked at compile time: string_format(RPP_FMT("x=%d"), x).
+    template <typename Format, typename ...Args,
+              typename = std::enable_if_t<format::is_format_string_v<Format>>>
+    std::string string_format(Format format, const Args& ...args)
+    {
+        std::string formatted;
+        format_to(formatted, format, args...);
+        return formatted;
+    }
 }
 
 #endif
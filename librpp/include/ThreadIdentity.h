@@ -0,0 +1,53 @@
+#ifndef ROMI_ROVER_BUILD_AND_TEST_THREADIDENTITY_H
+#define ROMI_ROVER_BUILD_AND_TEST_THREADIDENTITY_H
+
+#include <atomic>
+#include <cstdint>
+#include <string_view>
+#include <sys/types.h>
+
+namespace rpp
+{
+    // Who the calling thread is: a small sequential id (1 for the first
+    // thread that asks), the kernel thread id and an optional name. The
+    // field written into log lines, "id:tid" or "name:id:tid", is
+    // formatted once per thread and again only when the name changes.
+    class ThreadIdentity
+    {
+    public:
+        static constexpr size_t max_name_size = 31;
+        static constexpr size_t max_field_size = max_name_size + 24;
+
+        static ThreadIdentity& current();
+
+        uint32_t id() const { return id_; }
+        pid_t tid() const { return tid_; }
+        std::string_view name() const { return std::string_view(name_, name_size_); }
+        std::string_view field() const { return std::string_view(field_, field_size_); }
+
+        // Longer names are cut. The first 15 characters also become the
+        // name the kernel reports, for top and gdb.
+        void set_name(std::string_view name);
+
+        ThreadIdentity(const ThreadIdentity&) = delete;
+        ThreadIdentity& operator=(const ThreadIdentity&) = delete;
+
+    private:
+        ThreadIdentity();
+        void format_field();
+
+        const uint32_t id_;
+        const pid_t tid_;
+        char name_[max_name_size];
+        size_t name_size_;
+        char field_[max_field_size];
+        size_t field_size_;
+
+        static std::atomic<uint32_t> next_id_;
+    };
+
+    // Names the calling thread in the log.
+    void set_thread_name(std::string_view name);
+}
+
+#endif
@@ -2,26 +2,87 @@
 #define ROMI_ROVER_BUILD_AND_TEST_THREADSAFEQUEUE_H
 
 
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+#include <sys/eventfd.h>
+#include <unistd.h>
 #include "Logger.h"
 #include "IThreadsafeQueue.h"
+#include "RingStorage.h"
 
 
-template<typename T>
-class ThreadsafeQueue : IThreadsafeQueue< T >{
-    std::queue<T> queue_;
+// Storage is the container under the std::queue. The default std::deque
+// allocates and frees blocks as the queue fills and empties; RingStorage
+// (see PooledThreadsafeQueue) reuses its slots instead.
+template<typename T, typename Storage = std::deque<T>>
+class ThreadsafeQueue : public EmplacingThreadsafeQueue<ThreadsafeQueue<T, Storage>, T>{
+    std::queue<T, Storage> queue_;
     mutable std::mutex mutex_{};
+    std::condition_variable not_empty_{};
+    // An eventfd that is readable while the queue holds items, or -1.
+    int ready_fd_{-1};
+
+    std::optional<T> pop_locked() {
+        std::optional<T> item(std::move(queue_.front()));
+        queue_.pop();
+        if (queue_.empty()) {
+            clear_ready_locked();
+        }
+        return item;
+    }
+
+    // EAGAIN means the descriptor is already in the state asked for: the
+    // counter is full when writing, or zero when reading.
+    void set_ready_locked() {
+        if (ready_fd_ >= 0) {
+            uint64_t one = 1;
+            ssize_t result;
+            do {
+                result = write(ready_fd_, &one, sizeof(one));
+            } while (result < 0 && errno == EINTR);
+            if (result < 0 && errno != EAGAIN) {
+                std::cerr << "ThreadsafeQueue failed to set the readiness fd: " << strerror(errno) << std::endl;
+            }
+        }
+    }
+
+    void clear_ready_locked() {
+        if (ready_fd_ >= 0) {
+            uint64_t count;
+            ssize_t result;
+            do {
+                result = read(ready_fd_, &count, sizeof(count));
+            } while (result < 0 && errno == EINTR);
+            if (result < 0 && errno != EAGAIN) {
+                std::cerr << "ThreadsafeQueue failed to clear the readiness fd: " << strerror(errno) << std::endl;
+            }
+        }
+    }
 
 public:
     ThreadsafeQueue();
-    ThreadsafeQueue(const ThreadsafeQueue<T> &) = delete ;
-    ThreadsafeQueue& operator=(const ThreadsafeQueue<T> &) = delete ;
+    // Starts from the given, empty, storage, for example a RingStorage
+    // that has already reserved its slots.
+    explicit ThreadsafeQueue(Storage storage) : queue_(std::move(storage)) {
+    }
+    ThreadsafeQueue(const ThreadsafeQueue &) = delete ;
+    ThreadsafeQueue& operator=(const ThreadsafeQueue &) = delete ;
 
-    ThreadsafeQueue(ThreadsafeQueue<T>&& other) noexcept(false){
-        std::lock_guard<std::mutex> lock(mutex_);
+    ThreadsafeQueue(ThreadsafeQueue&& other) noexcept(false) : queue_() {
+        std::scoped_lock lock(mutex_, other.mutex_);
         if (!queue_.empty()) {
             throw std::runtime_error("Move ctr queue already has entries.");
         }
         queue_ = std::move(other.queue_);
+        ready_fd_ = other.ready_fd_;
+        other.ready_fd_ = -1;
     }
 
     virtual ~ThreadsafeQueue() {
@@ -29,6 +90,8 @@ public:
         if (!queue_.empty()) {
             r_err("destroying ThreadsafeQueue with %d elements.", queue_.size());
         }
+        if (ready_fd_ >= 0)
+            close(ready_fd_);
     }
 
     [[nodiscard]] unsigned long size() const {
@@ -41,21 +104,118 @@ public:
         if (queue_.empty()) {
             return {};
         }
-        T tmp = queue_.front();
-        queue_.pop();
-        return tmp;
+        return pop_locked();
+    }
+
+    // Waits up to timeout for an item; an empty optional means it timed out.
+    template<typename Rep, typename Period>
+    std::optional<T> pop_wait(const std::chrono::duration<Rep, Period>& timeout) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (!not_empty_.wait_for(lock, timeout, [this] { return !queue_.empty(); })) {
+            return {};
+        }
+        return pop_locked();
+    }
+
+    // Constructs the item in place at the back of the queue.
+    template<typename... Args>
+    void emplace(Args&&... args) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            queue_.emplace(std::forward<Args>(args)...);
+            if (queue_.size() == 1) {
+                set_ready_locked();
+            }
+        }
+        not_empty_.notify_one();
+    }
+
+    // Pushes a range under one lock.
+    template<typename InputIt>
+    void push_bulk(InputIt first, InputIt last) {
+        size_t pushed = 0;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            bool was_empty = queue_.empty();
+            for (; first != last; ++first, ++pushed) {
+                queue_.push(*first);
+            }
+            if (was_empty && pushed > 0) {
+                set_ready_locked();
+            }
+        }
+        if (pushed == 1) {
+            not_empty_.notify_one();
+        } else if (pushed > 1) {
+            not_empty_.notify_all();
+        }
     }
 
-    void push(const T &item) {
+    // Moves up to max_items from the front to out under one lock. Returns
+    // the number moved.
+    template<typename OutputIt>
+    size_t try_drain(OutputIt out, size_t max_items) {
         std::lock_guard<std::mutex> lock(mutex_);
-        queue_.push(item);
+        size_t count = std::min(max_items, queue_.size());
+        for (size_t i = 0; i < count; i++) {
+            *out++ = std::move(queue_.front());
+            queue_.pop();
+        }
+        if (count > 0 && queue_.empty()) {
+            clear_ready_locked();
+        }
+        return count;
+    }
+
+    // Appends every item to out. The queue is swapped for an empty one under
+    // the lock and the items are moved out after it is released. The
+    // emptied storage is then handed back if the queue is still empty, so
+    // that a pooled queue keeps its slots.
+    size_t drain_all(std::vector<T>& out) {
+        std::queue<T, Storage> drained;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (queue_.empty()) {
+                return 0;
+            }
+            drained.swap(queue_);
+            clear_ready_locked();
+        }
+        size_t count = drained.size();
+        out.reserve(out.size() + count);
+        for (; !drained.empty(); drained.pop()) {
+            out.push_back(std::move(drained.front()));
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (queue_.empty()) {
+            queue_.swap(drained);
+        }
+        return count;
+    }
+
+    // A descriptor that polls readable while the queue holds items, so a
+    // consumer can wait on the queue together with sockets and serial ports
+    // (ILinux::poll) and then pop(). It is only written when the queue goes
+    // from empty to not empty and read when it goes back. Created on the
+    // first call and closed with the queue; -1 if eventfd() fails.
+    int readiness_fd() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (ready_fd_ < 0) {
+            ready_fd_ = eventfd(queue_.empty() ? 0 : 1, EFD_NONBLOCK | EFD_CLOEXEC);
+        }
+        return ready_fd_;
     }
 };
 
-template<typename T>
-ThreadsafeQueue<T>::ThreadsafeQueue() : queue_(){
+template<typename T, typename Storage>
+ThreadsafeQueue<T, Storage>::ThreadsafeQueue() : queue_(){
 
 }
 
+// A ThreadsafeQueue that reuses element slots: after it has grown to its
+// largest backlog, push, emplace and pop make no allocator calls.
+template<typename T>
+using PooledThreadsafeQueue = ThreadsafeQueue<T, RingStorage<T>>;
+
 
 #endif //ROMI_ROVER_BUILD_AND_TEST_THREADSAFEQUEUE_H
@@ -0,0 +1,407 @@
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include "AsyncFileWriter.h"
+
+namespace rpp {
+
+    // Where the buffers go once they are handed over.
+    class AsyncFileWriter::Engine
+    {
+    public:
+        virtual ~Engine() = default;
+        virtual void queue(int fd, size_t buffer, const char* data, size_t size, uint64_t offset) = 0;
+        virtual void submit() = 0;
+        // Appends the completions available; with wait, blocks for at least one.
+        virtual void reap(bool wait, std::vector<completion>& out) = 0;
+    };
+
+    namespace {
+
+        // io_uring driven with raw system calls, so there is no liburing
+        // dependency. A write is one SQE; submit() is one io_uring_enter()
+        // for all queued SQEs. Completions are read from the shared CQ ring
+        // without a system call unless the caller has to wait.
+        class UringEngine : public AsyncFileWriter::Engine
+        {
+        public:
+            UringEngine(const std::vector<iovec>& buffers)
+                    : ring_fd_(-1), sq_ring_(nullptr), sq_ring_size_(0), cq_ring_(nullptr), cq_ring_size_(0),
+                      sqes_(nullptr), sqes_size_(0), sq_head_(nullptr), sq_tail_(nullptr), sq_mask_(0),
+                      sq_array_(nullptr), cq_head_(nullptr), cq_tail_(nullptr), cq_mask_(0), cqes_(nullptr),
+                      registered_(false), buffers_(buffers), to_submit_(0) {
+                unsigned entries = 8;
+                while (entries < buffers.size())
+                    entries *= 2;
+
+                io_uring_params params{};
+                ring_fd_ = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+                if (ring_fd_ < 0)
+                    throw std::runtime_error("io_uring_setup failed: " + std::string(strerror(errno)));
+                try {
+                    map_rings(params);
+                } catch (...) {
+                    unmap_rings();
+                    throw;
+                }
+                // Registered buffers count against RLIMIT_MEMLOCK on older
+                // kernels; plain writes are the fallback.
+                registered_ = syscall(__NR_io_uring_register, ring_fd_, IORING_REGISTER_BUFFERS,
+                                      buffers_.data(), static_cast<unsigned>(buffers_.size())) == 0;
+            }
+
+            ~UringEngine() override {
+                unmap_rings();
+            }
+
+            UringEngine(const UringEngine&) = delete;
+            UringEngine& operator=(const UringEngine&) = delete;
+
+            void queue(int fd, size_t buffer, const char* data, size_t size, uint64_t offset) override {
+                unsigned tail = *sq_tail_;
+                if (tail - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) > sq_mask_)
+                    submit();
+                unsigned index = tail & sq_mask_;
+                io_uring_sqe* sqe = &sqes_[index];
+                memset(sqe, 0, sizeof(*sqe));
+                sqe->opcode = registered_ ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+                sqe->fd = fd;
+                sqe->addr = reinterpret_cast<uint64_t>(data);
+                sqe->len = static_cast<uint32_t>(size);
+                sqe->off = offset;
+                sqe->buf_index = static_cast<uint16_t>(buffer);
+                sqe->user_data = buffer;
+                sq_array_[index] = index;
+                __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+                to_submit_++;
+            }
+
+            void submit() override {
+                while (to_submit_ > 0) {
+                    long submitted = syscall(__NR_io_uring_enter, ring_fd_, to_submit_, 0, 0, nullptr, 0);
+                    if (submitted < 0) {
+                        if (errno == EINTR || errno == EAGAIN || errno == EBUSY)
+                            continue;
+                        throw std::runtime_error("io_uring_enter failed: " + std::string(strerror(errno)));
+                    }
+                    to_submit_ -= static_cast<unsigned>(submitted);
+                }
+            }
+
+            void reap(bool wait, std::vector<AsyncFileWriter::completion>& out) override {
+                size_t before = out.size();
+                harvest(out);
+                while (wait && out.size() == before) {
+                    long result = syscall(__NR_io_uring_enter, ring_fd_, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+                    if (result < 0 && errno != EINTR)
+                        throw std::runtime_error("io_uring_enter failed: " + std::string(strerror(errno)));
+                    harvest(out);
+                }
+            }
+
+        private:
+            void harvest(std::vector<AsyncFileWriter::completion>& out) {
+                unsigned head = *cq_head_;
+                unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+                for (; head != tail; head++) {
+                    const io_uring_cqe& cqe = cqes_[head & cq_mask_];
+                    out.push_back(AsyncFileWriter::completion{static_cast<size_t>(cqe.user_data), cqe.res});
+                }
+                __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+            }
+
+            void* map(size_t size, off_t offset) {
+                void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, offset);
+                if (p == MAP_FAILED)
+                    throw std::runtime_error("io_uring mmap failed: " + std::string(strerror(errno)));
+                return p;
+            }
+
+            void map_rings(const io_uring_params& params) {
+                sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+                cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+                bool single = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+                if (single)
+                    sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+
+                sq_ring_ = static_cast<char*>(map(sq_ring_size_, IORING_OFF_SQ_RING));
+                cq_ring_ = single ? sq_ring_ : static_cast<char*>(map(cq_ring_size_, IORING_OFF_CQ_RING));
+                sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+                sqes_ = static_cast<io_uring_sqe*>(map(sqes_size_, IORING_OFF_SQES));
+
+                sq_head_ = reinterpret_cast<unsigned*>(sq_ring_ + params.sq_off.head);
+                sq_tail_ = reinterpret_cast<unsigned*>(sq_ring_ + params.sq_off.tail);
+                sq_mask_ = *reinterpret_cast<unsigned*>(sq_ring_ + params.sq_off.ring_mask);
+                sq_array_ = reinterpret_cast<unsigned*>(sq_ring_ + params.sq_off.array);
+                cq_head_ = reinterpret_cast<unsigned*>(cq_ring_ + params.cq_off.head);
+                cq_tail_ = reinterpret_cast<unsigned*>(cq_ring_ + params.cq_off.tail);
+                cq_mask_ = *reinterpret_cast<unsigned*>(cq_ring_ + params.cq_off.ring_mask);
+                cqes_ = reinterpret_cast<io_uring_cqe*>(cq_ring_ + params.cq_off.cqes);
+            }
+
+            void unmap_rings() {
+                if (sqes_ != nullptr)
+                    munmap(sqes_, sqes_size_);
+                if (cq_ring_ != nullptr && cq_ring_ != sq_ring_)
+                    munmap(cq_ring_, cq_ring_size_);
+                if (sq_ring_ != nullptr)
+                    munmap(sq_ring_, sq_ring_size_);
+                if (ring_fd_ >= 0)
+                    ::close(ring_fd_);
+            }
+
+            int ring_fd_;
+            char* sq_ring_;
+            size_t sq_ring_size_;
+            char* cq_ring_;
+            size_t cq_ring_size_;
+            io_uring_sqe* sqes_;
+            size_t sqes_size_;
+            unsigned* sq_head_;
+            unsigned* sq_tail_;
+            unsigned sq_mask_;
+            unsigned* sq_array_;
+            unsigned* cq_head_;
+            unsigned* cq_tail_;
+            unsigned cq_mask_;
+            io_uring_cqe* cqes_;
+            bool registered_;
+            std::vector<iovec> buffers_;
+            unsigned to_submit_;
+        };
+
+        // The portable fallback: a thread that pwrite()s the buffers.
+        class ThreadEngine : public AsyncFileWriter::Engine
+        {
+        public:
+            ThreadEngine() : queued_(), mutex_(), requests_changed_(), completions_changed_(), requests_(),
+                             completions_(), quit_(false), thread_() {
+                thread_ = std::thread(&ThreadEngine::run, this);
+            }
+
+            ~ThreadEngine() override {
+                {
+                    std::scoped_lock lock(mutex_);
+                    quit_ = true;
+                }
+                requests_changed_.notify_one();
+                thread_.join();
+            }
+
+            ThreadEngine(const ThreadEngine&) = delete;
+            ThreadEngine& operator=(const ThreadEngine&) = delete;
+
+            void queue(int fd, size_t buffer, const char* data, size_t size, uint64_t offset) override {
+                queued_.push_back(request{fd, buffer, data, size, offset});
+            }
+
+            void submit() override {
+                if (queued_.empty())
+                    return;
+                {
+                    std::scoped_lock lock(mutex_);
+                    requests_.insert(requests_.end(), queued_.begin(), queued_.end());
+                }
+                queued_.clear();
+                requests_changed_.notify_one();
+            }
+
+            void reap(bool wait, std::vector<AsyncFileWriter::completion>& out) override {
+                std::unique_lock lock(mutex_);
+                if (wait)
+                    completions_changed_.wait(lock, [this] { return !completions_.empty(); });
+                out.insert(out.end(), completions_.begin(), completions_.end());
+                completions_.clear();
+            }
+
+        private:
+            struct request
+            {
+                int fd;
+                size_t buffer;
+                const char* data;
+                size_t size;
+                uint64_t offset;
+            };
+
+            void run() {
+                std::vector<request> batch;
+                while (true) {
+                    {
+                        std::unique_lock lock(mutex_);
+                        requests_changed_.wait(lock, [this] { return quit_ || !requests_.empty(); });
+                        if (requests_.empty())
+                            return;
+                        batch.swap(requests_);
+                    }
+                    for (const auto& r : batch) {
+                        ssize_t n = pwrite(r.fd, r.data, r.size, static_cast<off_t>(r.offset));
+                        int64_t result = (n < 0) ? -errno : n;
+                        {
+                            std::scoped_lock lock(mutex_);
+                            completions_.push_back(AsyncFileWriter::completion{r.buffer, result});
+                        }
+                        completions_changed_.notify_one();
+                    }
+                    batch.clear();
+                }
+            }
+
+            std::vector<request> queued_;
+            std::mutex mutex_;
+            std::condition_variable requests_changed_;
+            std::condition_variable completions_changed_;
+            std::vector<request> requests_;
+            std::vector<AsyncFileWriter::completion> completions_;
+            bool quit_;
+            std::thread thread_;
+        };
+    }
+
+    AsyncFileWriter::AsyncFileWriter(async_io_backend backend, size_t buffer_size, size_t buffer_count)
+            : backend_(backend), buffers_(std::max(buffer_count, static_cast<size_t>(1))), free_(),
+              completions_(), engine_(), fd_(-1), offset_(0), current_(no_buffer), in_flight_(0),
+              bytes_written_(0), errors_(0) {
+        std::vector<iovec> iovecs;
+        for (size_t i = 0; i < buffers_.size(); i++) {
+            buffers_[i].data.resize(std::max(buffer_size, static_cast<size_t>(1)));
+            iovecs.push_back(iovec{buffers_[i].data.data(), buffers_[i].data.size()});
+            free_.push_back(i);
+        }
+
+        if (backend_ != async_io_backend::THREAD) {
+            try {
+                engine_ = std::make_unique<UringEngine>(iovecs);
+                backend_ = async_io_backend::IO_URING;
+            } catch (const std::runtime_error&) {
+                if (backend_ == async_io_backend::IO_URING)
+                    throw;
+            }
+        }
+        if (engine_ == nullptr) {
+            engine_ = std::make_unique<ThreadEngine>();
+            backend_ = async_io_backend::THREAD;
+        }
+    }
+
+    AsyncFileWriter::~AsyncFileWriter() {
+        close();
+    }
+
+    void AsyncFileWriter::open(const std::string& path, bool append) {
+        close();
+        int flags = O_WRONLY | O_CREAT | O_CLOEXEC | (append ? 0 : O_TRUNC);
+        fd_ = ::open(path.c_str(), flags, 0644);
+        if (fd_ < 0)
+            throw std::runtime_error("AsyncFileWriter: failed to open " + path);
+        struct stat info{};
+        offset_ = (append && fstat(fd_, &info) == 0) ? static_cast<uint64_t>(info.st_size) : 0;
+    }
+
+    void AsyncFileWriter::close() {
+        if (fd_ < 0)
+            return;
+        flush();
+        ::close(fd_);
+        fd_ = -1;
+    }
+
+    void AsyncFileWriter::write(const char* data, size_t size) {
+        if (fd_ < 0)
+            return;
+        while (size > 0) {
+            if (current_ == no_buffer)
+                current_ = acquire_buffer();
+            Buffer& buffer = buffers_[current_];
+            size_t n = std::min(size, buffer.data.size() - buffer.used);
+            memcpy(buffer.data.data() + buffer.used, data, n);
+            buffer.used += n;
+            data += n;
+            size -= n;
+            if (buffer.used == buffer.data.size()) {
+                queue_current();
+                engine_->submit();
+            }
+        }
+    }
+
+    void AsyncFileWriter::submit() {
+        if (current_ != no_buffer && buffers_[current_].used > 0)
+            queue_current();
+        engine_->submit();
+    }
+
+    void AsyncFileWriter::flush() {
+        submit();
+        while (in_flight_ > 0)
+            reap(true);
+    }
+
+    size_t AsyncFileWriter::acquire_buffer() {
+        reap(false);
+        if (free_.empty())
+            engine_->submit();
+        while (free_.empty())
+            reap(true);
+        size_t index = free_.front();
+        free_.pop_front();
+        return index;
+    }
+
+    void AsyncFileWriter::queue_current() {
+        Buffer& buffer = buffers_[current_];
+        buffer.offset = offset_;
+        buffer.done = 0;
+        offset_ += buffer.used;
+        engine_->queue(fd_, current_, buffer.data.data(), buffer.used, buffer.offset);
+        in_flight_++;
+        current_ = no_buffer;
+    }
+
+    void AsyncFileWriter::reap(bool wait) {
+        completions_.clear();
+        engine_->reap(wait, completions_);
+        for (const auto& c : completions_)
+            complete(c);
+    }
+
+    void AsyncFileWriter::queue_rest(size_t index) {
+        Buffer& buffer = buffers_[index];
+        engine_->queue(fd_, index, buffer.data.data() + buffer.done, buffer.used - buffer.done,
+                       buffer.offset + buffer.done);
+        engine_->submit();
+    }
+
+    // A short write, or one interrupted before it wrote anything, is queued
+    // again for the rest of the buffer. Other errors drop the buffer.
+    void AsyncFileWriter::complete(const completion& c) {
+        Buffer& buffer = buffers_[c.buffer];
+        if (c.result > 0) {
+            buffer.done += static_cast<size_t>(c.result);
+            bytes_written_.fetch_add(static_cast<uint64_t>(c.result), std::memory_order_relaxed);
+            if (buffer.done < buffer.used) {
+                queue_rest(c.buffer);
+                return;
+            }
+        } else if (c.result == -EINTR || c.result == -EAGAIN) {
+            queue_rest(c.buffer);
+            return;
+        } else {
+            errors_.fetch_add(1, std::memory_order_relaxed);
+        }
+        buffer.used = 0;
+        in_flight_--;
+        free_.push_back(c.buffer);
+    }
+}
@@ -0,0 +1,144 @@
+#include <iostream>
+#include "AsyncLogWriter.h"
+#include "StringUtils.h"
+
+namespace rpp {
+
+    AsyncLogWriter::AsyncLogWriter(const std::shared_ptr<ILogWriter>& writer, size_t capacity,
+                                   log_overflow_policy policy)
+            : writer_(writer), capacity_(capacity > 0 ? capacity : 1), policy_(policy),
+              queue_mutex_(), not_empty_(), not_full_(), written_(), queue_(),
+              enqueued_(0), completed_(0), sync_requested_(false), quit_(false), writer_mutex_(), dropped_(0),
+              reported_dropped_(0), thread_() {
+        queue_.reserve(capacity_);
+        thread_ = std::thread(&AsyncLogWriter::run, this);
+    }
+
+    AsyncLogWriter::~AsyncLogWriter() {
+        stop();
+    }
+
+    void AsyncLogWriter::open(std::string_view name) {
+        flush();
+        std::scoped_lock lock(writer_mutex_);
+        writer_->open(name);
+    }
+
+    void AsyncLogWriter::close() {
+        flush();
+        std::scoped_lock lock(writer_mutex_);
+        writer_->close();
+    }
+
+    void AsyncLogWriter::write(const std::string &message) {
+        write_line(message);
+    }
+
+    // Once stop() has begun, the writer thread may already be gone, so a
+    // line is dropped and counted rather than queued where nothing reads it.
+    void AsyncLogWriter::write_line(std::string_view line) {
+        std::unique_lock lock(queue_mutex_);
+        if (queue_.size() >= capacity_) {
+            if (policy_ != log_overflow_policy::BLOCK) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            not_full_.wait(lock, [this] { return queue_.size() < capacity_ || quit_; });
+        }
+        if (quit_) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        queue_.emplace_back(line);
+        enqueued_++;
+        bool was_empty = (queue_.size() == 1);
+        lock.unlock();
+        if (was_empty)
+            not_empty_.notify_one();
+    }
+
+    void AsyncLogWriter::sync() {
+        {
+            std::scoped_lock lock(queue_mutex_);
+            sync_requested_ = true;
+        }
+        not_empty_.notify_one();
+    }
+
+    void AsyncLogWriter::flush() {
+        std::unique_lock lock(queue_mutex_);
+        uint64_t target = enqueued_;
+        written_.wait(lock, [this, target] { return completed_ >= target || quit_; });
+    }
+
+    uint64_t AsyncLogWriter::dropped() const {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+
+    const std::shared_ptr<ILogWriter>& AsyncLogWriter::writer() const {
+        return writer_;
+    }
+
+    void AsyncLogWriter::stop() {
+        {
+            std::scoped_lock lock(queue_mutex_);
+            if (quit_)
+                return;
+            quit_ = true;
+        }
+        not_empty_.notify_one();
+        not_full_.notify_all();
+        if (thread_.joinable())
+            thread_.join();
+        written_.notify_all();
+    }
+
+    void AsyncLogWriter::run() {
+        std::vector<std::string> batch;
+        std::string buffer;
+        batch.reserve(capacity_);
+
+        while (true) {
+            uint64_t batch_end;
+            bool sync;
+            {
+                std::unique_lock lock(queue_mutex_);
+                not_empty_.wait(lock, [this] { return quit_ || sync_requested_ || !queue_.empty(); });
+                if (queue_.empty() && !sync_requested_)
+                    break;
+                batch.swap(queue_);
+                batch_end = enqueued_;
+                sync = sync_requested_;
+                sync_requested_ = false;
+            }
+            not_full_.notify_all();
+
+            buffer.clear();
+            uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+            if (policy_ == log_overflow_policy::COUNT_AND_DROP && dropped != reported_dropped_) {
+                buffer += StringUtils::string_format("AsyncLogWriter dropped %llu log messages\n",
+                                                     static_cast<unsigned long long>(dropped - reported_dropped_));
+                reported_dropped_ = dropped;
+            }
+            for (const auto& message : batch)
+                buffer += message;
+            batch.clear();
+
+            try {
+                std::scoped_lock lock(writer_mutex_);
+                if (!buffer.empty())
+                    writer_->write(buffer);
+                if (sync)
+                    writer_->sync();
+            } catch (const std::exception& e) {
+                std::cerr << "AsyncLogWriter failed to write: " << e.what() << std::endl;
+            }
+
+            {
+                std::scoped_lock lock(queue_mutex_);
+                completed_ = batch_end;
+            }
+            written_.notify_all();
+        }
+    }
+}
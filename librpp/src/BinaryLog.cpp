@@ -0,0 +1,488 @@
+#include <algorithm>
+#include <ctime>
+#include <iomanip>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+#include "BinaryLog.h"
+#include "ThreadIdentity.h"
+#include "ClockAccessor.h"
+
+namespace rpp {
+
+    class BinaryLog::ThreadBuffer
+    {
+    public:
+        // Large enough to always hold a record of the maximum size.
+        static constexpr size_t capacity = 128 * 1024;
+
+        explicit ThreadBuffer(BinaryLog& log)
+                : log_(log), mutex_(), data_(capacity), used_(0),
+                  thread_(log.register_thread()) {
+            log_.register_buffer(this);
+        }
+
+        ~ThreadBuffer() {
+            log_.unregister_buffer(this);
+        }
+
+        ThreadBuffer(const ThreadBuffer&) = delete;
+        ThreadBuffer& operator=(const ThreadBuffer&) = delete;
+
+        // Called with mutex_ held.
+        void write_out() {
+            if (used_ > 0) {
+                log_.write_to_file(data_.data(), used_);
+                used_ = 0;
+            }
+        }
+
+        BinaryLog& log_;
+        std::mutex mutex_;
+        std::vector<char> data_;
+        size_t used_;
+        const uint64_t thread_;
+    };
+
+    namespace {
+        thread_local std::unique_ptr<BinaryLog::ThreadBuffer> thread_buffer_;
+
+        const char* level_name(log_level level) {
+            switch (level) {
+                case log_level::DEBUG: return "DD";
+                case log_level::INFO: return "II";
+                case log_level::WARNING: return "WW";
+                case log_level::ERROR: return "EE";
+                default: return "??";
+            }
+        }
+
+        template <typename T>
+        T read_value(const char* data, size_t size, size_t& pos) {
+            if (pos + sizeof(T) > size)
+                throw std::runtime_error("BinaryLogDecoder: truncated record");
+            T value;
+            memcpy(&value, data + pos, sizeof(T));
+            pos += sizeof(T);
+            return value;
+        }
+
+        std::string read_string(const char* data, size_t size, size_t& pos, size_t length) {
+            if (pos + length > size)
+                throw std::runtime_error("BinaryLogDecoder: truncated string");
+            std::string value(data + pos, length);
+            pos += length;
+            return value;
+        }
+
+        struct argument
+        {
+            char tag;
+            int64_t i;
+            uint64_t u;
+            double f;
+            std::string s;
+        };
+
+        bool read_argument(const char* data, size_t size, size_t& pos, argument& arg) {
+            if (pos >= size)
+                return false;
+            arg.tag = data[pos++];
+            switch (arg.tag) {
+                case 'i':
+                    arg.i = read_value<int64_t>(data, size, pos);
+                    arg.u = static_cast<uint64_t>(arg.i);
+                    arg.f = static_cast<double>(arg.i);
+                    break;
+                case 'u':
+                case 'p':
+                    arg.u = read_value<uint64_t>(data, size, pos);
+                    arg.i = static_cast<int64_t>(arg.u);
+                    arg.f = static_cast<double>(arg.u);
+                    break;
+                case 'f':
+                    arg.f = read_value<double>(data, size, pos);
+                    arg.i = static_cast<int64_t>(arg.f);
+                    arg.u = static_cast<uint64_t>(arg.i);
+                    break;
+                case 's':
+                    arg.s = read_string(data, size, pos, read_value<uint16_t>(data, size, pos));
+                    arg.i = 0;
+                    arg.u = 0;
+                    arg.f = 0.0;
+                    break;
+                default:
+                    throw std::runtime_error("BinaryLogDecoder: unknown argument type");
+            }
+            return true;
+        }
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wformat-nonliteral"
+        template <typename T>
+        void append_formatted(std::string& out, const std::string& spec, T value) {
+            char buffer[256];
+            int length = snprintf(buffer, sizeof(buffer), spec.c_str(), value);
+            if (length < 0)
+                return;
+            if (static_cast<size_t>(length) < sizeof(buffer)) {
+                out.append(buffer, static_cast<size_t>(length));
+            } else {
+                std::vector<char> large(static_cast<size_t>(length) + 1);
+                snprintf(large.data(), large.size(), spec.c_str(), value);
+                out.append(large.data(), static_cast<size_t>(length));
+            }
+        }
+#pragma GCC diagnostic pop
+
+        std::string datetime_compact_string(uint64_t timestamp) {
+            auto seconds = static_cast<time_t>(timestamp / 1000000000);
+            auto ms = (timestamp / 1000000) % 1000;
+            struct tm local{};
+            localtime_r(&seconds, &local);
+            std::stringstream ss;
+            ss << std::put_time(&local, "%Y%m%d-%H%M%S");
+            ss << '.' << std::setfill('0') << std::setw(3) << ms;
+            return ss.str();
+        }
+    }
+
+    BinaryLog& BinaryLog::Instance() {
+        static BinaryLog instance;
+        return instance;
+    }
+
+    BinaryLog::BinaryLog() : mutex_(), fd_(-1), application_name_("??"), formats_(), threads_(),
+                             buffers_mutex_(), buffers_(), flush_interval_(default_flush_interval),
+                             timer_mutex_(), timer_(), quit_(false), thread_() {
+    }
+
+    BinaryLog::~BinaryLog() {
+        stop_timer();
+    }
+
+    void BinaryLog::open(const std::string &path, std::chrono::milliseconds flush_interval) {
+        close();
+        open_file(path);
+        flush_interval_ = flush_interval;
+        quit_ = false;
+        thread_ = std::thread(&BinaryLog::run, this);
+    }
+
+    void BinaryLog::open_file(const std::string &path) {
+        std::scoped_lock lock(mutex_);
+        int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0)
+            throw std::runtime_error("BinaryLog: failed to open " + path);
+        fd_.store(fd, std::memory_order_relaxed);
+        write_to_file_locked(binary_log::magic, binary_log::magic_size);
+        write_application();
+        for (size_t i = 0; i < formats_.size(); i++)
+            write_format(static_cast<uint32_t>(i + 1));
+        for (size_t i = 0; i < threads_.size(); i++)
+            write_thread(i);
+    }
+
+    void BinaryLog::close() {
+        stop_timer();
+        flush();
+        std::scoped_lock lock(mutex_);
+        int fd = fd_.exchange(-1);
+        if (fd >= 0)
+            ::close(fd);
+    }
+
+    void BinaryLog::set_application_name(std::string_view application_name) {
+        std::scoped_lock lock(mutex_);
+        application_name_ = application_name;
+        write_application();
+    }
+
+    void BinaryLog::flush() {
+        std::scoped_lock lock(buffers_mutex_);
+        for (auto buffer : buffers_) {
+            std::scoped_lock buffer_lock(buffer->mutex_);
+            buffer->write_out();
+        }
+    }
+
+    uint32_t BinaryLog::register_format(log_level level, const char *format) {
+        std::scoped_lock lock(mutex_);
+        formats_.emplace_back(level, format);
+        auto id = static_cast<uint32_t>(formats_.size());
+        write_format(id);
+        return id;
+    }
+
+    char* BinaryLog::reserve(size_t size) {
+        if (!thread_buffer_)
+            thread_buffer_ = std::make_unique<ThreadBuffer>(*this);
+        ThreadBuffer& buffer = *thread_buffer_;
+        buffer.mutex_.lock();
+        if (buffer.used_ + size > ThreadBuffer::capacity)
+            buffer.write_out();
+        return buffer.data_.data() + buffer.used_;
+    }
+
+    char* BinaryLog::encode_header(char *p, uint32_t id, uint16_t payload) {
+        uint64_t timestamp = ClockAccessor::GetInstance()->timestamp();
+        *p++ = static_cast<char>(binary_log::message_record);
+        memcpy(p, &id, sizeof(id));
+        p += sizeof(id);
+        memcpy(p, &timestamp, sizeof(timestamp));
+        p += sizeof(timestamp);
+        memcpy(p, &thread_buffer_->thread_, sizeof(uint64_t));
+        p += sizeof(uint64_t);
+        memcpy(p, &payload, sizeof(payload));
+        return p + sizeof(payload);
+    }
+
+    void BinaryLog::commit(char *end) {
+        ThreadBuffer& buffer = *thread_buffer_;
+        buffer.used_ = static_cast<size_t>(end - buffer.data_.data());
+        buffer.mutex_.unlock();
+    }
+
+    void BinaryLog::write_to_file(const char *data, size_t size) {
+        std::scoped_lock lock(mutex_);
+        write_to_file_locked(data, size);
+    }
+
+    void BinaryLog::write_to_file_locked(const char *data, size_t size) {
+        int fd = fd_.load(std::memory_order_relaxed);
+        while (fd >= 0 && size > 0) {
+            ssize_t n = ::write(fd, data, size);
+            if (n <= 0)
+                break;
+            data += n;
+            size -= static_cast<size_t>(n);
+        }
+    }
+
+    void BinaryLog::write_format(uint32_t id) {
+        const auto& [level, format] = formats_[id - 1];
+        std::string record;
+        auto length = static_cast<uint32_t>(format.size());
+        record.push_back(static_cast<char>(binary_log::format_record));
+        record.append(reinterpret_cast<const char*>(&id), sizeof(id));
+        record.push_back(static_cast<char>(level));
+        record.append(reinterpret_cast<const char*>(&length), sizeof(length));
+        record.append(format);
+        write_to_file_locked(record.data(), record.size());
+    }
+
+    void BinaryLog::write_application() {
+        std::string record;
+        auto length = static_cast<uint32_t>(application_name_.size());
+        record.push_back(static_cast<char>(binary_log::application_record));
+        record.append(reinterpret_cast<const char*>(&length), sizeof(length));
+        record.append(application_name_);
+        write_to_file_locked(record.data(), record.size());
+    }
+
+    void BinaryLog::write_thread(size_t index) {
+        const auto& [thread, field] = threads_[index];
+        std::string record;
+        auto length = static_cast<uint32_t>(field.size());
+        record.push_back(static_cast<char>(binary_log::thread_record));
+        record.append(reinterpret_cast<const char*>(&thread), sizeof(thread));
+        record.append(reinterpret_cast<const char*>(&length), sizeof(length));
+        record.append(field);
+        write_to_file_locked(record.data(), record.size());
+    }
+
+    uint64_t BinaryLog::register_thread() {
+        const ThreadIdentity& identity = ThreadIdentity::current();
+        std::scoped_lock lock(mutex_);
+        threads_.emplace_back(identity.id(), identity.field());
+        write_thread(threads_.size() - 1);
+        return identity.id();
+    }
+
+    void BinaryLog::register_buffer(ThreadBuffer *buffer) {
+        std::scoped_lock lock(buffers_mutex_);
+        buffers_.push_back(buffer);
+    }
+
+    void BinaryLog::unregister_buffer(ThreadBuffer *buffer) {
+        std::scoped_lock lock(buffers_mutex_);
+        buffers_.erase(std::remove(buffers_.begin(), buffers_.end(), buffer), buffers_.end());
+        std::scoped_lock buffer_lock(buffer->mutex_);
+        buffer->write_out();
+    }
+
+    void BinaryLog::stop_timer() {
+        if (!thread_.joinable())
+            return;
+        {
+            std::scoped_lock lock(timer_mutex_);
+            quit_ = true;
+        }
+        timer_.notify_one();
+        thread_.join();
+    }
+
+    void BinaryLog::run() {
+        std::unique_lock lock(timer_mutex_);
+        while (!quit_) {
+            timer_.wait_for(lock, flush_interval_, [this] { return quit_; });
+            lock.unlock();
+            flush();
+            lock.lock();
+        }
+    }
+
+    BinaryLogDecoder::BinaryLogDecoder() : formats_(), threads_(), application_name_("??") {
+    }
+
+    void BinaryLogDecoder::decode(std::istream &input, std::ostream &output) {
+        std::string contents((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+        const char* data = contents.data();
+        size_t size = contents.size();
+
+        if (size < binary_log::magic_size || contents.compare(0, binary_log::magic_size, binary_log::magic) != 0)
+            throw std::runtime_error("BinaryLogDecoder: not a binary log");
+
+        size_t pos = binary_log::magic_size;
+        while (pos < size) {
+            auto type = read_value<uint8_t>(data, size, pos);
+            if (type == binary_log::format_record) {
+                auto id = read_value<uint32_t>(data, size, pos);
+                auto level = static_cast<log_level>(read_value<uint8_t>(data, size, pos));
+                auto length = read_value<uint32_t>(data, size, pos);
+                formats_[id] = std::make_pair(level, read_string(data, size, pos, length));
+            } else if (type == binary_log::thread_record) {
+                auto thread = read_value<uint64_t>(data, size, pos);
+                auto length = read_value<uint32_t>(data, size, pos);
+                threads_[thread] = read_string(data, size, pos, length);
+            } else if (type == binary_log::application_record) {
+                auto length = read_value<uint32_t>(data, size, pos);
+                application_name_ = read_string(data, size, pos, length);
+            } else if (type == binary_log::message_record) {
+                auto id = read_value<uint32_t>(data, size, pos);
+                auto timestamp = read_value<uint64_t>(data, size, pos);
+                auto thread = read_value<uint64_t>(data, size, pos);
+                auto length = read_value<uint16_t>(data, size, pos);
+                if (pos + length > size)
+                    throw std::runtime_error("BinaryLogDecoder: truncated message");
+                auto format = formats_.find(id);
+                if (format == formats_.end())
+                    throw std::runtime_error("BinaryLogDecoder: unknown format id");
+                auto field = threads_.find(thread);
+
+                output << datetime_compact_string(timestamp) << ", "
+                       << level_name(format->second.first) << ", " << application_name_
+                       << ", " << ((field != threads_.end()) ? field->second : std::to_string(thread)) << ", "
+                       << format_message(format->second.second, data + pos, length) << "\n";
+                pos += length;
+            } else {
+                throw std::runtime_error("BinaryLogDecoder: unknown record type");
+            }
+        }
+    }
+
+    std::string BinaryLogDecoder::format_message(const std::string &format, const char *args, size_t size) {
+        std::string out;
+        size_t pos = 0;
+        size_t i = 0;
+        argument arg{};
+
+        while (i < format.size()) {
+            if (format[i] != '%') {
+                out += format[i++];
+                continue;
+            }
+            if (i + 1 < format.size() && format[i + 1] == '%') {
+                out += '%';
+                i += 2;
+                continue;
+            }
+
+            size_t start = i++;
+            std::string spec("%");
+            while (i < format.size() && strchr("-+ #0", format[i]) != nullptr)
+                spec += format[i++];
+            for (int field = 0; field < 2; field++) {
+                if (field == 1) {
+                    if (i >= format.size() || format[i] != '.')
+                        break;
+                    spec += format[i++];
+                }
+                if (i < format.size() && format[i] == '*') {
+                    i++;
+                    if (read_argument(args, size, pos, arg))
+                        spec += std::to_string(arg.i);
+                }
+                while (i < format.size() && isdigit(static_cast<unsigned char>(format[i])))
+                    spec += format[i++];
+            }
+            while (i < format.size() && strchr("hlLqjzt", format[i]) != nullptr)
+                i++;
+            if (i >= format.size()) {
+                out += format.substr(start);
+                break;
+            }
+            char conversion = format[i++];
+
+            if (!read_argument(args, size, pos, arg)) {
+                out += format.substr(start, i - start);
+                continue;
+            }
+
+            switch (conversion) {
+                case 'd':
+                case 'i':
+                    append_formatted(out, spec + "lld", static_cast<long long>(arg.i));
+                    break;
+                case 'u':
+                case 'o':
+                case 'x':
+                case 'X':
+                    append_formatted(out, spec + "ll" + conversion, static_cast<unsigned long long>(arg.u));
+                    break;
+                case 'c':
+                    append_formatted(out, spec + "c", static_cast<int>(arg.i));
+                    break;
+                case 'f':
+                case 'F':
+                case 'e':
+                case 'E':
+                case 'g':
+                case 'G':
+                case 'a':
+                case 'A':
+                    append_formatted(out, spec + conversion, arg.f);
+                    break;
+                case 's':
+                    if (arg.tag != 's')
+                        arg.s = (arg.tag == 'f') ? std::to_string(arg.f) : std::to_string(arg.i);
+                    append_formatted(out, spec + "s", arg.s.c_str());
+                    break;
+                case 'p':
+                    append_formatted(out, spec + "p", reinterpret_cast<void*>(static_cast<uintptr_t>(arg.u)));
+                    break;
+                default:
+                    out += format.substr(start, i - start);
+                    break;
+            }
+        }
+        return out;
+    }
+}
+
+void log_set_binary_file(const std::string& path, std::chrono::milliseconds flush_interval)
+{
+    rpp::BinaryLog::Instance().open(path, flush_interval);
+}
+
+void log_close_binary_file()
+{
+    rpp::BinaryLog::Instance().close();
+}
+
+void log_flush_binary()
+{
+    rpp::BinaryLog::Instance().flush();
+}
@@ -22,7 +22,9 @@
 
  */
 
-#include <iomanip>
+#include <algorithm>
+#include <cstring>
+#include <ctime>
 #include <chrono>
 #include <thread>
 #include "Clock.h"
@@ -39,15 +41,47 @@ namespace rpp {
 
         std::string Clock::datetime_compact_string()
         {
-            using namespace std::chrono;
-            auto now = system_clock::now();
-            auto ms = duration_cast<milliseconds>(now.time_since_epoch()) % 1000;
-            auto now_time_t = system_clock::to_time_t(now);
-
-            std::stringstream ss;
-            ss << std::put_time(std::localtime(&now_time_t), "%Y%m%d-%H%M%S");
-            ss << '.' << std::setfill('0') << std::setw(3) << ms.count();
-            return ss.str();
+                char buffer[datetime_compact_size];
+                size_t length = datetime_compact(buffer, sizeof(buffer));
+                return std::string(buffer, length);
+        }
+
+        // localtime_r() takes the glibc timezone lock, so each thread keeps the
+        // "%Y%m%d-%H%M%S" text of the last second it formatted and only
+        // writes the milliseconds for calls within that second.
+        size_t Clock::datetime_compact(char* buffer, size_t size)
+        {
+                struct SecondCache {
+                        time_t second = -1;
+                        char prefix[16] = {};
+                };
+                thread_local SecondCache cache;
+
+                using namespace std::chrono;
+                auto ms_since_epoch = duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count();
+                auto second = static_cast<time_t>(ms_since_epoch / MILLISECONDS_IN_SECOND);
+                auto ms = static_cast<int>(ms_since_epoch % MILLISECONDS_IN_SECOND);
+
+                if (second != cache.second) {
+                        struct tm local{};
+                        localtime_r(&second, &local);
+                        strftime(cache.prefix, sizeof(cache.prefix), "%Y%m%d-%H%M%S", &local);
+                        cache.second = second;
+                }
+
+                char datetime[datetime_compact_size];
+                memcpy(datetime, cache.prefix, 15);
+                datetime[15] = '.';
+                datetime[16] = static_cast<char>('0' + ms / 100);
+                datetime[17] = static_cast<char>('0' + ms / 10 % 10);
+                datetime[18] = static_cast<char>('0' + ms % 10);
+
+                if (size == 0)
+                        return 0;
+                size_t length = std::min(datetime_compact_size - 1, size - 1);
+                memcpy(buffer, datetime, length);
+                buffer[length] = '\0';
+                return length;
         }
 
     uint64_t Clock::timestamp() {
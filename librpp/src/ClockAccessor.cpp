@@ -3,6 +3,7 @@
 namespace rpp{
     std::shared_ptr< IClock > ClockAccessor::g_clock;
     std::mutex ClockAccessor::clock_mutex;
+    std::atomic<IClock*> ClockAccessor::g_published(nullptr);
 
 
 }
\ No newline at end of file
@@ -27,6 +27,31 @@ void FileUtils::TryWriteVectorAsFile(const std::string& filename, const std::vec
         }
 }
 
+std::unique_ptr<rpp::AsyncFileWriter> FileUtils::TryOpenAsyncWriter(const std::string& filename, bool append)
+{
+        try {
+                auto writer = std::make_unique<rpp::AsyncFileWriter>();
+                writer->open(filename, append);
+                return writer;
+        }
+        catch (const std::runtime_error& ex) {
+                FILE_UTILS_EXCEPTION_LOG( "\"" << filename.c_str() << "\"" << " " << ex.what())
+                throw;
+        }
+}
+
+void FileUtils::TryWriteVectorAsFileAsync(const std::string& filename, const std::vector<uint8_t>& in)
+{
+        auto writer = TryOpenAsyncWriter(filename);
+        writer->write(reinterpret_cast<const char*>(in.data()), in.size());
+        writer->close();
+        if (writer->errors() > 0) {
+                std::runtime_error ex("write failed");
+                FILE_UTILS_EXCEPTION_LOG( "\"" << filename.c_str() << "\"" << " " << ex.what())
+                throw ex;
+        }
+}
+
 std::string FileUtils::TryReadFileAsString(const std::string& filename)
 {
         std::string out;
@@ -0,0 +1,110 @@
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <new>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "FlightRecorder.h"
+
+namespace rpp {
+
+    namespace {
+        constexpr size_t capacity_offset = FlightRecorder::magic_size;
+        constexpr size_t head_offset = capacity_offset + sizeof(uint64_t);
+
+        static_assert(std::atomic<uint64_t>::is_always_lock_free,
+                      "the recorder head must be usable in a shared mapping");
+    }
+
+    FlightRecorder::FlightRecorder(const std::string& path, size_t size)
+            : path_(path), capacity_(std::max(size, min_size)), fd_(-1), map_(nullptr), head_(nullptr),
+              ring_(nullptr) {
+        fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd_ < 0)
+            throw std::runtime_error("FlightRecorder: failed to open " + path);
+
+        size_t file_size = header_size + capacity_;
+        void* map = MAP_FAILED;
+        if (ftruncate(fd_, static_cast<off_t>(file_size)) == 0)
+            map = mmap(nullptr, file_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (map == MAP_FAILED) {
+            ::close(fd_);
+            throw std::runtime_error("FlightRecorder: failed to map " + path);
+        }
+
+        map_ = static_cast<char*>(map);
+        memcpy(map_, magic, magic_size);
+        auto capacity = static_cast<uint64_t>(capacity_);
+        memcpy(map_ + capacity_offset, &capacity, sizeof(capacity));
+        head_ = new (map_ + head_offset) std::atomic<uint64_t>(0);
+        ring_ = map_ + header_size;
+    }
+
+    FlightRecorder::~FlightRecorder() {
+        munmap(map_, header_size + capacity_);
+        ::close(fd_);
+    }
+
+    void FlightRecorder::record(std::string_view line) {
+        if (line.size() > capacity_)
+            return;
+        uint64_t start = head_->fetch_add(line.size(), std::memory_order_relaxed);
+        auto offset = static_cast<size_t>(start % capacity_);
+        size_t first = std::min(line.size(), capacity_ - offset);
+        memcpy(ring_ + offset, line.data(), first);
+        memcpy(ring_, line.data() + first, line.size() - first);
+    }
+
+    uint64_t FlightRecorder::recorded() const {
+        return head_->load(std::memory_order_relaxed);
+    }
+
+    std::vector<std::string> FlightRecorder::read_lines(const std::string& path, size_t max_lines) {
+        std::ifstream input(path, std::ios::in | std::ios::binary);
+        if (!input)
+            throw std::runtime_error("FlightRecorder: failed to open " + path);
+
+        char header[header_size];
+        uint64_t capacity = 0;
+        uint64_t head = 0;
+        if (!input.read(header, header_size) || memcmp(header, magic, magic_size) != 0)
+            throw std::runtime_error("FlightRecorder: not a flight recorder file: " + path);
+        memcpy(&capacity, header + capacity_offset, sizeof(capacity));
+        memcpy(&head, header + head_offset, sizeof(head));
+
+        std::string ring(capacity, '\0');
+        if (capacity == 0 || !input.read(ring.data(), static_cast<std::streamsize>(capacity)))
+            throw std::runtime_error("FlightRecorder: truncated file: " + path);
+
+        // Unroll the ring into the order the bytes were recorded.
+        uint64_t used = std::min(head, capacity);
+        auto offset = static_cast<size_t>((head - used) % capacity);
+        std::string data = ring.substr(offset, used) + ring.substr(0, used - std::min(used, capacity - offset));
+
+        // After a wrap the oldest line has lost its beginning.
+        size_t start = 0;
+        if (head > capacity) {
+            size_t newline = data.find('\n');
+            start = (newline == std::string::npos) ? data.size() : newline + 1;
+        }
+
+        std::vector<std::string> lines;
+        while (start < data.size()) {
+            size_t end = data.find('\n', start);
+            if (end == std::string::npos)
+                break;
+            std::string line = data.substr(start, end - start);
+            // Zeros are space reserved by a line that was never written.
+            line.erase(std::remove(line.begin(), line.end(), '\0'), line.end());
+            if (!line.empty())
+                lines.push_back(std::move(line));
+            start = end + 1;
+        }
+
+        if (max_lines > 0 && lines.size() > max_lines)
+            lines.erase(lines.begin(), lines.end() - static_cast<std::ptrdiff_t>(max_lines));
+        return lines;
+    }
+}
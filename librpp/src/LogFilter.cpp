@@ -0,0 +1,114 @@
+#include "LogFilter.h"
+
+namespace rpp {
+
+    namespace {
+        constexpr int no_level = static_cast<int>(log_level::ERROR) + 1;
+    }
+
+    std::mutex LogFilter::mutex_;
+    std::atomic<int> LogFilter::min_level_(static_cast<int>(log_level::DEBUG));
+    std::atomic<int> LogFilter::record_level_(no_level);
+    std::atomic<int> LogFilter::sink_level_(no_level);
+    std::map<std::string, log_level, std::less<>> LogFilter::category_levels_;
+    LogSite* LogFilter::sites_ = nullptr;
+
+    bool LogSite::initialise() {
+        LogFilter::register_site(this);
+        return state_.load(std::memory_order_relaxed) != off;
+    }
+
+    void LogFilter::set_min_level(log_level level) {
+        std::scoped_lock lock(mutex_);
+        min_level_.store(static_cast<int>(level), std::memory_order_relaxed);
+        update_sites();
+    }
+
+    log_level LogFilter::min_level() {
+        return static_cast<log_level>(min_level_.load(std::memory_order_relaxed));
+    }
+
+    void LogFilter::set_record_level(log_level level) {
+        std::scoped_lock lock(mutex_);
+        record_level_.store(static_cast<int>(level), std::memory_order_relaxed);
+        update_sites();
+    }
+
+    void LogFilter::clear_record_level() {
+        std::scoped_lock lock(mutex_);
+        record_level_.store(no_level, std::memory_order_relaxed);
+        update_sites();
+    }
+
+    void LogFilter::set_sink_level(log_level level) {
+        std::scoped_lock lock(mutex_);
+        sink_level_.store(static_cast<int>(level), std::memory_order_relaxed);
+        update_sites();
+    }
+
+    void LogFilter::clear_sink_level() {
+        std::scoped_lock lock(mutex_);
+        sink_level_.store(no_level, std::memory_order_relaxed);
+        update_sites();
+    }
+
+    bool LogFilter::reaches_sinks(log_level level) {
+        return static_cast<int>(level) >= sink_level_.load(std::memory_order_relaxed);
+    }
+
+    bool LogFilter::is_recorded(log_level level) {
+        return static_cast<int>(level) >= record_level_.load(std::memory_order_relaxed);
+    }
+
+    void LogFilter::set_category_level(std::string_view category, log_level level) {
+        std::scoped_lock lock(mutex_);
+        category_levels_[std::string(category)] = level;
+        update_sites();
+    }
+
+    void LogFilter::clear_category_levels() {
+        std::scoped_lock lock(mutex_);
+        category_levels_.clear();
+        update_sites();
+    }
+
+    bool LogFilter::is_enabled(log_level level, const char* category) {
+        if (category == nullptr)
+            return static_cast<int>(level) >= min_level_.load(std::memory_order_relaxed);
+        std::scoped_lock lock(mutex_);
+        return is_enabled_locked(level, category);
+    }
+
+    bool LogFilter::is_enabled_locked(log_level level, const char* category) {
+        log_level threshold = min_level();
+        if (category != nullptr) {
+            auto entry = category_levels_.find(std::string_view(category));
+            if (entry != category_levels_.end())
+                threshold = entry->second;
+        }
+        return level >= threshold;
+    }
+
+    int LogFilter::site_state_locked(log_level level, const char* category) {
+        if (is_enabled_locked(level, category))
+            return LogSite::on;
+        if (reaches_sinks(level))
+            return LogSite::sinks;
+        return is_recorded(level) ? LogSite::recorded : LogSite::off;
+    }
+
+    void LogFilter::register_site(LogSite* site) {
+        std::scoped_lock lock(mutex_);
+        if (site->state_.load(std::memory_order_relaxed) == LogSite::unknown) {
+            site->next_ = sites_;
+            sites_ = site;
+        }
+        site->state_.store(site_state_locked(site->level_, site->category_), std::memory_order_relaxed);
+    }
+
+    void LogFilter::update_sites() {
+        for (LogSite* site = sites_; site != nullptr; site = site->next_) {
+            site->state_.store(site_state_locked(site->level_, site->category_), std::memory_order_relaxed);
+        }
+    }
+}
@@ -0,0 +1,181 @@
+#include <algorithm>
+#include <cstring>
+#include "LogLimiter.h"
+#include "Logger.h"
+
+namespace rpp {
+
+    std::atomic<bool> LogLimiter::active_(false);
+    std::atomic<int64_t> LogLimiter::interval_ns_(0);
+    std::atomic<int64_t> LogLimiter::tolerance_ns_(0);
+    std::atomic<int64_t> LogLimiter::window_ns_(0);
+    std::atomic<LogLimiter*> LogLimiter::sites_(nullptr);
+
+    namespace {
+        // FNV-1a
+        uint64_t hash_of(std::string_view text) {
+            uint64_t hash = 14695981039346656037ull;
+            for (char c : text) {
+                hash ^= static_cast<unsigned char>(c);
+                hash *= 1099511628211ull;
+            }
+            return hash ^ text.size();
+        }
+    }
+
+    void LogLimiter::set_rate_limit(double messages_per_second, size_t burst) {
+        int64_t interval = 0;
+        if (messages_per_second > 0.0)
+            interval = std::max(static_cast<int64_t>(1e9 / messages_per_second), static_cast<int64_t>(1));
+        tolerance_ns_.store(interval * static_cast<int64_t>(std::max(burst, static_cast<size_t>(1))),
+                            std::memory_order_relaxed);
+        interval_ns_.store(interval, std::memory_order_relaxed);
+        update_active();
+    }
+
+    void LogLimiter::set_deduplication(std::chrono::milliseconds window) {
+        window_ns_.store(std::chrono::duration_cast<std::chrono::nanoseconds>(window).count(),
+                         std::memory_order_relaxed);
+        if (window.count() <= 0)
+            flush();
+        update_active();
+    }
+
+    void LogLimiter::flush() {
+        int64_t now = now_ns();
+        for (LogLimiter* site = sites_.load(std::memory_order_acquire); site != nullptr; site = site->next_)
+            site->report_repeats(now, true);
+    }
+
+    void LogLimiter::update_active() {
+        bool active = interval_ns_.load(std::memory_order_relaxed) > 0
+                      || window_ns_.load(std::memory_order_relaxed) > 0;
+        active_.store(active, std::memory_order_relaxed);
+    }
+
+    int64_t LogLimiter::now_ns() {
+        auto now = std::chrono::steady_clock::now().time_since_epoch();
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
+    }
+
+    bool LogLimiter::check() {
+        if (interval_ns_.load(std::memory_order_relaxed) <= 0)
+            return true;
+        int64_t now = now_ns();
+        if (!acquire_token(now)) {
+            if (suppressed_.fetch_add(1, std::memory_order_relaxed) == 0)
+                suppressed_since_.store(now, std::memory_order_relaxed);
+            return false;
+        }
+        if (suppressed_.load(std::memory_order_relaxed) > 0)
+            report_suppressed(now);
+        return true;
+    }
+
+    // Each message moves the theoretical arrival time one interval on. A
+    // message is refused while that time is more than a burst ahead of now.
+    bool LogLimiter::acquire_token(int64_t now) {
+        int64_t interval = interval_ns_.load(std::memory_order_relaxed);
+        int64_t tolerance = tolerance_ns_.load(std::memory_order_relaxed);
+        int64_t tat = tat_.load(std::memory_order_relaxed);
+        while (true) {
+            int64_t next = std::max(tat, now) + interval;
+            if (next - now > tolerance)
+                return false;
+            if (tat_.compare_exchange_weak(tat, next, std::memory_order_relaxed))
+                return true;
+        }
+    }
+
+    void LogLimiter::report_suppressed(int64_t now) {
+        uint64_t count = suppressed_.exchange(0, std::memory_order_relaxed);
+        if (count == 0)
+            return;
+        double seconds = static_cast<double>(now - suppressed_since_.load(std::memory_order_relaxed)) / 1e9;
+        log_unfiltered(level_, "%s:%d: %llu messages suppressed in %.1fs", file_name(), line_,
+                       static_cast<unsigned long long>(count), seconds);
+    }
+
+    // The site is taken off the thread first, so that the summary, which
+    // goes through the logger like any message, is not checked itself.
+    bool LogLimiter::is_repeat(std::string_view message) {
+        LogLimiter* site = current_;
+        if (site == nullptr)
+            return false;
+        current_ = nullptr;
+        int64_t now = now_ns();
+        LogLimiter* previous = previous_;
+        previous_ = site;
+        if (previous != nullptr && previous != site)
+            previous->report_repeats(now, false);
+        return site->repeat(message, now);
+    }
+
+    bool LogLimiter::repeat(std::string_view message, int64_t now) {
+        repeat_report report{};
+        bool repeated;
+        {
+            std::scoped_lock lock(mutex_);
+            register_site();
+            uint64_t hash = hash_of(message);
+            repeated = has_last_ && hash == last_hash_;
+            if (!repeated) {
+                take_repeats(now, report);
+                has_last_ = true;
+                last_hash_ = hash;
+                text_size_ = std::min(message.size(), max_text_size);
+                memcpy(text_, message.data(), text_size_);
+            } else if (repeats_++ == 0) {
+                repeat_start_ = now;
+            } else if (now - repeat_start_ >= window_ns_.load(std::memory_order_relaxed)) {
+                take_repeats(now, report);
+            }
+        }
+        write_report(report);
+        return repeated;
+    }
+
+    void LogLimiter::report_repeats(int64_t now, bool forget) {
+        repeat_report report{};
+        {
+            std::scoped_lock lock(mutex_);
+            take_repeats(now, report);
+            if (forget)
+                has_last_ = false;
+        }
+        write_report(report);
+    }
+
+    void LogLimiter::take_repeats(int64_t now, repeat_report& report) {
+        report.count = repeats_;
+        if (repeats_ == 0)
+            return;
+        report.seconds = static_cast<double>(now - repeat_start_) / 1e9;
+        memcpy(report.text, text_, text_size_);
+        report.text_size = text_size_;
+        repeats_ = 0;
+    }
+
+    void LogLimiter::write_report(const repeat_report& report) const {
+        if (report.count == 0)
+            return;
+        log_unfiltered(level_, "%s:%d: message repeated %llu times in %.1fs: %.*s", file_name(), line_,
+                       static_cast<unsigned long long>(report.count), report.seconds,
+                       static_cast<int>(report.text_size), report.text);
+    }
+
+    // Sites are never removed: they have static storage duration.
+    void LogLimiter::register_site() {
+        if (registered_)
+            return;
+        registered_ = true;
+        next_ = sites_.load(std::memory_order_relaxed);
+        while (!sites_.compare_exchange_weak(next_, this, std::memory_order_release, std::memory_order_relaxed)) {
+        }
+    }
+
+    const char* LogLimiter::file_name() const {
+        const char* slash = strrchr(file_, '/');
+        return (slash != nullptr) ? slash + 1 : file_;
+    }
+}
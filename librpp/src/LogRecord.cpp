@@ -0,0 +1,226 @@
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <cmath>
+#include "LogRecord.h"
+
+namespace rpp {
+
+    namespace {
+        const char* json_level_name(log_level level) {
+            switch (level) {
+                case log_level::DEBUG:
+                    return "DEBUG";
+                case log_level::INFO:
+                    return "INFO";
+                case log_level::WARNING:
+                    return "WARNING";
+                case log_level::ERROR:
+                    return "ERROR";
+                default:
+                    return "";
+            }
+        }
+
+        void append(LogBuffer& out, std::string_view text) {
+            out.append(text.data(), text.size());
+        }
+
+        template <typename T>
+        void append_number(LogBuffer& out, T value, int base = 10) {
+            char digits[32];
+            std::to_chars_result converted{};
+            if constexpr (std::is_floating_point_v<T>)
+                converted = std::to_chars(digits, digits + sizeof(digits), value);
+            else
+                converted = std::to_chars(digits, digits + sizeof(digits), value, base);
+            out.append(digits, static_cast<size_t>(converted.ptr - digits));
+        }
+
+        template <typename T>
+        void append_raw(LogBuffer& out, T value) {
+            char bytes[sizeof(T)];
+            memcpy(bytes, &value, sizeof(T));
+            out.append(bytes, sizeof(T));
+        }
+
+        void append_json_string(LogBuffer& out, std::string_view text) {
+            static constexpr char hex[] = "0123456789abcdef";
+            out.append(1, '"');
+            size_t start = 0;
+            for (size_t i = 0; i < text.size(); i++) {
+                auto c = static_cast<unsigned char>(text[i]);
+                if (c >= 0x20 && c != '"' && c != '\\')
+                    continue;
+                out.append(text.data() + start, i - start);
+                start = i + 1;
+                if (c == '"' || c == '\\') {
+                    char escaped[2] = {'\\', static_cast<char>(c)};
+                    out.append(escaped, 2);
+                } else if (c == '\n') {
+                    append(out, "\\n");
+                } else if (c == '\t') {
+                    append(out, "\\t");
+                } else if (c == '\r') {
+                    append(out, "\\r");
+                } else {
+                    char escaped[6] = {'\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xf]};
+                    out.append(escaped, 6);
+                }
+            }
+            out.append(text.data() + start, text.size() - start);
+            out.append(1, '"');
+        }
+
+        void append_json_value(LogBuffer& out, const LogField& field) {
+            switch (field.type()) {
+                case LogField::field_type::INT:
+                    append_number(out, field.int_value());
+                    break;
+                case LogField::field_type::UINT:
+                    append_number(out, field.uint_value());
+                    break;
+                case LogField::field_type::DOUBLE:
+                    // JSON has no NaN or infinity.
+                    if (std::isfinite(field.double_value()))
+                        append_number(out, field.double_value());
+                    else
+                        append(out, "null");
+                    break;
+                case LogField::field_type::BOOL:
+                    append(out, field.bool_value() ? "true" : "false");
+                    break;
+                case LogField::field_type::STRING:
+                    append_json_string(out, field.string_value());
+                    break;
+                case LogField::field_type::NONE:
+                default:
+                    append(out, "null");
+                    break;
+            }
+        }
+
+        void append_binary_string(LogBuffer& out, std::string_view text, size_t max_size) {
+            text = text.substr(0, max_size);
+            if (max_size > 0xff)
+                append_raw(out, static_cast<uint16_t>(text.size()));
+            else
+                append_raw(out, static_cast<uint8_t>(text.size()));
+            out.append(text.data(), text.size());
+        }
+    }
+
+    void encode_text_body(const LogRecord& record, LogBuffer& out) {
+        append(out, record.message);
+        append(out, record.event);
+        for (size_t i = 0; i < record.field_count; i++) {
+            const LogField& field = record.fields[i];
+            out.append(1, ' ');
+            append(out, field.key());
+            out.append(1, '=');
+            switch (field.type()) {
+                case LogField::field_type::INT:
+                    append_number(out, field.int_value());
+                    break;
+                case LogField::field_type::UINT:
+                    append_number(out, field.uint_value());
+                    break;
+                case LogField::field_type::DOUBLE:
+                    append_number(out, field.double_value());
+                    break;
+                case LogField::field_type::BOOL:
+                    append(out, field.bool_value() ? "true" : "false");
+                    break;
+                case LogField::field_type::STRING:
+                    out.append(1, '"');
+                    append(out, field.string_value());
+                    out.append(1, '"');
+                    break;
+                case LogField::field_type::NONE:
+                default:
+                    break;
+            }
+        }
+    }
+
+    void encode_json_line(const LogRecord& record, LogBuffer& out) {
+        append(out, "{\"time\":");
+        append_number(out, record.timestamp);
+        append(out, ",\"level\":\"");
+        append(out, json_level_name(record.level));
+        append(out, "\",\"app\":");
+        append_json_string(out, record.application);
+        append(out, ",\"thread\":");
+        append_json_string(out, record.thread);
+        if (record.event.empty() && record.field_count == 0) {
+            append(out, ",\"msg\":");
+            append_json_string(out, record.message);
+        } else {
+            append(out, ",\"event\":");
+            append_json_string(out, record.event);
+            append(out, ",\"fields\":{");
+            for (size_t i = 0; i < record.field_count; i++) {
+                if (i > 0)
+                    out.append(1, ',');
+                append_json_string(out, record.fields[i].key());
+                out.append(1, ':');
+                append_json_value(out, record.fields[i]);
+            }
+            out.append(1, '}');
+        }
+        append(out, "}\n");
+    }
+
+    void encode_binary_record(const LogRecord& record, LogBuffer& out) {
+        static constexpr size_t max_string_size = 0xffff;
+        static constexpr size_t max_key_size = 0xff;
+        static constexpr size_t max_fields = 0xff;
+
+        // The length is patched in once the record is complete.
+        size_t start = out.view().size();
+        append_raw(out, static_cast<uint32_t>(0));
+        append_raw(out, static_cast<uint8_t>(record.level));
+        append_raw(out, record.timestamp);
+        append_binary_string(out, record.thread, max_string_size);
+        append_binary_string(out, record.application, max_string_size);
+        append_binary_string(out, record.event, max_string_size);
+        append_binary_string(out, record.message, max_string_size);
+
+        size_t count = std::min(record.field_count, max_fields);
+        append_raw(out, static_cast<uint8_t>(count));
+        for (size_t i = 0; i < count; i++) {
+            const LogField& field = record.fields[i];
+            append_binary_string(out, field.key(), max_key_size);
+            switch (field.type()) {
+                case LogField::field_type::INT:
+                    out.append(1, 'i');
+                    append_raw(out, field.int_value());
+                    break;
+                case LogField::field_type::UINT:
+                    out.append(1, 'u');
+                    append_raw(out, field.uint_value());
+                    break;
+                case LogField::field_type::DOUBLE:
+                    out.append(1, 'f');
+                    append_raw(out, field.double_value());
+                    break;
+                case LogField::field_type::BOOL:
+                    out.append(1, 'b');
+                    append_raw(out, static_cast<uint8_t>(field.bool_value()));
+                    break;
+                case LogField::field_type::STRING:
+                    out.append(1, 's');
+                    append_binary_string(out, field.string_value(), max_string_size);
+                    break;
+                case LogField::field_type::NONE:
+                default:
+                    out.append(1, 's');
+                    append_raw(out, static_cast<uint16_t>(0));
+                    break;
+            }
+        }
+
+        auto length = static_cast<uint32_t>(out.view().size() - start - sizeof(uint32_t));
+        out.overwrite(start, reinterpret_cast<const char*>(&length), sizeof(length));
+    }
+}
@@ -0,0 +1,301 @@
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "LogSearch.h"
+
+namespace rpp {
+
+    namespace {
+        // "YYYYMMDD-HHMMSS.mmm"
+        constexpr size_t datetime_size = 19;
+        constexpr uint64_t no_time = 0;
+
+        bool is_digit(char c) {
+            return c >= '0' && c <= '9';
+        }
+
+        // The time at the start of a line, or no_time if it has none.
+        uint64_t line_time(std::string_view line) {
+            if (line.size() < datetime_size || line[8] != '-' || line[15] != '.')
+                return no_time;
+            uint64_t time = 0;
+            for (size_t i = 0; i < datetime_size; i++) {
+                if (i == 8 || i == 15)
+                    continue;
+                if (!is_digit(line[i]))
+                    return no_time;
+                time = time * 10 + static_cast<uint64_t>(line[i] - '0');
+            }
+            return time;
+        }
+
+        bool parse_level(std::string_view code, log_level& level) {
+            if (code == "DD")
+                level = log_level::DEBUG;
+            else if (code == "II")
+                level = log_level::INFO;
+            else if (code == "WW")
+                level = log_level::WARNING;
+            else if (code == "EE")
+                level = log_level::ERROR;
+            else
+                return false;
+            return true;
+        }
+
+        bool matches(std::string_view line, uint64_t time, const log_query& query) {
+            if (time < query.from || time >= query.to)
+                return false;
+            // "DTC, LL, app, "
+            std::string_view rest = line.substr(std::min(line.size(), datetime_size));
+            log_level level;
+            if (rest.size() < 6 || rest.substr(0, 2) != ", " || !parse_level(rest.substr(2, 2), level)
+                || rest.substr(4, 2) != ", ")
+                return false;
+            if (level < query.level)
+                return false;
+            if (query.application.empty())
+                return true;
+            rest = rest.substr(6);
+            return rest.size() > query.application.size()
+                   && rest.compare(0, query.application.size(), query.application) == 0
+                   && rest[query.application.size()] == ',';
+        }
+
+        template <typename T>
+        void write_raw(std::ofstream& out, T value) {
+            out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        template <typename T>
+        bool read_raw(std::ifstream& in, T& value) {
+            return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+        }
+    }
+
+    LogSearch::LogSearch(const std::string& path, size_t stride)
+            : path_(path), stride_(std::max(stride, static_cast<size_t>(1))), fd_(-1), map_(nullptr),
+              map_size_(0), device_(0), inode_(0), entries_(), max_so_far_(), indexed_size_(0) {
+        fd_ = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd_ < 0)
+            throw std::runtime_error("LogSearch: failed to open " + path);
+        struct stat info{};
+        fstat(fd_, &info);
+        device_ = static_cast<uint64_t>(info.st_dev);
+        inode_ = static_cast<uint64_t>(info.st_ino);
+        load_index();
+        refresh();
+    }
+
+    LogSearch::~LogSearch() {
+        unmap();
+        ::close(fd_);
+    }
+
+    std::string LogSearch::index_path(const std::string& log_path) {
+        return log_path + ".idx";
+    }
+
+    uint64_t LogSearch::parse_time(std::string_view datetime) {
+        static constexpr char pattern[] = "00000000-000000.000";
+        if (datetime.size() < 8 || datetime.size() > datetime_size)
+            throw std::invalid_argument("not a compact datetime: " + std::string(datetime));
+        char full[datetime_size];
+        memcpy(full, pattern, datetime_size);
+        for (size_t i = 0; i < datetime.size(); i++) {
+            bool separator = (i == 8 || i == 15);
+            if (separator ? datetime[i] != pattern[i] : !is_digit(datetime[i]))
+                throw std::invalid_argument("not a compact datetime: " + std::string(datetime));
+            full[i] = datetime[i];
+        }
+        return line_time(std::string_view(full, datetime_size));
+    }
+
+    // The file is mapped again when it has grown. The path is opened again
+    // when it now names another file or the file is shorter than the index.
+    uint64_t LogSearch::refresh() {
+        struct stat info{};
+        if (stat(path_.c_str(), &info) == 0
+            && (static_cast<uint64_t>(info.st_ino) != inode_ || static_cast<uint64_t>(info.st_dev) != device_)) {
+            int fd = ::open(path_.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd >= 0) {
+                unmap();
+                ::close(fd_);
+                fd_ = fd;
+                fstat(fd_, &info);
+                device_ = static_cast<uint64_t>(info.st_dev);
+                inode_ = static_cast<uint64_t>(info.st_ino);
+                reset_index();
+            }
+        }
+        map();
+        if (!index_matches_file())
+            reset_index();
+
+        uint64_t start = indexed_size_;
+        uint64_t pos = indexed_size_;
+        while (pos < map_size_) {
+            const char* line = map_ + pos;
+            const void* newline = memchr(line, '\n', map_size_ - pos);
+            if (newline == nullptr)
+                break;
+            uint64_t next = static_cast<uint64_t>(static_cast<const char*>(newline) - map_) + 1;
+            uint64_t time = line_time(std::string_view(line, next - pos));
+            if (time != no_time) {
+                if (entries_.empty() || pos >= entries_.back().offset + stride_) {
+                    entries_.push_back(Entry{pos, time, time});
+                    max_so_far_.push_back(std::max(time, max_so_far_.empty() ? 0 : max_so_far_.back()));
+                } else {
+                    Entry& entry = entries_.back();
+                    entry.min_time = std::min(entry.min_time, time);
+                    entry.max_time = std::max(entry.max_time, time);
+                    max_so_far_.back() = std::max(max_so_far_.back(), time);
+                }
+            }
+            pos = next;
+        }
+        indexed_size_ = pos;
+        return indexed_size_ - start;
+    }
+
+    size_t LogSearch::search(const log_query& query, const std::function<void(std::string_view)>& found) const {
+        // Every block before first holds only lines older than query.from.
+        auto first = static_cast<size_t>(std::lower_bound(max_so_far_.begin(), max_so_far_.end(), query.from)
+                                         - max_so_far_.begin());
+        size_t count = 0;
+        // Later blocks are not ruled out: staged lines can be written after
+        // newer ones, so a block past query.to may be followed by one that
+        // matches. Only the index entries of such blocks are read.
+        for (size_t i = first; i < entries_.size(); i++) {
+            if (entries_[i].min_time >= query.to || entries_[i].max_time < query.from)
+                continue;
+            uint64_t end = (i + 1 < entries_.size()) ? entries_[i + 1].offset : indexed_size_;
+
+            std::string_view block = mapped(entries_[i].offset, end);
+            bool matching = false;
+            size_t pos = 0;
+            while (pos < block.size()) {
+                size_t next = block.find('\n', pos);
+                next = (next == std::string_view::npos) ? block.size() : next + 1;
+                std::string_view line = block.substr(pos, next - pos);
+                uint64_t time = line_time(line);
+                if (time != no_time)
+                    matching = matches(line, time, query);
+                if (matching) {
+                    found(line);
+                    count++;
+                }
+                pos = next;
+            }
+        }
+        return count;
+    }
+
+    // Written to a temporary file and renamed, so a reader never sees half
+    // an index.
+    void LogSearch::save_index() const {
+        std::string path = index_path(path_);
+        std::string temporary = path + ".tmp";
+        {
+            std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+            out.write(magic, magic_size);
+            write_raw(out, static_cast<uint64_t>(stride_));
+            write_raw(out, device_);
+            write_raw(out, inode_);
+            write_raw(out, indexed_size_);
+            write_raw(out, static_cast<uint64_t>(entries_.size()));
+            for (const auto& entry : entries_) {
+                write_raw(out, entry.offset);
+                write_raw(out, entry.min_time);
+                write_raw(out, entry.max_time);
+            }
+            if (!out)
+                throw std::runtime_error("LogSearch: failed to write " + temporary);
+        }
+        if (rename(temporary.c_str(), path.c_str()) != 0)
+            throw std::runtime_error("LogSearch: failed to write " + path);
+    }
+
+    // An index of another file, or of another stride, is ignored.
+    bool LogSearch::load_index() {
+        std::ifstream in(index_path(path_), std::ios::binary);
+        char file_magic[magic_size];
+        uint64_t stride = 0;
+        uint64_t device = 0;
+        uint64_t inode = 0;
+        uint64_t indexed_size = 0;
+        uint64_t count = 0;
+        if (!in.read(file_magic, magic_size) || memcmp(file_magic, magic, magic_size) != 0
+            || !read_raw(in, stride) || !read_raw(in, device) || !read_raw(in, inode)
+            || !read_raw(in, indexed_size) || !read_raw(in, count)
+            || stride != stride_ || device != device_ || inode != inode_)
+            return false;
+
+        std::vector<Entry> entries;
+        std::vector<uint64_t> max_so_far;
+        for (uint64_t i = 0; i < count; i++) {
+            Entry entry{};
+            if (!read_raw(in, entry.offset) || !read_raw(in, entry.min_time) || !read_raw(in, entry.max_time)
+                || entry.offset >= indexed_size || (!entries.empty() && entry.offset <= entries.back().offset))
+                return false;
+            entries.push_back(entry);
+            max_so_far.push_back(std::max(entry.max_time, max_so_far.empty() ? 0 : max_so_far.back()));
+        }
+        entries_.swap(entries);
+        max_so_far_.swap(max_so_far);
+        indexed_size_ = indexed_size;
+        return true;
+    }
+
+    // A cheap check that the indexed part of the file is still the same:
+    // it ends with a newline and the last block starts with a timestamp.
+    bool LogSearch::index_matches_file() const {
+        if (indexed_size_ == 0)
+            return true;
+        if (map_size_ < indexed_size_ || map_[indexed_size_ - 1] != '\n')
+            return false;
+        return entries_.empty() || line_time(mapped(entries_.back().offset, indexed_size_)) != no_time;
+    }
+
+    void LogSearch::reset_index() {
+        entries_.clear();
+        max_so_far_.clear();
+        indexed_size_ = 0;
+    }
+
+    void LogSearch::map() {
+        struct stat info{};
+        if (fstat(fd_, &info) != 0)
+            return;
+        auto size = static_cast<size_t>(info.st_size);
+        if (size == map_size_)
+            return;
+        unmap();
+        if (size == 0)
+            return;
+        void* map = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd_, 0);
+        if (map == MAP_FAILED)
+            throw std::runtime_error("LogSearch: failed to map " + path_);
+        map_ = static_cast<const char*>(map);
+        map_size_ = size;
+    }
+
+    void LogSearch::unmap() {
+        if (map_ != nullptr)
+            munmap(const_cast<char*>(map_), map_size_);
+        map_ = nullptr;
+        map_size_ = 0;
+    }
+
+    std::string_view LogSearch::mapped(uint64_t begin, uint64_t end) const {
+        end = std::min(end, static_cast<uint64_t>(map_size_));
+        if (begin >= end)
+            return {};
+        return std::string_view(map_ + begin, static_cast<size_t>(end - begin));
+    }
+}
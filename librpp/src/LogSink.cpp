@@ -0,0 +1,194 @@
+#include <algorithm>
+#include <iostream>
+#include "LogSink.h"
+#include "StringUtils.h"
+
+namespace rpp {
+
+    LogSink::LogSink(std::string_view name, const std::shared_ptr<ILogWriter>& writer, log_level level,
+                     size_t capacity, log_overflow_policy policy)
+            : name_(name), writer_(writer), level_(level), capacity_(capacity > 0 ? capacity : 1),
+              policy_(policy), queue_mutex_(), not_empty_(), not_full_(), written_(), queue_(),
+              enqueued_(0), completed_(0), quit_(false), dropped_(0), reported_dropped_(0), thread_() {
+        queue_.reserve(capacity_);
+        thread_ = std::thread(&LogSink::run, this);
+    }
+
+    LogSink::~LogSink() {
+        stop();
+        try {
+            writer_->close();
+        } catch (const std::exception& e) {
+            std::cerr << "LogSink '" << name_ << "' failed to close: " << e.what() << std::endl;
+        }
+    }
+
+    void LogSink::post(const shared_log_line& line) {
+        std::unique_lock lock(queue_mutex_);
+        if (queue_.size() >= capacity_) {
+            if (policy_ != log_overflow_policy::BLOCK) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            not_full_.wait(lock, [this] { return queue_.size() < capacity_ || quit_; });
+        }
+        queue_.push_back(line);
+        enqueued_++;
+        bool was_empty = (queue_.size() == 1);
+        lock.unlock();
+        if (was_empty)
+            not_empty_.notify_one();
+    }
+
+    void LogSink::flush() {
+        std::unique_lock lock(queue_mutex_);
+        uint64_t target = enqueued_;
+        written_.wait(lock, [this, target] { return completed_ >= target || quit_; });
+    }
+
+    uint64_t LogSink::dropped() const {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+
+    void LogSink::stop() {
+        {
+            std::scoped_lock lock(queue_mutex_);
+            if (quit_)
+                return;
+            quit_ = true;
+        }
+        not_empty_.notify_one();
+        not_full_.notify_all();
+        if (thread_.joinable())
+            thread_.join();
+        written_.notify_all();
+    }
+
+    // The shared lines are handed to the writer as views; nothing is copied
+    // unless the writer itself does.
+    void LogSink::run() {
+        std::vector<shared_log_line> batch;
+        std::vector<std::string_view> chunks;
+        std::string report;
+        batch.reserve(capacity_);
+        chunks.reserve(capacity_ + 1);
+
+        while (true) {
+            uint64_t batch_end;
+            {
+                std::unique_lock lock(queue_mutex_);
+                not_empty_.wait(lock, [this] { return quit_ || !queue_.empty(); });
+                if (queue_.empty())
+                    break;
+                batch.swap(queue_);
+                batch_end = enqueued_;
+            }
+            not_full_.notify_all();
+
+            chunks.clear();
+            uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+            if (policy_ == log_overflow_policy::COUNT_AND_DROP && dropped != reported_dropped_) {
+                report = StringUtils::string_format("LogSink '%s' dropped %llu log messages\n", name_.c_str(),
+                                                    static_cast<unsigned long long>(dropped - reported_dropped_));
+                reported_dropped_ = dropped;
+                chunks.emplace_back(report);
+            }
+            for (const auto& line : batch)
+                chunks.emplace_back(*line);
+
+            try {
+                writer_->write_batch(chunks);
+            } catch (const std::exception& e) {
+                std::cerr << "LogSink '" << name_ << "' failed to write: " << e.what() << std::endl;
+            }
+            batch.clear();
+
+            {
+                std::scoped_lock lock(queue_mutex_);
+                completed_ = batch_end;
+            }
+            written_.notify_all();
+        }
+    }
+
+    LogSinks::LogSinks() : mutex_(), sinks_(std::make_shared<const sink_list>()), count_(0) {
+    }
+
+    std::shared_ptr<const LogSinks::sink_list> LogSinks::load() const {
+        return std::atomic_load(&sinks_);
+    }
+
+    void LogSinks::store(const std::shared_ptr<const sink_list>& sinks) {
+        std::atomic_store(&sinks_, sinks);
+        count_.store(sinks->size(), std::memory_order_release);
+    }
+
+    void LogSinks::add(const std::shared_ptr<LogSink>& sink) {
+        std::scoped_lock lock(mutex_);
+        auto sinks = std::make_shared<sink_list>(*load());
+        auto same_name = [&sink](const std::shared_ptr<LogSink>& s) { return s->name() == sink->name(); };
+        sinks->erase(std::remove_if(sinks->begin(), sinks->end(), same_name), sinks->end());
+        sinks->push_back(sink);
+        store(sinks);
+    }
+
+    bool LogSinks::remove(std::string_view name) {
+        std::scoped_lock lock(mutex_);
+        auto sinks = std::make_shared<sink_list>(*load());
+        auto same_name = [name](const std::shared_ptr<LogSink>& s) { return s->name() == name; };
+        auto removed = std::remove_if(sinks->begin(), sinks->end(), same_name);
+        if (removed == sinks->end())
+            return false;
+        sinks->erase(removed, sinks->end());
+        store(sinks);
+        return true;
+    }
+
+    bool LogSinks::set_level(std::string_view name, log_level level) {
+        auto sink = find(name);
+        if (sink == nullptr)
+            return false;
+        sink->set_level(level);
+        return true;
+    }
+
+    std::shared_ptr<LogSink> LogSinks::find(std::string_view name) const {
+        for (const auto& sink : *load()) {
+            if (sink->name() == name)
+                return sink;
+        }
+        return nullptr;
+    }
+
+    bool LogSinks::min_level(log_level& level) const {
+        auto sinks = load();
+        if (sinks->empty())
+            return false;
+        level = log_level::ERROR;
+        for (const auto& sink : *sinks)
+            level = std::min(level, sink->level());
+        return true;
+    }
+
+    void LogSinks::clear() {
+        std::scoped_lock lock(mutex_);
+        store(std::make_shared<const sink_list>());
+    }
+
+    void LogSinks::publish(log_level level, std::string_view line) {
+        auto sinks = load();
+        shared_log_line shared;
+        for (const auto& sink : *sinks) {
+            if (!sink->accepts(level))
+                continue;
+            if (shared == nullptr)
+                shared = std::make_shared<const std::string>(line);
+            sink->post(shared);
+        }
+    }
+
+    void LogSinks::flush() {
+        for (const auto& sink : *load())
+            sink->flush();
+    }
+}
@@ -0,0 +1,139 @@
+#include "LogStaging.h"
+
+namespace rpp {
+
+    namespace {
+        std::atomic<uint64_t> next_staging_id_(1);
+
+        struct ThreadBufferCache
+        {
+            uint64_t owner;
+            std::shared_ptr<void> buffer;
+        };
+        thread_local ThreadBufferCache thread_buffer_cache_{0, nullptr};
+    }
+
+    LogStaging::LogStaging(size_t buffer_size, std::chrono::milliseconds flush_interval)
+            : id_(next_staging_id_.fetch_add(1)), buffer_size_(buffer_size),
+              flush_interval_(flush_interval), flush_mutex_(), writer_(), buffers_(),
+              pending_(), chunks_(), timer_mutex_(), timer_(), quit_(false), thread_() {
+        thread_ = std::thread(&LogStaging::run, this);
+    }
+
+    LogStaging::~LogStaging() {
+        stop();
+        flush();
+    }
+
+    void LogStaging::start(size_t buffer_size, std::chrono::milliseconds flush_interval) {
+        stop();
+        buffer_size_.store(buffer_size, std::memory_order_relaxed);
+        flush_interval_ = flush_interval;
+        quit_ = false;
+        thread_ = std::thread(&LogStaging::run, this);
+    }
+
+    void LogStaging::stop() {
+        if (!thread_.joinable())
+            return;
+        {
+            std::scoped_lock lock(timer_mutex_);
+            quit_ = true;
+        }
+        timer_.notify_one();
+        thread_.join();
+    }
+
+    void LogStaging::set_writer(const std::shared_ptr<ILogWriter>& writer) {
+        std::scoped_lock lock(flush_mutex_);
+        flush_locked();
+        writer_ = writer;
+        flush_locked();
+    }
+
+    void LogStaging::append(std::string_view line) {
+        Buffer& buffer = thread_buffer();
+        {
+            std::scoped_lock lock(buffer.mutex);
+            if (buffer.data.size() + line.size() <= buffer_size_.load(std::memory_order_relaxed)) {
+                buffer.data.append(line);
+                return;
+            }
+        }
+
+        // The buffer is full: write it out together with the new line.
+        std::scoped_lock lock(flush_mutex_);
+        std::scoped_lock buffer_lock(buffer.mutex);
+        buffer.data.append(line);
+        if (writer_) {
+            chunks_.assign(1, buffer.data);
+            writer_->write_batch(chunks_);
+            buffer.data.clear();
+        }
+    }
+
+    void LogStaging::flush() {
+        std::scoped_lock lock(flush_mutex_);
+        flush_locked();
+    }
+
+    void LogStaging::sync() {
+        std::scoped_lock lock(flush_mutex_);
+        flush_locked();
+        if (writer_)
+            writer_->sync();
+    }
+
+    LogStaging::Buffer& LogStaging::thread_buffer() {
+        if (thread_buffer_cache_.owner != id_) {
+            auto buffer = std::make_shared<Buffer>();
+            buffer->data.reserve(buffer_size_.load(std::memory_order_relaxed));
+            {
+                std::scoped_lock lock(flush_mutex_);
+                buffers_.push_back(buffer);
+            }
+            thread_buffer_cache_.owner = id_;
+            thread_buffer_cache_.buffer = buffer;
+        }
+        return *static_cast<Buffer*>(thread_buffer_cache_.buffer.get());
+    }
+
+    void LogStaging::flush_locked() {
+        if (!writer_)
+            return;
+
+        // Swap the buffers out so that logging threads are only held up for
+        // the swap and not for the write.
+        size_t buffer_size = buffer_size_.load(std::memory_order_relaxed);
+        pending_.resize(buffers_.size());
+        chunks_.clear();
+        for (size_t i = 0; i < buffers_.size(); i++) {
+            std::scoped_lock lock(buffers_[i]->mutex);
+            if (pending_[i].capacity() < buffer_size)
+                pending_[i].reserve(buffer_size);
+            std::swap(buffers_[i]->data, pending_[i]);
+            if (!pending_[i].empty())
+                chunks_.emplace_back(pending_[i]);
+        }
+        if (!chunks_.empty())
+            writer_->write_batch(chunks_);
+        for (auto& data : pending_)
+            data.clear();
+
+        // Forget the buffers of threads that have exited.
+        for (size_t i = buffers_.size(); i > 0; i--) {
+            if (buffers_[i - 1].use_count() == 1 && buffers_[i - 1]->data.empty())
+                buffers_.erase(buffers_.begin() + static_cast<long>(i - 1));
+        }
+    }
+
+    void LogStaging::run() {
+        std::unique_lock lock(timer_mutex_);
+        while (!quit_) {
+            timer_.wait_for(lock, flush_interval_, [this] { return quit_; });
+            lock.unlock();
+            flush();
+            lock.lock();
+        }
+    }
+}
@@ -1,3 +1,14 @@
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
 #include "LogWriter.h"
 
 namespace rpp {
@@ -10,22 +21,387 @@ namespace rpp {
         return std::make_shared<FileLogWriter>();
     }
 
-    FileLogWriter::FileLogWriter() : write_stream() {
+    std::shared_ptr<ILogWriter> LogWriterFactory::create_fd_file_writer() {
+        return std::make_shared<FdLogWriter>();
+    }
+
+    std::shared_ptr<ILogWriter> LogWriterFactory::create_mmap_file_writer() {
+        return std::make_shared<MmapLogWriter>();
+    }
+
+    std::shared_ptr<ILogWriter> LogWriterFactory::create_uring_file_writer() {
+        return std::make_shared<UringLogWriter>();
+    }
+
+    std::shared_ptr<ILogWriter> LogWriterFactory::create_durable_file_writer(const log_durability_policy& policy) {
+        return std::make_shared<FileLogWriter>(policy);
+    }
+
+    FileLogWriter::FileLogWriter(const log_durability_policy& policy)
+            : policy_(policy), buffer_(), write_stream(), sync_fd_(-1), mutex_(), sync_mutex_(), timer_(),
+              dirty_(false), quit_(false), thread_() {
+        if (policy_.mode != log_durability::LINE) {
+            buffer_.resize(std::max(policy_.buffer_size, static_cast<size_t>(1)));
+            thread_ = std::thread(&FileLogWriter::run, this);
+        }
+    }
+
+    FileLogWriter::~FileLogWriter() {
+        if (thread_.joinable()) {
+            {
+                std::scoped_lock lock(mutex_);
+                quit_ = true;
+            }
+            timer_.notify_one();
+            thread_.join();
+        }
+        close();
     }
 
     void FileLogWriter::open(const std::string_view file_name) {
         close();
+        std::scoped_lock lock(mutex_);
+        // The stream takes its buffer before it opens the file.
+        if (!buffer_.empty())
+            write_stream.rdbuf()->pubsetbuf(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
         write_stream.open( std::filesystem::path(file_name), std::ios_base::binary|std::ios_base::out|std::ios_base::app );
+        dirty_ = false;
+        if (policy_.mode == log_durability::GROUP_COMMIT && write_stream.is_open()) {
+            std::scoped_lock sync_lock(sync_mutex_);
+            sync_fd_ = ::open(std::string(file_name).c_str(), O_RDONLY | O_CLOEXEC);
+        }
     }
 
     void FileLogWriter::close() {
+        std::scoped_lock lock(mutex_);
         if(write_stream.is_open()){
             write_stream.close();
         }
+        dirty_ = false;
+        std::scoped_lock sync_lock(sync_mutex_);
+        if (sync_fd_ >= 0) {
+            fdatasync(sync_fd_);
+            ::close(sync_fd_);
+            sync_fd_ = -1;
+        }
     }
 
     void FileLogWriter::write(const std::string &message) {
-        write_stream << message << std::flush;
+        std::scoped_lock lock(mutex_);
+        write_stream.write(message.data(), static_cast<std::streamsize>(message.size()));
+        written();
+    }
+
+    void FileLogWriter::write_line(std::string_view line) {
+        std::scoped_lock lock(mutex_);
+        write_stream.write(line.data(), static_cast<std::streamsize>(line.size()));
+        written();
+    }
+
+    void FileLogWriter::write_batch(const std::vector<std::string_view>& chunks) {
+        std::scoped_lock lock(mutex_);
+        for (auto chunk : chunks)
+            write_stream.write(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+        written();
+    }
+
+    // Called with mutex_ held. A full buffer is written out by the stream.
+    void FileLogWriter::written() {
+        if (policy_.mode == log_durability::LINE)
+            write_stream << std::flush;
+        else
+            dirty_ = true;
+    }
+
+    void FileLogWriter::sync() {
+        if (policy_.mode == log_durability::LINE)
+            return;
+        {
+            std::scoped_lock lock(mutex_);
+            write_stream << std::flush;
+            dirty_ = false;
+        }
+        sync_file();
+    }
+
+    void FileLogWriter::sync_file() {
+        std::scoped_lock lock(sync_mutex_);
+        if (sync_fd_ >= 0)
+            fdatasync(sync_fd_);
+    }
+
+    void FileLogWriter::run() {
+        auto interval = std::max(policy_.interval, std::chrono::milliseconds(1));
+        std::unique_lock lock(mutex_);
+        while (!quit_) {
+            timer_.wait_for(lock, interval, [this] { return quit_; });
+            if (!dirty_)
+                continue;
+            write_stream << std::flush;
+            dirty_ = false;
+            lock.unlock();
+            sync_file();
+            lock.lock();
+        }
+    }
+
+    FdLogWriter::FdLogWriter() : fd_(-1) {
+    }
+
+    FdLogWriter::~FdLogWriter() {
+        close();
     }
 
-}
\ No newline at end of file
+    void FdLogWriter::open(const std::string_view file_name) {
+        close();
+        std::string path(file_name);
+        fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    }
+
+    void FdLogWriter::close() {
+        if (fd_ >= 0) {
+            ::close(fd_);
+            fd_ = -1;
+        }
+    }
+
+    void FdLogWriter::write(const std::string &message) {
+        write_all(message.data(), message.size());
+    }
+
+    void FdLogWriter::write_line(std::string_view line) {
+        write_all(line.data(), line.size());
+    }
+
+    void FdLogWriter::write_all(const char *data, size_t size) {
+        while (fd_ >= 0 && size > 0) {
+            ssize_t written = ::write(fd_, data, size);
+            if (written < 0) {
+                if (errno == EINTR)
+                    continue;
+                return;
+            }
+            data += written;
+            size -= static_cast<size_t>(written);
+        }
+    }
+
+    void FdLogWriter::write_batch(const std::vector<std::string_view>& chunks) {
+        if (fd_ < 0)
+            return;
+
+        std::vector<struct iovec> iov;
+        iov.reserve(chunks.size());
+        for (auto chunk : chunks) {
+            if (!chunk.empty())
+                iov.push_back({const_cast<char*>(chunk.data()), chunk.size()});
+        }
+
+        size_t first = 0;
+        while (first < iov.size()) {
+            auto count = static_cast<int>(std::min(iov.size() - first, static_cast<size_t>(IOV_MAX)));
+            ssize_t written = ::writev(fd_, &iov[first], count);
+            if (written < 0) {
+                if (errno == EINTR)
+                    continue;
+                return;
+            }
+            // Skip what was written, resuming part way into a chunk if needed.
+            auto remaining = static_cast<size_t>(written);
+            while (first < iov.size() && remaining >= iov[first].iov_len) {
+                remaining -= iov[first].iov_len;
+                first++;
+            }
+            if (first < iov.size() && remaining > 0) {
+                iov[first].iov_base = static_cast<char*>(iov[first].iov_base) + remaining;
+                iov[first].iov_len -= remaining;
+            }
+        }
+    }
+
+    namespace {
+        size_t round_to_pages(size_t size) {
+            auto page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+            size = std::max(size, page);
+            return (size + page - 1) / page * page;
+        }
+
+        // A writer that did not get to close() leaves the preallocated zeros
+        // of its last segment at the end of the file. Returns the end of the
+        // data, before any trailing zeros.
+        uint64_t find_data_end(int fd, uint64_t size) {
+            char block[4096];
+            while (size > 0) {
+                auto n = static_cast<size_t>(std::min<uint64_t>(size, sizeof(block)));
+                ssize_t result = pread(fd, block, n, static_cast<off_t>(size - n));
+                if (result != static_cast<ssize_t>(n))
+                    return size;
+                for (size_t i = n; i > 0; i--) {
+                    if (block[i - 1] != '\0')
+                        return size - n + i;
+                }
+                size -= n;
+            }
+            return 0;
+        }
+    }
+
+    MmapLogWriter::MmapLogWriter(size_t segment_size)
+            : segment_size_(round_to_pages(segment_size)), fd_(-1), map_(nullptr), map_offset_(0), tail_(0) {
+    }
+
+    MmapLogWriter::~MmapLogWriter() {
+        close();
+    }
+
+    void MmapLogWriter::open(const std::string_view file_name) {
+        close();
+        std::string path(file_name);
+        fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (fd_ < 0)
+            return;
+
+        struct stat info{};
+        if (fstat(fd_, &info) != 0) {
+            close();
+            return;
+        }
+        auto end = find_data_end(fd_, static_cast<uint64_t>(info.st_size));
+        tail_.store(end, std::memory_order_release);
+        if (!map_segment(end - end % round_to_pages(1)))
+            close();
+    }
+
+    void MmapLogWriter::close() {
+        if (fd_ < 0)
+            return;
+        unmap_segment();
+        if (ftruncate(fd_, static_cast<off_t>(tail_.load(std::memory_order_acquire))) != 0)
+            std::cerr << "MmapLogWriter failed to truncate the log: " << strerror(errno) << std::endl;
+        ::close(fd_);
+        fd_ = -1;
+    }
+
+    void MmapLogWriter::write(const std::string &message) {
+        append(message.data(), message.size());
+    }
+
+    void MmapLogWriter::write_line(std::string_view line) {
+        append(line.data(), line.size());
+    }
+
+    void MmapLogWriter::write_batch(const std::vector<std::string_view>& chunks) {
+        for (auto chunk : chunks)
+            append(chunk.data(), chunk.size());
+    }
+
+    uint64_t MmapLogWriter::size() const {
+        return tail_.load(std::memory_order_acquire);
+    }
+
+    void MmapLogWriter::append(const char *data, size_t length) {
+        while (length > 0 && map_ != nullptr) {
+            uint64_t tail = tail_.load(std::memory_order_relaxed);
+            uint64_t segment_end = map_offset_ + segment_size_;
+            if (tail == segment_end) {
+                if (!map_segment(segment_end))
+                    return;
+                continue;
+            }
+            auto n = static_cast<size_t>(std::min<uint64_t>(length, segment_end - tail));
+            memcpy(map_ + (tail - map_offset_), data, n);
+            tail_.store(tail + n, std::memory_order_release);
+            data += n;
+            length -= n;
+        }
+    }
+
+    bool MmapLogWriter::map_segment(uint64_t offset) {
+        unmap_segment();
+        auto start = static_cast<off_t>(offset);
+        auto length = static_cast<off_t>(segment_size_);
+        if (fallocate(fd_, 0, start, length) != 0 && ftruncate(fd_, start + length) != 0)
+            return false;
+        void* map = mmap(nullptr, segment_size_, PROT_WRITE, MAP_SHARED, fd_, start);
+        if (map == MAP_FAILED)
+            return false;
+        map_ = static_cast<char*>(map);
+        map_offset_ = offset;
+        return true;
+    }
+
+    void MmapLogWriter::unmap_segment() {
+        if (map_ != nullptr) {
+            munmap(map_, segment_size_);
+            map_ = nullptr;
+        }
+    }
+
+    UringLogWriter::UringLogWriter(async_io_backend backend, std::chrono::milliseconds interval)
+            : writer_(backend), interval_(std::max(interval, std::chrono::milliseconds(1))), mutex_(), timer_(),
+              dirty_(false), quit_(false), thread_() {
+        thread_ = std::thread(&UringLogWriter::run, this);
+    }
+
+    UringLogWriter::~UringLogWriter() {
+        {
+            std::scoped_lock lock(mutex_);
+            quit_ = true;
+        }
+        timer_.notify_one();
+        thread_.join();
+        close();
+    }
+
+    void UringLogWriter::open(const std::string_view file_name) {
+        std::scoped_lock lock(mutex_);
+        dirty_ = false;
+        try {
+            writer_.open(std::string(file_name), true);
+        } catch (const std::runtime_error&) {
+            // Left closed: writes are dropped, as with the other writers.
+        }
+    }
+
+    void UringLogWriter::close() {
+        std::scoped_lock lock(mutex_);
+        writer_.close();
+        dirty_ = false;
+    }
+
+    void UringLogWriter::write(const std::string &message) {
+        std::scoped_lock lock(mutex_);
+        writer_.write(message.data(), message.size());
+        dirty_ = true;
+    }
+
+    void UringLogWriter::write_line(std::string_view line) {
+        std::scoped_lock lock(mutex_);
+        writer_.write(line.data(), line.size());
+        dirty_ = true;
+    }
+
+    void UringLogWriter::write_batch(const std::vector<std::string_view>& chunks) {
+        std::scoped_lock lock(mutex_);
+        for (auto chunk : chunks)
+            writer_.write(chunk.data(), chunk.size());
+        dirty_ = true;
+    }
+
+    void UringLogWriter::sync() {
+        std::scoped_lock lock(mutex_);
+        writer_.flush();
+        dirty_ = false;
+    }
+
+    void UringLogWriter::run() {
+        std::unique_lock lock(mutex_);
+        while (!quit_) {
+            timer_.wait_for(lock, interval_, [this] { return quit_; });
+            if (!dirty_)
+                continue;
+            writer_.submit();
+            dirty_ = false;
+        }
+    }
+}
@@ -1,76 +1,352 @@
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 #include <mutex>
 #include "Logger.h"
 #include "LogWriter.h"
+#include "AsyncLogWriter.h"
+#include "RotatingLogWriter.h"
+#include "BinaryLog.h"
 #include "ClockAccessor.h"
+#include "ThreadIdentity.h"
 
 namespace rpp
 {
     std::recursive_mutex Logger::log_mutex_;
     std::string Logger::filename_;
     std::shared_ptr<ILogger> Logger::logger_;
+    std::atomic<ILogger*> Logger::published_(nullptr);
 
-     std::shared_ptr<ILogger> Logger::Instance() {
-        {
-            std::scoped_lock lock(log_mutex_);
-            if (logger_ == nullptr) {
-                logger_ = std::shared_ptr<rpp::Logger>(new Logger(std::make_shared<LogWriterFactory>()));
-            }
+    // logger_ is only written before it is published, or by reset_instance()
+    // in tests, so a published reference stays valid.
+    const std::shared_ptr<ILogger>& Logger::Instance() {
+        if (published_.load(std::memory_order_acquire) != nullptr)
+            return logger_;
+        std::scoped_lock lock(log_mutex_);
+        if (logger_ == nullptr) {
+            logger_ = std::shared_ptr<rpp::Logger>(new Logger(std::make_shared<LogWriterFactory>()));
         }
+        published_.store(logger_.get(), std::memory_order_release);
         return logger_;
     }
 
+    void Logger::reset_instance(const std::shared_ptr<ILogger>& logger) {
+        std::scoped_lock lock(log_mutex_);
+        logger_ = logger;
+        published_.store(logger_.get(), std::memory_order_release);
+    }
+
+    void Logger::set_writer_factory(const std::shared_ptr<ILogWriterFactory>& factory) {
+        reset_instance(std::shared_ptr<Logger>(new Logger(factory)));
+    }
+
     Logger::Logger(const std::shared_ptr<ILogWriterFactory>& logWriterFactory) : application_name_("??"),
-        log_level_names_(), logWriterFactory_(logWriterFactory), logWriter_(){
+        switch_mutex_(), logWriterFactory_(logWriterFactory), logWriter_(), async_(false),
+        async_capacity_(AsyncLogWriter::default_capacity), async_policy_(log_overflow_policy::BLOCK),
+        file_writer_type_(file_writer_type::STREAM), rotation_(), durability_(), sync_errors_(false), record_format_(log_record_format::TEXT), sinks_(), recorder_(), recording_(false), staging_(nullptr), staging_instance_(){
         logWriter_ = logWriterFactory->create_console_writer();
-        log_level_names_[log_level::DEBUG] = "DD";
-        log_level_names_[log_level::INFO] = "II";
-        log_level_names_[log_level::WARNING] = "WW";
-        log_level_names_[log_level::ERROR] = "EE";
     }
 
+    // The sink level belongs to this logger's sinks.
+    Logger::~Logger() {
+        if (!sinks_.empty())
+            LogFilter::clear_sink_level();
+    }
+
+    namespace {
+        // Keeps the lines logged while move_log() closes, renames and opens
+        // the file, until they can be written to the writer that takes over.
+        class HoldingLogWriter : public ILogWriter
+        {
+        public:
+            HoldingLogWriter() : mutex_(), lines_() {}
+
+            void open(std::string_view) override {}
+            void close() override {}
+
+            void write(const std::string& message) override {
+                std::scoped_lock lock(mutex_);
+                lines_.push_back(message);
+            }
+
+            void write_line(std::string_view line) override {
+                std::scoped_lock lock(mutex_);
+                lines_.emplace_back(line);
+            }
+
+            void write_to(ILogWriter& writer) {
+                std::scoped_lock lock(mutex_);
+                for (const auto& line : lines_)
+                    writer.write_line(line);
+                lines_.clear();
+            }
+
+        private:
+            std::mutex mutex_;
+            std::vector<std::string> lines_;
+        };
+    }
+
+    // log_mutex_ is only held to swap the writers. While the old writer is
+    // closed, the file renamed and the new writer opened, the lines go to a
+    // HoldingLogWriter, so that no line goes to a file that is being moved
+    // and logging threads do not wait for the I/O.
     void Logger::move_log(std::filesystem::path newpath) {
-        std::scoped_lock lock(log_mutex_);
+        std::scoped_lock switch_lock(switch_mutex_);
         std::filesystem::path current_log_path;
         std::string new_filename = "log.txt";
 
-        if (!filename_.empty()){
+        if (!filename_.empty()) {
             current_log_path = filename_;
             new_filename = current_log_path.filename();
         }
         newpath /= new_filename;
 
+        auto holder = std::make_shared<HoldingLogWriter>();
+        std::shared_ptr<ILogWriter> old_writer;
+        std::shared_ptr<ILogWriter> new_writer;
+        {
+            std::scoped_lock lock(log_mutex_);
+            log(log_level::INFO, "Changing log to '%s'", newpath.c_str());
+            old_writer = logWriter_;
+            new_writer = wrap_writer(create_file_writer());
+            replace_writer(holder);
+        }
+
+        // The staged lines go to the holder, then the held lines to the
+        // writer, before the staging writes to it directly.
+        auto resume = [this, &holder](const std::shared_ptr<ILogWriter>& writer, const std::string& path) {
+            std::scoped_lock lock(log_mutex_);
+            detach_writer();
+            holder->write_to(*writer);
+            replace_writer(writer);
+            filename_ = path;
+        };
+
+        bool renamed = false;
         try {
-            logWriter_->close();
-            {
-                if (!current_log_path.empty())
-                    std::filesystem::rename(current_log_path, newpath);
+            old_writer->close();
+            if (!current_log_path.empty()) {
+                std::filesystem::rename(current_log_path, newpath);
+                renamed = true;
             }
-            log_set_file(newpath.string());
+            new_writer->open(newpath.string());
         } catch (std::filesystem::filesystem_error& e) {
             std::cout << "move_log() failed to move " << current_log_path << " to " << newpath << std::endl;
             std::cout << e.what() << std::endl;
+            // Logging goes on where the file is now.
+            std::string path = renamed ? newpath.string() : current_log_path.string();
+            if (!path.empty())
+                old_writer->open(path);
+            resume(old_writer, path);
             throw;
         }
+        resume(new_writer, newpath.string());
     }
 
     // This can't be a variadic template due to wanting it in the interface base class, so we use the old ... notation.
     void Logger::log(log_level level, const char* format, ...) {
-        std::stringstream logger_stream;
-        std::string log_level = log_level_names_[level];
-
-        std::string message;
+        bool output = LogFilter::is_enabled(level, nullptr);
+        bool sinks = !output && LogFilter::reaches_sinks(level);
+        if (!output && !sinks && !LogFilter::is_recorded(level))
+            return;
+        RecordOnlyScope record_only(!output && !sinks);
+        SinksOnlyScope sinks_only(sinks);
         va_list argptr;
         va_start(argptr, format);
-        StringUtils::string_vprintf(message, format, argptr);
+        vlog(level, format, argptr);
         va_end(argptr);
+    }
+
+    namespace {
+        const char* level_name(log_level level) {
+            switch (level) {
+                case log_level::DEBUG:
+                    return "DD";
+                case log_level::INFO:
+                    return "II";
+                case log_level::WARNING:
+                    return "WW";
+                case log_level::ERROR:
+                    return "EE";
+                default:
+                    return "";
+            }
+        }
+
+        // The limiter logs its summary while the message that ended the
+        // repeats is still in the buffer, so one nested line gets its own.
+        thread_local char line_buffers[2][Logger::line_buffer_size];
+        thread_local size_t line_depth = 0;
 
-        logger_stream << rpp::ClockAccessor::GetInstance()->datetime_compact_string() << ", "
-        << log_level << ", " << application_name_  << ", 0x" << std::hex << pthread_self() << std::dec << ", "
-        << message << std::endl;
+        class LineBuffer
         {
+        public:
+            LineBuffer() : line(line_buffers[std::min(line_depth++, static_cast<size_t>(1))]) {
+            }
+            ~LineBuffer() { line_depth--; }
+            LineBuffer(const LineBuffer&) = delete;
+            LineBuffer& operator=(const LineBuffer&) = delete;
+
+            char* const line;
+        };
+        thread_local LogBuffer record_buffer;
+
+        char* append(char* p, const char* end, std::string_view text) {
+            size_t n = std::min(text.size(), static_cast<size_t>(end - p));
+            memcpy(p, text.data(), n);
+            return p + n;
+        }
+    }
+
+    // The line is assembled in a thread local buffer. Only a message that
+    // does not fit is formatted again into a std::string.
+    void Logger::vlog(log_level level, const char* format, va_list ap) {
+        if (record_format_.load(std::memory_order_relaxed) != log_record_format::TEXT) {
+            std::string message;
+            StringUtils::string_vprintf(message, format, ap);
+            log_message(level, message);
+            return;
+        }
+        LineBuffer buffer;
+        char* line = buffer.line;
+
+        size_t prefix = format_prefix(line, line_buffer_size, level);
+        va_list ap_copy;
+        va_copy(ap_copy, ap);
+        int result = vsnprintf(line + prefix, line_buffer_size - prefix, format, ap);
+        auto length = static_cast<size_t>(std::max(result, 0));
+
+        if (prefix + length + 1 < line_buffer_size) {
+            line[prefix + length] = '\n';
+            if (!LogLimiter::is_repeat(std::string_view(line + prefix, length)))
+                write_line(level, std::string_view(line, prefix + length + 1));
+        } else {
+            std::string large(line, prefix);
+            large.resize(prefix + length + 1);
+            vsnprintf(&large[prefix], length + 1, format, ap_copy);
+            large[prefix + length] = '\n';
+            if (!LogLimiter::is_repeat(std::string_view(large).substr(prefix, length)))
+                write_line(level, large);
+        }
+        va_end(ap_copy);
+    }
+
+    void Logger::log_message(log_level level, std::string_view message) {
+        if (LogLimiter::is_repeat(message))
+            return;
+        if (record_format_.load(std::memory_order_relaxed) != log_record_format::TEXT) {
+            LogRecord record;
+            record.level = level;
+            record.message = message;
+            log_record(record);
+            return;
+        }
+        LineBuffer buffer;
+        char* line = buffer.line;
+        size_t prefix = format_prefix(line, line_buffer_size, level);
+
+        if (prefix + message.size() + 1 < line_buffer_size) {
+            memcpy(line + prefix, message.data(), message.size());
+            line[prefix + message.size()] = '\n';
+            write_line(level, std::string_view(line, prefix + message.size() + 1));
+        } else {
+            std::string large(line, prefix);
+            large.append(message);
+            large.push_back('\n');
+            write_line(level, large);
+        }
+    }
+
+    void Logger::log_kv(log_level level, std::initializer_list<LogField> event_and_fields) {
+        LogRecord record;
+        record.level = level;
+        if (event_and_fields.size() > 0) {
+            record.event = event_and_fields.begin()->key();
+            record.fields = event_and_fields.begin() + 1;
+            record.field_count = event_and_fields.size() - 1;
+        }
+        if (LogLimiter::checking()) {
+            LogBuffer& body = record_buffer;
+            body.clear();
+            encode_text_body(record, body);
+            if (LogLimiter::is_repeat(body.view()))
+                return;
+        }
+        log_record(record);
+    }
+
+    void Logger::log_record(const LogRecord& record) {
+        LogBuffer& out = record_buffer;
+        out.clear();
+        switch (record_format_.load(std::memory_order_relaxed)) {
+            case log_record_format::JSON_LINES:
+            case log_record_format::BINARY: {
+                LogRecord complete = record;
+                complete.timestamp = rpp::ClockAccessor::GetInstance()->timestamp();
+                complete.thread = ThreadIdentity::current().field();
+                complete.application = application_name_;
+                if (record_format_.load(std::memory_order_relaxed) == log_record_format::JSON_LINES)
+                    encode_json_line(complete, out);
+                else
+                    encode_binary_record(complete, out);
+                break;
+            }
+            case log_record_format::TEXT:
+            default: {
+                LineBuffer buffer;
+                char* line = buffer.line;
+                out.append(line, format_prefix(line, line_buffer_size, record.level));
+                encode_text_body(record, out);
+                out.append(1, '\n');
+                break;
+            }
+        }
+        write_line(record.level, out.view());
+    }
+
+    // Writes "DTC, LL, app, THREAD, " and returns its length. Leaves room
+    // for at least a short message in a line_buffer_size buffer.
+    size_t Logger::format_prefix(char* line, size_t size, log_level level) {
+        static constexpr size_t max_application_name = 256;
+        char* p = line;
+        char* const end = line + size;
+
+        p += rpp::ClockAccessor::GetInstance()->datetime_compact(p, size);
+        p = append(p, end, ", ");
+        p = append(p, end, level_name(level));
+        p = append(p, end, ", ");
+        p = append(p, end, std::string_view(application_name_).substr(0, max_application_name));
+        p = append(p, end, ", ");
+        p = append(p, end, ThreadIdentity::current().field());
+        p = append(p, end, ", ");
+        return static_cast<size_t>(p - line);
+    }
+
+    // The sinks get the line before staging, which has queues of its own.
+    void Logger::write_line(log_level level, std::string_view line) {
+        if (recording_.load(std::memory_order_acquire)) {
+            auto recorder = std::atomic_load(&recorder_);
+            if (recorder != nullptr)
+                recorder->record(line);
+        }
+        if (RecordOnlyScope::active())
+            return;
+        if (!sinks_.empty())
+            sinks_.publish(level, line);
+        if (SinksOnlyScope::active())
+            return;
+        LogStaging* staging = staging_.load(std::memory_order_acquire);
+        bool sync = (level == log_level::ERROR && sync_errors_.load(std::memory_order_relaxed));
+        if (staging != nullptr) {
+            staging->append(line);
+            if (sync)
+                staging->sync();
+        } else {
             std::scoped_lock lock(log_mutex_);
-            logWriter_->write(logger_stream.str());
+            logWriter_->write_line(line);
+            if (sync)
+                logWriter_->sync();
         }
     }
 
@@ -80,12 +356,19 @@ namespace rpp
 
     void Logger::log_to_file(const std::string &log_path)
     {
-        std::scoped_lock lock(log_mutex_);
+        std::scoped_lock lock(switch_mutex_, log_mutex_);
         filename_ = log_path;
         log(log_level::INFO, "Changing log to '%s'", log_path.c_str());
+        detach_writer();
         logWriter_->close();
-        logWriter_ = logWriterFactory_->create_file_writer();
+        open_file_writer(log_path);
+    }
+
+    // Called with log_mutex_ held, once the old writer is closed.
+    void Logger::open_file_writer(const std::string& log_path) {
+        logWriter_ = wrap_writer(create_file_writer());
         logWriter_->open(log_path);
+        replace_writer(logWriter_);
     }
 
     void Logger::set_application_name(std::string_view application_name) {
@@ -94,11 +377,182 @@ namespace rpp
     }
 
     void Logger::log_to_console(){
-        std::scoped_lock lock(log_mutex_);
+        std::scoped_lock lock(switch_mutex_, log_mutex_);
         filename_ = "";
         log(log_level::INFO, "Changing log to console");
+        detach_writer();
         logWriter_->close();
-        logWriter_ = logWriterFactory_->create_console_writer();
+        replace_writer(wrap_writer(logWriterFactory_->create_console_writer()));
+    }
+
+    void Logger::set_async(size_t queue_capacity, log_overflow_policy policy) {
+        std::scoped_lock lock(switch_mutex_, log_mutex_);
+        set_sync();
+        async_ = true;
+        async_capacity_ = queue_capacity;
+        async_policy_ = policy;
+        replace_writer(wrap_writer(logWriter_));
+    }
+
+    void Logger::set_sync() {
+        std::scoped_lock lock(switch_mutex_, log_mutex_);
+        if (async_) {
+            auto asyncWriter = std::static_pointer_cast<AsyncLogWriter>(logWriter_);
+            replace_writer(asyncWriter->writer());
+            asyncWriter->flush();
+            async_ = false;
+        }
+    }
+
+    void Logger::flush() {
+        std::scoped_lock lock(log_mutex_);
+        LogLimiter::flush();
+        LogStaging* staging = staging_.load(std::memory_order_acquire);
+        if (staging != nullptr)
+            staging->flush();
+        // During move_log() the writer is the one that holds the lines.
+        auto asyncWriter = std::dynamic_pointer_cast<AsyncLogWriter>(logWriter_);
+        if (asyncWriter)
+            asyncWriter->flush();
+        sinks_.flush();
+    }
+
+    void Logger::set_staging(size_t buffer_size, std::chrono::milliseconds flush_interval) {
+        std::scoped_lock lock(switch_mutex_, log_mutex_);
+        clear_staging();
+        if (staging_instance_)
+            staging_instance_->start(buffer_size, flush_interval);
+        else
+            staging_instance_ = std::make_unique<LogStaging>(buffer_size, flush_interval);
+        staging_instance_->set_writer(logWriter_);
+        staging_.store(staging_instance_.get(), std::memory_order_release);
+    }
+
+    // The staged lines are written out and the staging lets go of the
+    // writer, which may be closed or replaced from now on. A line that a
+    // thread still appends is kept until staging is turned on again.
+    void Logger::clear_staging() {
+        std::scoped_lock lock(switch_mutex_, log_mutex_);
+        LogStaging* staging = staging_.exchange(nullptr);
+        if (staging != nullptr) {
+            staging->set_writer(nullptr);
+            staging->stop();
+        }
+    }
+
+    void Logger::set_file_writer_type(file_writer_type type) {
+        std::scoped_lock lock(log_mutex_);
+        file_writer_type_ = type;
+    }
+
+    void Logger::set_record_format(log_record_format format) {
+        record_format_.store(format, std::memory_order_relaxed);
+    }
+
+    void Logger::add_sink(std::string_view name, const std::shared_ptr<ILogWriter>& writer, log_level level,
+                          size_t queue_capacity, log_overflow_policy policy) {
+        sinks_.add(std::make_shared<LogSink>(name, writer, level, queue_capacity, policy));
+        update_sink_level();
+    }
+
+    bool Logger::remove_sink(std::string_view name) {
+        bool removed = sinks_.remove(name);
+        update_sink_level();
+        return removed;
+    }
+
+    bool Logger::set_sink_level(std::string_view name, log_level level) {
+        bool changed = sinks_.set_level(name, level);
+        update_sink_level();
+        return changed;
+    }
+
+    // Messages are formatted down to the lowest sink level.
+    void Logger::update_sink_level() {
+        std::scoped_lock lock(log_mutex_);
+        log_level level;
+        if (sinks_.min_level(level))
+            LogFilter::set_sink_level(level);
+        else
+            LogFilter::clear_sink_level();
+    }
+
+    void Logger::set_flight_recorder(const std::string& path, size_t size, log_level level) {
+        std::scoped_lock lock(log_mutex_);
+        std::atomic_store(&recorder_, std::make_shared<FlightRecorder>(path, size));
+        recording_.store(true, std::memory_order_release);
+        LogFilter::set_record_level(level);
+    }
+
+    // The old recorder is unmapped once the last thread recording into it
+    // lets go of it.
+    void Logger::clear_flight_recorder() {
+        std::scoped_lock lock(log_mutex_);
+        LogFilter::clear_record_level();
+        recording_.store(false, std::memory_order_release);
+        std::atomic_store(&recorder_, std::shared_ptr<FlightRecorder>());
+    }
+
+    void Logger::set_rotation(const log_rotation_policy& policy) {
+        std::scoped_lock lock(switch_mutex_, log_mutex_);
+        rotation_ = policy;
+        if (!filename_.empty())
+            log_to_file(filename_);
+    }
+
+    void Logger::set_durability(const log_durability_policy& policy) {
+        std::scoped_lock lock(switch_mutex_, log_mutex_);
+        durability_ = policy;
+        sync_errors_.store(policy.mode != log_durability::LINE, std::memory_order_relaxed);
+        if (!filename_.empty())
+            log_to_file(filename_);
+    }
+
+    std::shared_ptr<ILogWriter> Logger::create_file_writer() {
+        if (!rotation_.enabled())
+            return create_file_writer(logWriterFactory_, file_writer_type_, durability_);
+        return std::make_shared<RotatingLogWriter>(
+                [factory = logWriterFactory_, type = file_writer_type_, durability = durability_]() {
+                    return create_file_writer(factory, type, durability);
+                }, rotation_);
+    }
+
+    std::shared_ptr<ILogWriter> Logger::create_file_writer(const std::shared_ptr<ILogWriterFactory>& factory,
+                                                           file_writer_type type,
+                                                           const log_durability_policy& durability) {
+        switch (type) {
+            case file_writer_type::FD:
+                return factory->create_fd_file_writer();
+            case file_writer_type::MMAP:
+                return factory->create_mmap_file_writer();
+            case file_writer_type::URING:
+                return factory->create_uring_file_writer();
+            case file_writer_type::STREAM:
+            default:
+                if (durability.mode == log_durability::LINE)
+                    return factory->create_file_writer();
+                return factory->create_durable_file_writer(durability);
+        }
+    }
+
+    // Writes out the staged lines and holds new ones until replace_writer().
+    void Logger::detach_writer() {
+        LogStaging* staging = staging_.load(std::memory_order_acquire);
+        if (staging != nullptr)
+            staging->set_writer(nullptr);
+    }
+
+    void Logger::replace_writer(const std::shared_ptr<ILogWriter>& writer) {
+        logWriter_ = writer;
+        LogStaging* staging = staging_.load(std::memory_order_acquire);
+        if (staging != nullptr)
+            staging->set_writer(writer);
+    }
+
+    std::shared_ptr<ILogWriter> Logger::wrap_writer(const std::shared_ptr<ILogWriter>& writer) {
+        if (!async_)
+            return writer;
+        return std::make_shared<AsyncLogWriter>(writer, async_capacity_, async_policy_);
     }
 
 
@@ -110,15 +564,20 @@ int log_init()
     return 0;
 }
 
-// TBD - to remove..
+// Drains any queued messages before falling back to a synchronous console log.
 void log_cleanup()
 {
-    rpp::Logger::Instance()->log_to_console();
+    auto logger = rpp::Logger::Instance();
+    logger->flush();
+    logger->log_to_console();
+    logger->clear_staging();
+    logger->set_sync();
 }
 
 void log_set_application(std::string_view application_name)
 {
     rpp::Logger::Instance()->set_application_name(application_name);
+    rpp::BinaryLog::Instance().set_application_name(application_name);
 }
 
 int log_set_file(const std::string &path)
@@ -137,7 +596,120 @@ void log_set_console()
     rpp::Logger::Instance()->log_to_console();
 }
 
+void log_set_writer_factory(const std::shared_ptr<rpp::ILogWriterFactory>& factory)
+{
+    rpp::Logger::set_writer_factory(factory);
+}
+
 void log_move(std::filesystem::path newpath)
 {
     rpp::Logger::Instance()->move_log(newpath);
-}
\ No newline at end of file
+}
+
+void log_set_async(size_t queue_capacity, rpp::log_overflow_policy policy)
+{
+    rpp::Logger::Instance()->set_async(queue_capacity, policy);
+}
+
+void log_set_sync()
+{
+    rpp::Logger::Instance()->set_sync();
+}
+
+void log_flush()
+{
+    rpp::Logger::Instance()->flush();
+}
+
+void log_set_staging(size_t buffer_size, std::chrono::milliseconds flush_interval)
+{
+    rpp::Logger::Instance()->set_staging(buffer_size, flush_interval);
+}
+
+void log_clear_staging()
+{
+    rpp::Logger::Instance()->clear_staging();
+}
+
+void log_set_file_writer_type(rpp::file_writer_type type)
+{
+    rpp::Logger::Instance()->set_file_writer_type(type);
+}
+
+void log_set_rotation(const rpp::log_rotation_policy& policy)
+{
+    rpp::Logger::Instance()->set_rotation(policy);
+}
+
+void log_set_durability(const rpp::log_durability_policy& policy)
+{
+    rpp::Logger::Instance()->set_durability(policy);
+}
+
+void log_set_record_format(rpp::log_record_format format)
+{
+    rpp::Logger::Instance()->set_record_format(format);
+}
+
+void log_add_sink(std::string_view name, const std::shared_ptr<rpp::ILogWriter>& writer, rpp::log_level level,
+                  size_t queue_capacity, rpp::log_overflow_policy policy)
+{
+    rpp::Logger::Instance()->add_sink(name, writer, level, queue_capacity, policy);
+}
+
+bool log_remove_sink(std::string_view name)
+{
+    return rpp::Logger::Instance()->remove_sink(name);
+}
+
+bool log_set_sink_level(std::string_view name, rpp::log_level level)
+{
+    return rpp::Logger::Instance()->set_sink_level(name, level);
+}
+
+void log_set_flight_recorder(const std::string& path, size_t size, rpp::log_level level)
+{
+    rpp::Logger::Instance()->set_flight_recorder(path, size, level);
+}
+
+void log_clear_flight_recorder()
+{
+    rpp::Logger::Instance()->clear_flight_recorder();
+}
+
+void log_set_rate_limit(double messages_per_second, size_t burst)
+{
+    rpp::LogLimiter::set_rate_limit(messages_per_second, burst);
+}
+
+void log_set_deduplication(std::chrono::milliseconds window)
+{
+    rpp::LogLimiter::set_deduplication(window);
+}
+
+void log_set_level(rpp::log_level level)
+{
+    rpp::LogFilter::set_min_level(level);
+}
+
+void log_set_category_level(std::string_view category, rpp::log_level level)
+{
+    rpp::LogFilter::set_category_level(category, level);
+}
+
+namespace rpp
+{
+    void log_unfiltered(log_level level, const char* format, ...)
+    {
+        va_list argptr;
+        va_start(argptr, format);
+        Logger::Instance()->vlog(level, format, argptr);
+        va_end(argptr);
+    }
+
+    StringUtils::FormatBuffer<Logger::line_buffer_size>& log_format_buffer()
+    {
+        thread_local StringUtils::FormatBuffer<Logger::line_buffer_size> buffer;
+        return buffer;
+    }
+}
@@ -0,0 +1,241 @@
+#include <algorithm>
+#include <iostream>
+#include <tuple>
+#include "RotatingLogWriter.h"
+#include "ClockAccessor.h"
+
+namespace rpp {
+
+    RotatingLogWriter::RotatingLogWriter(std::function<std::shared_ptr<ILogWriter>()> create_writer,
+                                         log_rotation_policy policy)
+            : create_writer_(std::move(create_writer)), policy_(std::move(policy)), path_(), next_path_(),
+              writer_(), bytes_(0), next_rotation_(0.0), next_index_(1), retired_mutex_(), retired_ready_(),
+              retired_done_(), retired_(), next_(), preparing_(false), busy_(false), quit_(false), thread_() {
+        thread_ = std::thread(&RotatingLogWriter::run, this);
+    }
+
+    RotatingLogWriter::~RotatingLogWriter() {
+        close();
+        {
+            std::scoped_lock lock(retired_mutex_);
+            quit_ = true;
+        }
+        retired_ready_.notify_one();
+        thread_.join();
+    }
+
+    void RotatingLogWriter::open(std::string_view name) {
+        close();
+        path_ = name;
+        next_path_ = path_;
+        next_path_ += ".next";
+
+        // Measured before the writer opens the file: an MmapLogWriter extends
+        // it to a whole segment.
+        std::error_code error;
+        auto size = std::filesystem::file_size(path_, error);
+        bytes_ = error ? 0 : size;
+        writer_ = create_writer_();
+        writer_->open(name);
+
+        auto rotated = rotated_files(path_);
+        next_index_ = rotated.empty() ? 1 : rotated.back().first + 1;
+        if (policy_.interval.count() > 0)
+            next_rotation_ = ClockAccessor::GetInstance()->time() + static_cast<double>(policy_.interval.count());
+        {
+            std::scoped_lock lock(retired_mutex_);
+            preparing_ = true;
+        }
+        retired_ready_.notify_one();
+    }
+
+    void RotatingLogWriter::close() {
+        flush();
+        std::shared_ptr<ILogWriter> next;
+        {
+            std::scoped_lock lock(retired_mutex_);
+            next = std::move(next_);
+            next_ = nullptr;
+        }
+        if (next) {
+            next->close();
+            std::error_code error;
+            std::filesystem::remove(next_path_, error);
+        }
+        if (writer_) {
+            writer_->close();
+            writer_ = nullptr;
+        }
+    }
+
+    void RotatingLogWriter::write(const std::string &message) {
+        if (writer_) {
+            writer_->write(message);
+            written(message.size());
+        }
+    }
+
+    void RotatingLogWriter::write_line(std::string_view line) {
+        if (writer_) {
+            writer_->write_line(line);
+            written(line.size());
+        }
+    }
+
+    void RotatingLogWriter::write_batch(const std::vector<std::string_view>& chunks) {
+        if (writer_) {
+            writer_->write_batch(chunks);
+            uint64_t bytes = 0;
+            for (auto chunk : chunks)
+                bytes += chunk.size();
+            written(bytes);
+        }
+    }
+
+    void RotatingLogWriter::sync() {
+        if (writer_)
+            writer_->sync();
+    }
+
+    void RotatingLogWriter::written(uint64_t bytes) {
+        bytes_ += bytes;
+        if (policy_.max_bytes > 0 && bytes_ >= policy_.max_bytes) {
+            rotate();
+        } else if (policy_.interval.count() > 0 && ClockAccessor::GetInstance()->time() >= next_rotation_) {
+            rotate();
+        }
+    }
+
+    // Only swaps the writers: the files are renamed on the background
+    // thread. The writers hold their files open, so the lines go to the
+    // right file whatever the names are at the time.
+    void RotatingLogWriter::rotate() {
+        if (!writer_)
+            return;
+        bytes_ = 0;
+        if (policy_.interval.count() > 0)
+            next_rotation_ = ClockAccessor::GetInstance()->time() + static_cast<double>(policy_.interval.count());
+
+        {
+            std::unique_lock lock(retired_mutex_);
+            retired_done_.wait(lock, [this] { return !preparing_; });
+            preparing_ = true;
+            if (next_) {
+                std::filesystem::path rotated = path_;
+                rotated += "." + std::to_string(next_index_++);
+                retired_.emplace_back(std::exchange(writer_, std::move(next_)), std::move(rotated));
+            }
+        }
+        retired_ready_.notify_one();
+    }
+
+    void RotatingLogWriter::flush() {
+        std::unique_lock lock(retired_mutex_);
+        retired_done_.wait(lock, [this] { return retired_.empty() && !busy_ && !preparing_; });
+    }
+
+    std::vector<std::pair<uint64_t, std::filesystem::path>>
+    RotatingLogWriter::rotated_files(const std::filesystem::path& path) {
+        std::vector<std::pair<uint64_t, std::filesystem::path>> files;
+        std::filesystem::path directory = path.parent_path();
+        if (directory.empty())
+            directory = ".";
+        std::string prefix = path.filename().string() + ".";
+
+        std::error_code error;
+        for (const auto& entry : std::filesystem::directory_iterator(directory, error)) {
+            std::string name = entry.path().filename().string();
+            if (name.size() <= prefix.size() || name.compare(0, prefix.size(), prefix) != 0)
+                continue;
+            size_t end = prefix.size();
+            while (end < name.size() && isdigit(static_cast<unsigned char>(name[end])))
+                end++;
+            if (end == prefix.size())
+                continue;
+            // Archived copies such as "log.txt.3.gz" count as rotation 3.
+            if (end < name.size() && name[end] != '.')
+                continue;
+            uint64_t index = std::stoull(name.substr(prefix.size(), end - prefix.size()));
+            files.emplace_back(index, entry.path());
+        }
+        std::sort(files.begin(), files.end());
+        return files;
+    }
+
+    // Sets next_ to a writer open at next_path_, or to nullptr if it could
+    // not be opened, in which case the next rotation tries again.
+    void RotatingLogWriter::prepare_next() {
+        std::shared_ptr<ILogWriter> next;
+        try {
+            std::error_code error;
+            std::filesystem::remove(next_path_, error);
+            next = create_writer_();
+            next->open(next_path_.string());
+        } catch (const std::exception& e) {
+            std::cout << "RotatingLogWriter failed to open " << next_path_ << ": " << e.what() << std::endl;
+            next = nullptr;
+        }
+        {
+            std::scoped_lock lock(retired_mutex_);
+            next_ = std::move(next);
+            preparing_ = false;
+        }
+        retired_done_.notify_all();
+    }
+
+    // The next writer is opened as soon as the files are renamed, before the
+    // old writer is closed and archived, which may take a while.
+    void RotatingLogWriter::run() {
+        std::unique_lock lock(retired_mutex_);
+        while (true) {
+            retired_ready_.wait(lock, [this] { return !retired_.empty() || preparing_ || quit_; });
+            if (quit_ && retired_.empty())
+                break;
+            std::shared_ptr<ILogWriter> writer;
+            std::filesystem::path path;
+            if (!retired_.empty()) {
+                std::tie(writer, path) = std::move(retired_.front());
+                retired_.pop_front();
+            }
+            bool prepare = preparing_;
+            busy_ = true;
+            lock.unlock();
+
+            if (writer) {
+                std::error_code error;
+                std::filesystem::rename(path_, path, error);
+                if (error)
+                    std::cout << "RotatingLogWriter failed to rename " << path_ << ": " << error.message() << std::endl;
+                std::filesystem::rename(next_path_, path_, error);
+                if (error)
+                    std::cout << "RotatingLogWriter failed to rename " << next_path_ << ": " << error.message() << std::endl;
+            }
+            if (prepare)
+                prepare_next();
+            if (writer)
+                retire(std::move(writer), path);
+
+            lock.lock();
+            busy_ = false;
+            retired_done_.notify_all();
+        }
+    }
+
+    void RotatingLogWriter::retire(std::shared_ptr<ILogWriter> writer, const std::filesystem::path& path) {
+        writer->close();
+        writer = nullptr;
+        if (policy_.archiver) {
+            try {
+                policy_.archiver(path);
+            } catch (const std::exception& e) {
+                std::cout << "RotatingLogWriter failed to archive " << path << ": " << e.what() << std::endl;
+            }
+        }
+        auto rotated = rotated_files(std::filesystem::path(path).replace_extension());
+        size_t excess = rotated.size() > policy_.keep ? rotated.size() - policy_.keep : 0;
+        for (size_t i = 0; i < excess; i++) {
+            std::error_code error;
+            std::filesystem::remove(rotated[i].second, error);
+        }
+    }
+}
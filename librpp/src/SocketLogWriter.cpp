@@ -0,0 +1,245 @@
+#include <algorithm>
+#include <cerrno>
+#include <stdexcept>
+#include <sys/un.h>
+#include "SocketLogWriter.h"
+#include "StringUtils.h"
+
+namespace rpp {
+
+    namespace {
+        bool make_address(const std::string& path, sockaddr_un& address) {
+            address = sockaddr_un{};
+            address.sun_family = AF_UNIX;
+            if (path.empty() || path.size() >= sizeof(address.sun_path))
+                return false;
+            path.copy(address.sun_path, path.size());
+            return true;
+        }
+
+        uint64_t count_lines(std::string_view text) {
+            return static_cast<uint64_t>(std::count(text.begin(), text.end(), '\n'));
+        }
+    }
+
+    SocketLogWriter::SocketLogWriter(const std::shared_ptr<ILinux>& linux, size_t packet_size)
+            : linux_(linux), packet_size_(std::clamp(packet_size, static_cast<size_t>(1), max_packet_size)),
+              path_(), fd_(-1),
+              packet_(), dropped_(0), reported_dropped_(0), next_connect_() {
+        packet_.reserve(packet_size_);
+    }
+
+    SocketLogWriter::~SocketLogWriter() {
+        close();
+    }
+
+    void SocketLogWriter::open(std::string_view name) {
+        close();
+        path_ = name;
+        next_connect_ = std::chrono::steady_clock::time_point();
+        connect();
+    }
+
+    void SocketLogWriter::close() {
+        disconnect();
+        path_.clear();
+    }
+
+    void SocketLogWriter::write(const std::string& message) {
+        append(message);
+        send_packet();
+    }
+
+    void SocketLogWriter::write_line(std::string_view line) {
+        append(line);
+        send_packet();
+    }
+
+    void SocketLogWriter::write_batch(const std::vector<std::string_view>& chunks) {
+        for (auto chunk : chunks)
+            append(chunk);
+        send_packet();
+    }
+
+    bool SocketLogWriter::connected() const {
+        return fd_ >= 0;
+    }
+
+    uint64_t SocketLogWriter::dropped() const {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+
+    // Fills packets with whole lines. A line longer than a packet is sent
+    // on its own. A line longer than max_packet_size, which the collector
+    // cannot receive whole, is dropped and counted.
+    void SocketLogWriter::append(std::string_view lines) {
+        while (!lines.empty()) {
+            size_t room = packet_size_ - packet_.size();
+            if (lines.size() <= room) {
+                packet_.append(lines);
+                return;
+            }
+            size_t end = (room > 0) ? lines.rfind('\n', room - 1) : std::string_view::npos;
+            if (end == std::string_view::npos && packet_.empty()) {
+                end = std::min(lines.find('\n'), lines.size() - 1);
+                if (end >= max_packet_size) {
+                    dropped_.fetch_add(1, std::memory_order_relaxed);
+                    lines.remove_prefix(end + 1);
+                    continue;
+                }
+            }
+            if (end != std::string_view::npos) {
+                packet_.append(lines.substr(0, end + 1));
+                lines.remove_prefix(end + 1);
+            }
+            send_packet();
+        }
+    }
+
+    void SocketLogWriter::send_packet() {
+        if (packet_.empty())
+            return;
+        uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+        if (dropped != reported_dropped_ && connected()) {
+            auto report = StringUtils::string_format("SocketLogWriter dropped %llu log records\n",
+                                                     static_cast<unsigned long long>(dropped - reported_dropped_));
+            if (send(report))
+                reported_dropped_ = dropped;
+        }
+        if (!send(packet_))
+            dropped_.fetch_add(count_lines(packet_), std::memory_order_relaxed);
+        packet_.clear();
+    }
+
+    bool SocketLogWriter::send(std::string_view packet) {
+        if (!connected() && !connect())
+            return false;
+        ssize_t sent = linux_->send(fd_, packet.data(), packet.size(), MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (sent >= 0)
+            return true;
+        if (errno != EAGAIN && errno != ENOBUFS && errno != EMSGSIZE)
+            disconnect();
+        return false;
+    }
+
+    bool SocketLogWriter::connect() {
+        auto now = std::chrono::steady_clock::now();
+        sockaddr_un address{};
+        if (now < next_connect_ || !make_address(path_, address))
+            return false;
+        next_connect_ = now + reconnect_interval;
+
+        fd_ = linux_->socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fd_ < 0)
+            return false;
+        if (linux_->connect(fd_, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+            disconnect();
+            return false;
+        }
+        return true;
+    }
+
+    void SocketLogWriter::disconnect() {
+        if (fd_ >= 0) {
+            linux_->close(fd_);
+            fd_ = -1;
+        }
+    }
+
+    LogCollector::LogCollector(const std::shared_ptr<ILinux>& linux, const std::shared_ptr<ILogWriter>& writer)
+            : linux_(linux), writer_(writer), path_(), listen_fd_(-1), clients_(), buffer_(max_packet_size), dropped_(0) {
+    }
+
+    LogCollector::~LogCollector() {
+        close();
+    }
+
+    void LogCollector::listen(const std::string& socket_path) {
+        close();
+        sockaddr_un address{};
+        if (!make_address(socket_path, address))
+            throw std::runtime_error("LogCollector: invalid socket path " + socket_path);
+
+        linux_->remove(socket_path.c_str());
+        listen_fd_ = linux_->socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+        if (listen_fd_ < 0)
+            throw std::runtime_error("LogCollector: failed to create a socket");
+        if (linux_->bind(listen_fd_, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0
+            || linux_->listen(listen_fd_, SOMAXCONN) != 0) {
+            close();
+            throw std::runtime_error("LogCollector: failed to listen on " + socket_path);
+        }
+        path_ = socket_path;
+    }
+
+    void LogCollector::close() {
+        for (int fd : clients_)
+            linux_->close(fd);
+        clients_.clear();
+        if (listen_fd_ >= 0) {
+            linux_->close(listen_fd_);
+            listen_fd_ = -1;
+        }
+        if (!path_.empty()) {
+            linux_->remove(path_.c_str());
+            path_.clear();
+        }
+    }
+
+    size_t LogCollector::poll(int timeout_ms) {
+        if (listen_fd_ < 0)
+            return 0;
+        std::vector<pollfd> fds;
+        fds.push_back(pollfd{listen_fd_, POLLIN, 0});
+        for (int fd : clients_)
+            fds.push_back(pollfd{fd, POLLIN, 0});
+        if (linux_->poll(fds.data(), fds.size(), timeout_ms) <= 0)
+            return 0;
+
+        size_t packets = 0;
+        std::vector<int> closed;
+        for (size_t i = 1; i < fds.size(); i++) {
+            if (fds[i].revents == 0)
+                continue;
+            bool eof = false;
+            packets += receive(fds[i].fd, eof);
+            if (eof)
+                closed.push_back(fds[i].fd);
+        }
+        for (int fd : closed) {
+            linux_->close(fd);
+            clients_.erase(std::remove(clients_.begin(), clients_.end(), fd), clients_.end());
+        }
+        if (fds[0].revents & POLLIN)
+            accept();
+        return packets;
+    }
+
+    void LogCollector::accept() {
+        int fd = linux_->accept(listen_fd_, nullptr, nullptr);
+        if (fd >= 0)
+            clients_.push_back(fd);
+    }
+
+    // Reads what the client has queued without blocking. With MSG_TRUNC,
+    // recv() returns the whole size of a packet that did not fit.
+    size_t LogCollector::receive(int fd, bool& closed) {
+        size_t packets = 0;
+        while (true) {
+            ssize_t n = linux_->recv(fd, buffer_.data(), buffer_.size(), MSG_DONTWAIT | MSG_TRUNC);
+            if (n > static_cast<ssize_t>(buffer_.size())) {
+                dropped_++;
+                writer_->write_line(StringUtils::string_format("LogCollector dropped a log packet of %zd bytes\n",
+                                                               n));
+                continue;
+            }
+            if (n > 0) {
+                writer_->write_line(std::string_view(buffer_.data(), static_cast<size_t>(n)));
+                packets++;
+                continue;
+            }
+            closed = (n == 0) || (errno != EAGAIN && errno != EINTR);
+            return packets;
+        }
+    }
+}
@@ -1,5 +1,9 @@
 // http://www.martinbroadhurst.com/how-to-trim-a-stdstring.html
 
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
 #include <string>
 #include "StringUtils.h"
 
@@ -30,15 +34,22 @@ namespace StringUtils
         va_end(ap);
     }
 
+    // Formats into a stack buffer first so that only long output needs a
+    // second vsnprintf pass.
     void string_vprintf(std::string& instring, const char* format, va_list ap)
     {
+        char buffer[512];
         va_list ap_copy;
         va_copy(ap_copy, ap);
-        size_t size = (size_t)std::vsnprintf(nullptr, 0, format, ap);
-        std::vector<char> output(++size, '\0');
-        std::vsnprintf(&output[0], size, format, ap_copy);
+        int result = std::vsnprintf(buffer, sizeof(buffer), format, ap);
+        auto size = static_cast<size_t>(std::max(result, 0));
+        if (size < sizeof(buffer)) {
+            instring.assign(buffer, size);
+        } else {
+            instring.resize(size);
+            std::vsnprintf(&instring[0], size + 1, format, ap_copy);
+        }
         va_end(ap_copy);
-        instring = output.data();
     }
 
     char *rprintf(char *buffer, size_t buflen, const char *format, ...)
@@ -63,4 +74,112 @@ namespace StringUtils
         return buffer;
     }
 
+
+    namespace format
+    {
+        namespace
+        {
+            char* to_upper(char* begin, char* end) {
+                for (char* p = begin; p != end; p++)
+                    *p = static_cast<char>(toupper(static_cast<unsigned char>(*p)));
+                return end;
+            }
+        }
+
+        size_t format_integer(char* buffer, const spec& s, uint64_t magnitude, bool negative, size_t& prefix)
+        {
+            char* p = buffer;
+            if (negative)
+                *p++ = '-';
+            else if ((s.conversion == 'd' || s.conversion == 'i') && s.plus)
+                *p++ = '+';
+            else if ((s.conversion == 'd' || s.conversion == 'i') && s.space)
+                *p++ = ' ';
+
+            int base = 10;
+            if (s.conversion == 'x' || s.conversion == 'X')
+                base = 16;
+            else if (s.conversion == 'o')
+                base = 8;
+            if (base == 16 && s.alternate && magnitude != 0) {
+                *p++ = '0';
+                *p++ = s.conversion;
+            }
+            prefix = static_cast<size_t>(p - buffer);
+
+            char digits[24];
+            size_t count = 0;
+            if (magnitude != 0 || s.precision != 0) {
+                auto converted = std::to_chars(digits, digits + sizeof(digits), magnitude, base);
+                count = static_cast<size_t>(converted.ptr - digits);
+            }
+            if (s.conversion == 'X')
+                to_upper(digits, digits + count);
+
+            size_t zeros = 0;
+            if (s.precision > 0 && static_cast<size_t>(s.precision) > count)
+                zeros = static_cast<size_t>(s.precision) - count;
+            if (base == 8 && s.alternate && zeros == 0 && (count == 0 || digits[0] != '0'))
+                zeros = 1;
+            memset(p, '0', zeros);
+            p += zeros;
+            memcpy(p, digits, count);
+            p += count;
+            return static_cast<size_t>(p - buffer);
+        }
+
+        size_t format_float(char* buffer, const spec& s, double value, size_t& prefix)
+        {
+            char* p = buffer;
+            char* end = buffer + max_number_size;
+            if (!std::signbit(value) && s.plus)
+                *p++ = '+';
+            else if (!std::signbit(value) && s.space)
+                *p++ = ' ';
+            prefix = static_cast<size_t>(p - buffer);
+
+            char lower = static_cast<char>(tolower(static_cast<unsigned char>(s.conversion)));
+            int precision = (s.precision >= 0) ? s.precision : 6;
+            std::to_chars_result converted{};
+            if (lower == 'f') {
+                converted = std::to_chars(p, end, value, std::chars_format::fixed, precision);
+            } else if (lower == 'e') {
+                converted = std::to_chars(p, end, value, std::chars_format::scientific, precision);
+            } else if (lower == 'g') {
+                converted = std::to_chars(p, end, value, std::chars_format::general, std::max(precision, 1));
+            } else {
+                // printf writes "0x1.8p+0" where to_chars writes "1.8p+0".
+                char* digits = p;
+                if (std::isfinite(value)) {
+                    if (std::signbit(value))
+                        *p++ = '-';
+                    *p++ = '0';
+                    *p++ = 'x';
+                    digits = p;
+                    value = std::fabs(value);
+                }
+                if (s.precision >= 0)
+                    converted = std::to_chars(digits, end, value, std::chars_format::hex, s.precision);
+                else
+                    converted = std::to_chars(digits, end, value, std::chars_format::hex);
+                if (p != digits)
+                    prefix = static_cast<size_t>(digits - buffer);
+            }
+            if (converted.ec != std::errc())
+                return 0;
+            p = converted.ptr;
+
+            if (std::isfinite(value) && s.precision == 0 && s.alternate && lower != 'g') {
+                char* exponent = std::find_if(buffer, p, [](char c) { return c == 'e' || c == 'p'; });
+                memmove(exponent + 1, exponent, static_cast<size_t>(p - exponent));
+                *exponent = '.';
+                p++;
+            }
+            if (s.conversion != lower)
+                to_upper(buffer, p);
+            if (std::signbit(value) && std::isfinite(value) && buffer[prefix] == '-')
+                prefix++;
+            return static_cast<size_t>(p - buffer);
+        }
+    }
 }
@@ -0,0 +1,52 @@
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <string>
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include "ThreadIdentity.h"
+
+namespace rpp {
+
+    std::atomic<uint32_t> ThreadIdentity::next_id_(1);
+
+    ThreadIdentity& ThreadIdentity::current() {
+        thread_local ThreadIdentity identity;
+        return identity;
+    }
+
+    ThreadIdentity::ThreadIdentity()
+            : id_(next_id_.fetch_add(1, std::memory_order_relaxed)),
+              tid_(static_cast<pid_t>(syscall(SYS_gettid))), name_(), name_size_(0), field_(), field_size_(0) {
+        format_field();
+    }
+
+    void ThreadIdentity::set_name(std::string_view name) {
+        name_size_ = std::min(name.size(), max_name_size);
+        memcpy(name_, name.data(), name_size_);
+        format_field();
+
+        // The kernel takes at most 15 characters and a terminating zero.
+        std::string kernel_name(name.substr(0, 15));
+        pthread_setname_np(pthread_self(), kernel_name.c_str());
+    }
+
+    void ThreadIdentity::format_field() {
+        char* p = field_;
+        char* const end = field_ + max_field_size;
+        if (name_size_ > 0) {
+            memcpy(p, name_, name_size_);
+            p += name_size_;
+            *p++ = ':';
+        }
+        p = std::to_chars(p, end, id_).ptr;
+        *p++ = ':';
+        p = std::to_chars(p, end, tid_).ptr;
+        field_size_ = static_cast<size_t>(p - field_);
+    }
+
+    void set_thread_name(std::string_view name) {
+        ThreadIdentity::current().set_name(name);
+    }
+}
@@ -11,6 +11,7 @@ namespace rpp {
             MOCK_METHOD(void, open, (std::string_view name), (override));
             MOCK_METHOD(void, close, (), (override));
             MOCK_METHOD(void, write, (const std::string& message), (override));
+            MOCK_METHOD(void, sync, (), (override));
         };
 }
 #pragma GCC diagnostic pop
@@ -10,6 +10,11 @@ namespace rpp {
         public:
             MOCK_METHOD(std::shared_ptr<ILogWriter>, create_console_writer, (), (override));
             MOCK_METHOD(std::shared_ptr<ILogWriter>, create_file_writer, (), (override));
+            MOCK_METHOD(std::shared_ptr<ILogWriter>, create_durable_file_writer, (const log_durability_policy& policy),
+                        (override));
+            MOCK_METHOD(std::shared_ptr<ILogWriter>, create_fd_file_writer, (), (override));
+            MOCK_METHOD(std::shared_ptr<ILogWriter>, create_mmap_file_writer, (), (override));
+            MOCK_METHOD(std::shared_ptr<ILogWriter>, create_uring_file_writer, (), (override));
         };
 }
 #pragma GCC diagnostic pop
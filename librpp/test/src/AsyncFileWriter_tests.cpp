@@ -0,0 +1,117 @@
+#include <string>
+#include "AsyncFileWriter.h"
+#include "FileUtils.h"
+
+#include "gtest/gtest.h"
+
+class AsyncFileWriter_tests : public ::testing::TestWithParam<rpp::async_io_backend>
+{
+protected:
+    AsyncFileWriter_tests() : filename_("asyncfilewriter_test.txt") {
+    }
+
+    ~AsyncFileWriter_tests() override = default;
+
+    void SetUp() override
+    {
+        remove(filename_.c_str());
+    }
+
+    void TearDown() override
+    {
+        remove(filename_.c_str());
+    }
+
+    static std::string make_lines(int count)
+    {
+        std::string lines;
+        for (int i = 0; i < count; i++)
+            lines += "Line " + std::to_string(i) + "\n";
+        return lines;
+    }
+
+    const std::string filename_;
+};
+
+TEST_P(AsyncFileWriter_tests, never_reports_auto_backend)
+{
+    // Arrange
+    rpp::AsyncFileWriter writer(GetParam());
+
+    // Act
+    auto backend = writer.backend();
+
+    // Assert
+    ASSERT_NE(backend, rpp::async_io_backend::AUTO);
+    if (GetParam() == rpp::async_io_backend::THREAD) {
+        ASSERT_EQ(backend, rpp::async_io_backend::THREAD);
+    }
+}
+
+TEST_P(AsyncFileWriter_tests, writes_more_than_all_buffers_in_order)
+{
+    // Arrange
+    rpp::AsyncFileWriter writer(GetParam(), 1024, 4);
+    std::string expected = make_lines(5000);
+
+    // Act
+    writer.open(filename_, false);
+    for (size_t i = 0; i < expected.size(); i += 100)
+        writer.write(expected.data() + i, std::min<size_t>(100, expected.size() - i));
+    writer.flush();
+
+    // Assert
+    ASSERT_GT(expected.size(), 10u * 4u * 1024u);
+    ASSERT_EQ(writer.bytes_written(), expected.size());
+    ASSERT_EQ(writer.errors(), 0u);
+    ASSERT_EQ(FileUtils::TryReadFileAsString(filename_), expected);
+}
+
+TEST_P(AsyncFileWriter_tests, submitted_partial_buffer_is_on_file_after_flush)
+{
+    // Arrange
+    rpp::AsyncFileWriter writer(GetParam());
+
+    // Act
+    writer.open(filename_, false);
+    writer.write("Line1\n", 6);
+    writer.submit();
+    writer.write("Line2\n", 6);
+    writer.flush();
+
+    // Assert
+    ASSERT_EQ(FileUtils::TryReadFileAsString(filename_), "Line1\nLine2\n");
+}
+
+TEST_P(AsyncFileWriter_tests, append_keeps_existing_content)
+{
+    // Arrange
+    rpp::AsyncFileWriter writer(GetParam());
+    FileUtils::TryWriteStringAsFile(filename_, "Line1\n");
+
+    // Act
+    writer.open(filename_, true);
+    writer.write("Line2\n", 6);
+    writer.close();
+    writer.open(filename_, true);
+    writer.write("Line3\n", 6);
+    writer.close();
+
+    // Assert
+    ASSERT_FALSE(writer.is_open());
+    ASSERT_EQ(FileUtils::TryReadFileAsString(filename_), "Line1\nLine2\nLine3\n");
+}
+
+TEST_P(AsyncFileWriter_tests, open_throws_on_bad_path)
+{
+    // Arrange
+    rpp::AsyncFileWriter writer(GetParam());
+
+    // Act
+    // Assert
+    ASSERT_THROW(writer.open("/root/fail/async.txt", false), std::runtime_error);
+    ASSERT_NO_THROW(writer.write("Line\n", 5));
+}
+
+INSTANTIATE_TEST_SUITE_P(backends, AsyncFileWriter_tests,
+                         ::testing::Values(rpp::async_io_backend::AUTO, rpp::async_io_backend::THREAD));
@@ -0,0 +1,203 @@
+#include <string>
+#include <future>
+#include "AsyncLogWriter.h"
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "mock_logwriter.h"
+
+using namespace testing;
+
+class AsyncLogWriter_tests : public ::testing::Test
+{
+protected:
+    AsyncLogWriter_tests() : mockLogWriter(), written(), written_mutex() {
+    }
+
+    ~AsyncLogWriter_tests() override = default;
+
+    void SetUp() override
+    {
+        mockLogWriter = std::make_shared<rpp::MockLogWriter>();
+        written = "";
+    }
+
+    void TearDown() override
+    {
+    }
+
+    void set_write_capture()
+    {
+        EXPECT_CALL(*mockLogWriter, write(_))
+                .WillRepeatedly(Invoke([this](const std::string& message) {
+                    std::scoped_lock lock(written_mutex);
+                    written += message;
+                }));
+    }
+
+    std::shared_ptr<rpp::MockLogWriter> mockLogWriter;
+    std::string written;
+    std::mutex written_mutex;
+};
+
+TEST_F(AsyncLogWriter_tests, flush_writes_all_messages_in_order)
+{
+    // Arrange
+    set_write_capture();
+    rpp::AsyncLogWriter writer(mockLogWriter);
+    std::string expected;
+
+    // Act
+    for (int i = 0; i < 100; i++) {
+        std::string message = std::to_string(i) + "\n";
+        expected += message;
+        writer.write(message);
+    }
+    writer.flush();
+
+    // Assert
+    std::scoped_lock lock(written_mutex);
+    ASSERT_EQ(written, expected);
+}
+
+TEST_F(AsyncLogWriter_tests, destructor_drains_queue)
+{
+    // Arrange
+    set_write_capture();
+
+    // Act
+    {
+        rpp::AsyncLogWriter writer(mockLogWriter);
+        writer.write("Message1\n");
+        writer.write("Message2\n");
+    }
+
+    // Assert
+    ASSERT_EQ(written, "Message1\nMessage2\n");
+}
+
+TEST_F(AsyncLogWriter_tests, open_and_close_forwarded_after_drain)
+{
+    // Arrange
+    set_write_capture();
+    std::string written_at_close;
+    EXPECT_CALL(*mockLogWriter, open(_));
+    EXPECT_CALL(*mockLogWriter, close())
+            .WillOnce(Invoke([this, &written_at_close]() {
+                std::scoped_lock lock(written_mutex);
+                written_at_close = written;
+            }));
+    rpp::AsyncLogWriter writer(mockLogWriter);
+
+    // Act
+    writer.open("log.txt");
+    writer.write("Message\n");
+    writer.close();
+
+    // Assert
+    ASSERT_EQ(written_at_close, "Message\n");
+}
+
+TEST_F(AsyncLogWriter_tests, sync_forwarded_after_queued_messages)
+{
+    // Arrange
+    set_write_capture();
+    std::promise<std::string> written_at_sync;
+    EXPECT_CALL(*mockLogWriter, sync())
+            .WillOnce(Invoke([this, &written_at_sync]() {
+                std::scoped_lock lock(written_mutex);
+                written_at_sync.set_value(written);
+            }));
+    rpp::AsyncLogWriter writer(mockLogWriter);
+
+    // Act
+    writer.write("Message1\n");
+    writer.write("Message2\n");
+    writer.sync();
+
+    // Assert
+    ASSERT_EQ(written_at_sync.get_future().get(), "Message1\nMessage2\n");
+}
+
+TEST_F(AsyncLogWriter_tests, drop_policy_drops_when_queue_full)
+{
+    // Arrange
+    std::promise<void> release;
+    std::shared_future<void> released(release.get_future());
+    std::promise<void> blocked;
+    bool first = true;
+    EXPECT_CALL(*mockLogWriter, write(_))
+            .WillRepeatedly(Invoke([&](const std::string& message) {
+                if (first) {
+                    first = false;
+                    blocked.set_value();
+                    released.wait();
+                }
+                std::scoped_lock lock(written_mutex);
+                written += message;
+            }));
+    rpp::AsyncLogWriter writer(mockLogWriter, 2, rpp::log_overflow_policy::DROP);
+
+    // Act
+    writer.write("A");
+    blocked.get_future().wait();
+    writer.write("B");
+    writer.write("C");
+    writer.write("D");
+    release.set_value();
+    writer.flush();
+
+    // Assert
+    ASSERT_EQ(writer.dropped(), 1u);
+    ASSERT_EQ(written, "ABC");
+}
+
+TEST_F(AsyncLogWriter_tests, count_and_drop_policy_reports_dropped_messages)
+{
+    // Arrange
+    std::promise<void> release;
+    std::shared_future<void> released(release.get_future());
+    std::promise<void> blocked;
+    bool first = true;
+    EXPECT_CALL(*mockLogWriter, write(_))
+            .WillRepeatedly(Invoke([&](const std::string& message) {
+                if (first) {
+                    first = false;
+                    blocked.set_value();
+                    released.wait();
+                }
+                std::scoped_lock lock(written_mutex);
+                written += message;
+            }));
+    rpp::AsyncLogWriter writer(mockLogWriter, 1, rpp::log_overflow_policy::COUNT_AND_DROP);
+
+    // Act
+    writer.write("A\n");
+    blocked.get_future().wait();
+    writer.write("B\n");
+    writer.write("C\n");
+    writer.write("D\n");
+    release.set_value();
+    writer.flush();
+
+    // Assert
+    ASSERT_EQ(writer.dropped(), 2u);
+    ASSERT_THAT(written, HasSubstr("dropped 2 log messages"));
+}
+
+TEST_F(AsyncLogWriter_tests, block_policy_loses_nothing)
+{
+    // Arrange
+    set_write_capture();
+    rpp::AsyncLogWriter writer(mockLogWriter, 4, rpp::log_overflow_policy::BLOCK);
+    const int n_messages = 1000;
+
+    // Act
+    for (int i = 0; i < n_messages; i++)
+        writer.write("x");
+    writer.flush();
+
+    // Assert
+    ASSERT_EQ(writer.dropped(), 0u);
+    ASSERT_EQ(written.size(), (size_t) n_messages);
+}
@@ -0,0 +1,185 @@
+#include <string>
+#include <sstream>
+#include <thread>
+#include "BinaryLog.h"
+#include "Logger.h"
+#include "ThreadIdentity.h"
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "ClockAccessor.h"
+#include "mock_clock.h"
+
+using namespace testing;
+
+class BinaryLog_tests : public ::testing::Test
+{
+protected:
+    BinaryLog_tests() : filename_("binary_log.bin"), mockClock() {
+    }
+
+    ~BinaryLog_tests() override = default;
+
+    void SetUp() override
+    {
+        mockClock = std::make_shared<rpp::MockClock>();
+        EXPECT_CALL(*mockClock, timestamp)
+                .WillRepeatedly(Return(1600000000123000000ull));
+        rpp::ClockAccessor::SetInstance(mockClock);
+        rpp::BinaryLog::Instance().set_application_name("BinaryApp");
+        log_set_binary_file(filename_);
+    }
+
+    void TearDown() override
+    {
+        log_close_binary_file();
+        log_set_level(rpp::log_level::DEBUG);
+        rpp::BinaryLog::Instance().set_application_name("??");
+        rpp::ClockAccessor::SetInstance(nullptr);
+        remove(filename_.c_str());
+    }
+
+    std::string decode_log()
+    {
+        log_close_binary_file();
+        std::ifstream input(filename_, std::ios::in | std::ios::binary);
+        std::stringstream output;
+        rpp::BinaryLogDecoder decoder;
+        decoder.decode(input, output);
+        return output.str();
+    }
+
+    const std::string filename_;
+    std::shared_ptr<rpp::MockClock> mockClock;
+};
+
+TEST_F(BinaryLog_tests, decoded_message_matches_text_log_layout)
+{
+    // Arrange
+    // Act
+    rb_info("motor %d speed %.2f name %s", 42, 3.5, "left");
+    auto actual = decode_log();
+
+    // Assert
+    std::string thread(rpp::ThreadIdentity::current().field());
+    ASSERT_THAT(actual, HasSubstr(", II, BinaryApp, " + thread + ", "));
+    ASSERT_THAT(actual, HasSubstr(", motor 42 speed 3.50 name left\n"));
+}
+
+TEST_F(BinaryLog_tests, decoded_timestamp_has_compact_format)
+{
+    // Arrange
+    // Act
+    rb_warn("warning");
+    auto actual = decode_log();
+
+    // Assert
+    ASSERT_EQ(actual.substr(15, 4), ".123");
+    ASSERT_THAT(actual.substr(19), StartsWith(", WW, "));
+}
+
+TEST_F(BinaryLog_tests, all_argument_types_round_trip)
+{
+    // Arrange
+    std::string name("string");
+    uint64_t big = 18000000000000000000ull;
+    int16_t negative = -12;
+
+    // Act
+    rb_debug("%s %llu %d %c %x %5.1f|%-4s|%%", name, big, negative, 'A', 255u, 2.25f, "ab");
+    auto actual = decode_log();
+
+    // Assert
+    ASSERT_THAT(actual, HasSubstr(", string 18000000000000000000 -12 A ff   2.2|ab  |%\n"));
+}
+
+TEST_F(BinaryLog_tests, disabled_level_is_not_recorded)
+{
+    // Arrange
+    log_set_level(rpp::log_level::INFO);
+
+    // Act
+    rb_debug("hidden %d", 1);
+    rb_err("shown %d", 2);
+    auto actual = decode_log();
+
+    // Assert
+    ASSERT_THAT(actual, Not(HasSubstr("hidden")));
+    ASSERT_THAT(actual, HasSubstr("shown 2"));
+}
+
+TEST_F(BinaryLog_tests, records_from_all_threads_are_written)
+{
+    // Arrange
+    const int n_threads = 4;
+    const int n_logs = 5000;
+    std::vector<std::thread> threads;
+
+    // Act
+    for (int t = 0; t < n_threads; t++) {
+        threads.emplace_back([t]() {
+            for (int i = 0; i < n_logs; i++)
+                rb_info("thread %d line %d", t, i);
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+    auto actual = decode_log();
+
+    // Assert
+    ASSERT_EQ(std::count(actual.begin(), actual.end(), '\n'), n_threads * n_logs);
+    ASSERT_THAT(actual, HasSubstr("thread 3 line 4999\n"));
+}
+
+TEST_F(BinaryLog_tests, buffered_records_are_written_every_flush_interval)
+{
+    // Arrange
+    log_set_binary_file(filename_, std::chrono::milliseconds(10));
+    std::string actual;
+
+    // Act
+    rb_info("waiting for the timer");
+    for (int i = 0; i < 200 && actual.find("waiting for the timer") == std::string::npos; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        std::ifstream input(filename_, std::ios::in | std::ios::binary);
+        std::stringstream output;
+        rpp::BinaryLogDecoder decoder;
+        decoder.decode(input, output);
+        actual = output.str();
+    }
+
+    // Assert
+    ASSERT_THAT(actual, HasSubstr(", waiting for the timer\n"));
+}
+
+TEST_F(BinaryLog_tests, decoder_rejects_text_file)
+{
+    // Arrange
+    std::stringstream input("20200101-000000.000, II, app, 0x1, text");
+    std::stringstream output;
+    rpp::BinaryLogDecoder decoder;
+
+    // Act
+    // Assert
+    ASSERT_THROW(decoder.decode(input, output), std::runtime_error);
+}
+
+TEST_F(BinaryLog_tests, format_message_keeps_unmatched_conversions)
+{
+    // Arrange
+    // Act
+    auto actual = rpp::BinaryLogDecoder::format_message("missing %d", nullptr, 0);
+
+    // Assert
+    ASSERT_EQ(actual, "missing %d");
+}
+
+TEST_F(BinaryLog_tests, format_message_keeps_non_ascii_bytes_after_percent)
+{
+    // Arrange
+    // Act
+    auto actual = rpp::BinaryLogDecoder::format_message("temp 20%\xc2\xb0", nullptr, 0);
+
+    // Assert
+    ASSERT_EQ(actual, "temp 20%\xc2\xb0");
+}
@@ -106,6 +106,25 @@ TEST_F(clock_tests, clock_accessor_returs_clock)
         ASSERT_EQ(actual_string, expected_string);
 }
 
+TEST_F(clock_tests, clock_accessor_set_instance_replaces_published_clock)
+{
+        // Arrange
+        auto published = rpp::ClockAccessor::GetInstance().get();
+        mockClock = std::make_shared<rpp::MockClock>();
+
+        // Act
+        rpp::ClockAccessor::SetInstance(mockClock);
+        auto replaced = rpp::ClockAccessor::GetInstance().get();
+        rpp::ClockAccessor::SetInstance(nullptr);
+        auto recreated = rpp::ClockAccessor::GetInstance().get();
+
+        // Assert
+        ASSERT_NE(published, nullptr);
+        ASSERT_EQ(replaced, mockClock.get());
+        ASSERT_NE(recreated, nullptr);
+        ASSERT_NE(recreated, mockClock.get());
+}
+
 TEST_F(clock_tests, clock_now_returns_time_matches_old_function)
 {
         // Arrange
@@ -187,4 +206,52 @@ TEST_F(clock_tests, clock_sleeps)
         // Assert
         // VERY PROCESSOR DEPENDENT. NOT A GOOD TEST. PLACEHOLDER.
         ASSERT_NEAR(static_cast<double>(duration), expected, NANOSECONDS_IN_SECOND/10);
-}
\ No newline at end of file
+}
+TEST_F(clock_tests, clock_datetime_compact_matches_compact_string)
+{
+        // Arrange
+        rpp::Clock clock;
+        char buffer[rpp::IClock::datetime_compact_size];
+
+        // Act
+        auto length = clock.datetime_compact(buffer, sizeof(buffer));
+        std::string actual(buffer, length);
+        char time[64] = {0};
+        std::string oldstyle = old_clock_datetime_compact(time,64);
+
+        // Assert
+        ASSERT_EQ(length, rpp::IClock::datetime_compact_size - 1);
+        ASSERT_EQ(actual.substr(0, 15), oldstyle);
+        ASSERT_EQ(actual[15], '.');
+        ASSERT_NE(isdigit(actual[18]), 0);
+}
+
+TEST_F(clock_tests, clock_datetime_compact_truncates_to_buffer)
+{
+        // Arrange
+        rpp::Clock clock;
+        char buffer[9];
+
+        // Act
+        auto length = clock.datetime_compact(buffer, sizeof(buffer));
+
+        // Assert
+        ASSERT_EQ(length, 8u);
+        ASSERT_EQ(strlen(buffer), 8u);
+        ASSERT_EQ(std::string(buffer), clock.datetime_compact_string().substr(0, 8));
+}
+
+TEST_F(clock_tests, clock_interface_datetime_compact_uses_compact_string)
+{
+        // Arrange
+        mockClock = std::make_shared<rpp::MockClock>();
+        EXPECT_CALL(*mockClock, datetime_compact_string)
+                        .WillOnce(Return("20240102-030405.678"));
+        char buffer[rpp::IClock::datetime_compact_size];
+
+        // Act
+        auto length = mockClock->datetime_compact(buffer, sizeof(buffer));
+
+        // Assert
+        ASSERT_EQ(std::string(buffer, length), "20240102-030405.678");
+}
@@ -37,6 +37,7 @@ TEST_F(file_utils_tests, write_vector_as_uint8_succeeds)
         // Act
         ASSERT_NO_THROW(FileUtils::TryWriteVectorAsFile(filename, output));
         ASSERT_NO_THROW(FileUtils::TryReadFileAsVector(filename, input));
+        remove(filename);
 
         //Assert
         ASSERT_EQ(output,input);
@@ -57,6 +58,37 @@ TEST_F(file_utils_tests, write_vector_as_uint8_throws_on_fail)
         ASSERT_THROW(FileUtils::TryWriteVectorAsFile(filename, output), std::ostream::failure);
 }
 
+TEST_F(file_utils_tests, write_vector_async_succeeds)
+{
+        // Arrange
+        std::vector<uint8_t> output(200000);
+        for (size_t i = 0; i < output.size(); i++)
+                output[i] = static_cast<uint8_t>(i % 251);
+        std::vector<uint8_t> input{};
+        const char *filename = "uint8_async.vec";
+
+        remove(filename);
+
+        // Act
+        ASSERT_NO_THROW(FileUtils::TryWriteVectorAsFileAsync(filename, output));
+        ASSERT_NO_THROW(FileUtils::TryReadFileAsVector(filename, input));
+        remove(filename);
+
+        //Assert
+        ASSERT_EQ(output,input);
+}
+
+TEST_F(file_utils_tests, write_vector_async_throws_on_fail)
+{
+        // Arrange
+        std::vector<uint8_t> output = {0,1,2,3,4,5};
+        const char *filename = "/root/fail/uint8.vec";
+
+        // Act
+        // Assert
+        ASSERT_THROW(FileUtils::TryWriteVectorAsFileAsync(filename, output), std::runtime_error);
+}
+
 TEST_F(file_utils_tests, read_vector_as_uint8_throws_on_fail)
 {
         // Arrange
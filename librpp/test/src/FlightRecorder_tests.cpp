@@ -0,0 +1,173 @@
+#include <fstream>
+#include <string>
+#include <thread>
+#include "FlightRecorder.h"
+#include "Logger.h"
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "ClockAccessor.h"
+#include "mock_clock.h"
+#include "mock_logwriter.h"
+#include "mock_logwriterfactory.h"
+
+using namespace testing;
+
+namespace rpp {
+    // Defined in Logger_tests.cpp
+    void set_instance(const std::shared_ptr<rpp::ILogWriterFactory>& factory);
+    void clear_instance();
+}
+
+class FlightRecorder_tests : public ::testing::Test
+{
+protected:
+    FlightRecorder_tests() : path_("flight_recorder_test.bin") {
+    }
+
+    ~FlightRecorder_tests() override = default;
+
+    void TearDown() override
+    {
+        std::filesystem::remove(path_);
+    }
+
+    const std::string path_;
+};
+
+TEST_F(FlightRecorder_tests, lines_are_read_back_in_order)
+{
+    // Arrange
+    {
+        rpp::FlightRecorder recorder(path_);
+
+        // Act
+        recorder.record("Line1\n");
+        recorder.record("Line2\n");
+        recorder.record("Line3\n");
+    }
+    auto lines = rpp::FlightRecorder::read_lines(path_);
+
+    // Assert
+    ASSERT_THAT(lines, ElementsAre("Line1", "Line2", "Line3"));
+}
+
+TEST_F(FlightRecorder_tests, wrapped_ring_keeps_the_newest_complete_lines)
+{
+    // Arrange
+    rpp::FlightRecorder recorder(path_, rpp::FlightRecorder::min_size);
+
+    // Act
+    for (int i = 0; i < 1000; i++)
+        recorder.record("Line " + std::to_string(i) + "\n");
+    auto lines = rpp::FlightRecorder::read_lines(path_);
+    auto last = rpp::FlightRecorder::read_lines(path_, 2);
+
+    // Assert
+    ASSERT_GT(recorder.recorded(), recorder.capacity());
+    ASSERT_EQ(lines.back(), "Line 999");
+    ASSERT_EQ(lines.front(), "Line " + std::to_string(1000 - lines.size()));
+    ASSERT_THAT(last, ElementsAre("Line 998", "Line 999"));
+}
+
+TEST_F(FlightRecorder_tests, lines_from_all_threads_are_recorded)
+{
+    // Arrange
+    rpp::FlightRecorder recorder(path_);
+    std::vector<std::thread> threads;
+
+    // Act
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&recorder, t] {
+            for (int i = 0; i < 100; i++)
+                recorder.record("Thread " + std::to_string(t) + " line " + std::to_string(i) + "\n");
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    // Assert
+    ASSERT_EQ(rpp::FlightRecorder::read_lines(path_).size(), 400u);
+}
+
+TEST_F(FlightRecorder_tests, read_throws_on_other_files)
+{
+    // Arrange
+    std::ofstream(path_) << "not a recorder";
+
+    // Act
+    // Assert
+    ASSERT_THROW(rpp::FlightRecorder::read_lines(path_), std::runtime_error);
+}
+
+TEST_F(FlightRecorder_tests, logger_records_levels_filtered_from_the_output)
+{
+    // Arrange
+    auto mockClock = std::make_shared<rpp::MockClock>();
+    auto mockLogWriterFactory = std::make_shared<rpp::MockLogWriterFactory>();
+    auto mockLogWriter = std::make_shared<rpp::MockLogWriter>();
+    std::string log_buffer;
+    rpp::ClockAccessor::SetInstance(mockClock);
+    EXPECT_CALL(*mockClock, datetime_compact_string)
+            .WillRepeatedly(Return("DTC"));
+    EXPECT_CALL(*mockLogWriter, write(_))
+            .WillRepeatedly(Invoke([&log_buffer](const std::string& message) {
+                log_buffer += message;
+            }));
+    EXPECT_CALL(*mockLogWriterFactory, create_console_writer())
+            .WillOnce(Return(mockLogWriter));
+    rpp::set_instance(mockLogWriterFactory);
+    log_set_level(rpp::log_level::INFO);
+    log_set_flight_recorder(path_, rpp::FlightRecorder::min_size);
+
+    // Act
+    r_debug("DebugMessage");
+    r_info("InfoMessage");
+    rpp::Logger::Instance()->log(rpp::log_level::DEBUG, "DirectDebugMessage");
+    auto lines = rpp::FlightRecorder::read_lines(path_);
+    log_clear_flight_recorder();
+    r_debug("AfterClearMessage");
+
+    // Assert
+    ASSERT_THAT(log_buffer, Not(HasSubstr("DebugMessage")));
+    ASSERT_THAT(log_buffer, HasSubstr("InfoMessage"));
+    ASSERT_EQ(lines.size(), 3u);
+    ASSERT_THAT(lines[0], EndsWith("DebugMessage"));
+    ASSERT_THAT(lines[1], EndsWith("InfoMessage"));
+    ASSERT_THAT(lines[2], EndsWith("DirectDebugMessage"));
+    ASSERT_THAT(log_buffer, Not(HasSubstr("AfterClearMessage")));
+
+    log_set_level(rpp::log_level::DEBUG);
+    rpp::ClockAccessor::SetInstance(nullptr);
+    rpp::clear_instance();
+}
+
+TEST_F(FlightRecorder_tests, replaced_and_cleared_recorders_are_unmapped)
+{
+    // Arrange
+    auto mockLogWriterFactory = std::make_shared<rpp::MockLogWriterFactory>();
+    EXPECT_CALL(*mockLogWriterFactory, create_console_writer())
+            .WillOnce(Return(std::make_shared<rpp::MockLogWriter>()));
+    rpp::set_instance(mockLogWriterFactory);
+    auto mappings = [this] {
+        std::ifstream maps("/proc/self/maps");
+        std::string line;
+        size_t count = 0;
+        while (std::getline(maps, line))
+            if (line.find(path_) != std::string::npos)
+                count++;
+        return count;
+    };
+
+    // Act
+    log_set_flight_recorder(path_, rpp::FlightRecorder::min_size);
+    log_set_flight_recorder(path_, rpp::FlightRecorder::min_size);
+    size_t while_set = mappings();
+    log_clear_flight_recorder();
+    size_t after_clear = mappings();
+
+    // Assert
+    ASSERT_EQ(while_set, 1u);
+    ASSERT_EQ(after_clear, 0u);
+    rpp::clear_instance();
+}
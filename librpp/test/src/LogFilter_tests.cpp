@@ -0,0 +1,160 @@
+#include <string>
+#include "Logger.h"
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "ClockAccessor.h"
+#include "mock_clock.h"
+#include "mock_logwriter.h"
+#include "mock_logwriterfactory.h"
+
+using namespace testing;
+
+namespace rpp {
+    // Defined in Logger_tests.cpp
+    void set_instance(const std::shared_ptr<rpp::ILogWriterFactory>& factory);
+    void clear_instance();
+}
+
+class LogFilter_tests : public ::testing::Test
+{
+protected:
+    LogFilter_tests() : mockClock(), mockLogWriterFactory(), mockLogWriter(), log_buffer() {
+    }
+
+    ~LogFilter_tests() override = default;
+
+    void SetUp() override
+    {
+        mockClock = std::make_shared<rpp::MockClock>();
+        mockLogWriterFactory = std::make_shared<rpp::MockLogWriterFactory>();
+        mockLogWriter = std::make_shared<rpp::MockLogWriter>();
+        rpp::ClockAccessor::SetInstance(mockClock);
+        EXPECT_CALL(*mockClock, datetime_compact_string)
+                .WillRepeatedly(Return("DTC"));
+        EXPECT_CALL(*mockLogWriter, write(_))
+                .WillRepeatedly(Invoke([this](const std::string& message) {
+                    log_buffer += message;
+                }));
+        EXPECT_CALL(*mockLogWriterFactory, create_console_writer())
+                .WillOnce(Return(mockLogWriter));
+        rpp::set_instance(mockLogWriterFactory);
+        log_buffer = "";
+    }
+
+    void TearDown() override
+    {
+        log_set_level(rpp::log_level::DEBUG);
+        rpp::LogFilter::clear_category_levels();
+        rpp::ClockAccessor::SetInstance(nullptr);
+        rpp::clear_instance();
+    }
+
+    std::shared_ptr<rpp::MockClock> mockClock;
+    std::shared_ptr<rpp::MockLogWriterFactory> mockLogWriterFactory;
+    std::shared_ptr<rpp::MockLogWriter> mockLogWriter;
+    std::string log_buffer;
+};
+
+TEST_F(LogFilter_tests, all_levels_enabled_by_default)
+{
+    // Arrange
+    // Act
+    r_debug("DebugMessage");
+
+    // Assert
+    ASSERT_THAT(log_buffer, HasSubstr("DebugMessage"));
+}
+
+TEST_F(LogFilter_tests, disabled_level_is_not_logged)
+{
+    // Arrange
+    log_set_level(rpp::log_level::INFO);
+
+    // Act
+    r_debug("DebugMessage");
+    r_info("InfoMessage");
+
+    // Assert
+    ASSERT_THAT(log_buffer, Not(HasSubstr("DebugMessage")));
+    ASSERT_THAT(log_buffer, HasSubstr("InfoMessage"));
+}
+
+TEST_F(LogFilter_tests, disabled_call_does_not_evaluate_arguments)
+{
+    // Arrange
+    log_set_level(rpp::log_level::ERROR);
+    int evaluated = 0;
+
+    // Act
+    r_warn("count %d", ++evaluated);
+
+    // Assert
+    ASSERT_EQ(evaluated, 0);
+    ASSERT_TRUE(log_buffer.empty());
+}
+
+void log_debug_from_same_site(int value)
+{
+    r_debug("SameSite %d", value);
+}
+
+TEST_F(LogFilter_tests, call_site_follows_level_changes)
+{
+    // Arrange
+    // Act
+    log_debug_from_same_site(1);
+    log_set_level(rpp::log_level::WARNING);
+    log_debug_from_same_site(2);
+    log_set_level(rpp::log_level::DEBUG);
+    log_debug_from_same_site(3);
+
+    // Assert
+    ASSERT_THAT(log_buffer, HasSubstr("SameSite 1"));
+    ASSERT_THAT(log_buffer, Not(HasSubstr("SameSite 2")));
+    ASSERT_THAT(log_buffer, HasSubstr("SameSite 3"));
+}
+
+TEST_F(LogFilter_tests, category_level_overrides_min_level)
+{
+    // Arrange
+    static rpp::LogSite motor_site(rpp::log_level::DEBUG, "motor");
+    static rpp::LogSite camera_site(rpp::log_level::DEBUG, "camera");
+    log_set_level(rpp::log_level::WARNING);
+
+    // Act
+    log_set_category_level("motor", rpp::log_level::DEBUG);
+
+    // Assert
+    ASSERT_TRUE(motor_site.enabled());
+    ASSERT_FALSE(camera_site.enabled());
+}
+
+TEST_F(LogFilter_tests, category_level_can_raise_threshold)
+{
+    // Arrange
+    static rpp::LogSite warning_site(rpp::log_level::WARNING, "lidar");
+    static rpp::LogSite error_site(rpp::log_level::ERROR, "lidar");
+    ASSERT_TRUE(warning_site.enabled());
+
+    // Act
+    log_set_category_level("lidar", rpp::log_level::ERROR);
+
+    // Assert
+    ASSERT_FALSE(warning_site.enabled());
+    ASSERT_TRUE(error_site.enabled());
+}
+
+TEST_F(LogFilter_tests, logger_log_respects_min_level)
+{
+    // Arrange
+    log_set_level(rpp::log_level::ERROR);
+
+    // Act
+    rpp::Logger::Instance()->log(rpp::log_level::WARNING, "WarningMessage");
+    rpp::Logger::Instance()->log(rpp::log_level::ERROR, "ErrorMessage");
+
+    // Assert
+    ASSERT_THAT(log_buffer, Not(HasSubstr("WarningMessage")));
+    ASSERT_THAT(log_buffer, HasSubstr("ErrorMessage"));
+}
@@ -0,0 +1,190 @@
+#include <chrono>
+#include <string>
+#include <thread>
+#include "Logger.h"
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "ClockAccessor.h"
+#include "mock_clock.h"
+#include "mock_logwriter.h"
+#include "mock_logwriterfactory.h"
+
+using namespace testing;
+
+namespace rpp {
+    // Defined in Logger_tests.cpp
+    void set_instance(const std::shared_ptr<rpp::ILogWriterFactory>& factory);
+    void clear_instance();
+}
+
+class LogLimiter_tests : public ::testing::Test
+{
+protected:
+    LogLimiter_tests() : mockClock(), mockLogWriterFactory(), mockLogWriter(), log_buffer() {
+    }
+
+    ~LogLimiter_tests() override = default;
+
+    void SetUp() override
+    {
+        mockClock = std::make_shared<rpp::MockClock>();
+        mockLogWriterFactory = std::make_shared<rpp::MockLogWriterFactory>();
+        mockLogWriter = std::make_shared<rpp::MockLogWriter>();
+        rpp::ClockAccessor::SetInstance(mockClock);
+        EXPECT_CALL(*mockClock, datetime_compact_string)
+                .WillRepeatedly(Return("DTC"));
+        EXPECT_CALL(*mockLogWriter, write(_))
+                .WillRepeatedly(Invoke([this](const std::string& message) {
+                    log_buffer += message;
+                }));
+        EXPECT_CALL(*mockLogWriterFactory, create_console_writer())
+                .WillOnce(Return(mockLogWriter));
+        rpp::set_instance(mockLogWriterFactory);
+        log_buffer = "";
+    }
+
+    void TearDown() override
+    {
+        log_set_rate_limit(0.0, 0);
+        log_set_deduplication(std::chrono::milliseconds(0));
+        rpp::ClockAccessor::SetInstance(nullptr);
+        rpp::clear_instance();
+    }
+
+    std::shared_ptr<rpp::MockClock> mockClock;
+    std::shared_ptr<rpp::MockLogWriterFactory> mockLogWriterFactory;
+    std::shared_ptr<rpp::MockLogWriter> mockLogWriter;
+    std::string log_buffer;
+};
+
+namespace {
+    size_t count_of(const std::string& text, const std::string& pattern) {
+        size_t count = 0;
+        for (size_t i = text.find(pattern); i != std::string::npos; i = text.find(pattern, i + 1))
+            count++;
+        return count;
+    }
+
+    void log_storm(int count, int value = 7) {
+        for (int i = 0; i < count; i++)
+            r_warn("StormMessage %d", value);
+    }
+}
+
+TEST_F(LogLimiter_tests, nothing_is_suppressed_by_default)
+{
+    // Arrange
+    // Act
+    log_storm(10);
+
+    // Assert
+    ASSERT_EQ(count_of(log_buffer, "StormMessage"), 10u);
+}
+
+TEST_F(LogLimiter_tests, repeats_are_counted_until_another_site_logs)
+{
+    // Arrange
+    log_set_deduplication(std::chrono::seconds(60));
+
+    // Act
+    log_storm(100);
+    r_info("OtherMessage");
+
+    // Assert
+    ASSERT_EQ(count_of(log_buffer, ", StormMessage"), 1u);
+    ASSERT_THAT(log_buffer, HasSubstr("message repeated 99 times in 0.0s: StormMessage 7"));
+    ASSERT_LT(log_buffer.find("repeated 99 times"), log_buffer.find("OtherMessage"));
+}
+
+TEST_F(LogLimiter_tests, flush_reports_pending_repeats)
+{
+    // Arrange
+    log_set_deduplication(std::chrono::seconds(60));
+
+    // Act
+    log_storm(5);
+    rpp::Logger::Instance()->flush();
+
+    // Assert
+    ASSERT_THAT(log_buffer, HasSubstr("LogLimiter_tests.cpp"));
+    ASSERT_THAT(log_buffer, HasSubstr("message repeated 4 times in "));
+}
+
+TEST_F(LogLimiter_tests, repeats_are_reported_when_the_window_expires)
+{
+    // Arrange
+    log_set_deduplication(std::chrono::milliseconds(1));
+
+    // Act
+    log_storm(2);
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    log_storm(1);
+
+    // Assert
+    ASSERT_THAT(log_buffer, HasSubstr("message repeated 2 times in "));
+}
+
+TEST_F(LogLimiter_tests, rate_limit_passes_a_burst_and_reports_the_rest)
+{
+    // Arrange
+    log_set_rate_limit(10.0, 3);
+
+    // Act
+    log_storm(50);
+    std::this_thread::sleep_for(std::chrono::milliseconds(150));
+    log_storm(1);
+
+    // Assert
+    ASSERT_EQ(count_of(log_buffer, "StormMessage"), 4u);
+    ASSERT_THAT(log_buffer, HasSubstr("47 messages suppressed in "));
+}
+
+TEST_F(LogLimiter_tests, distinct_messages_from_one_site_are_all_written)
+{
+    // Arrange
+    log_set_deduplication(std::chrono::seconds(60));
+
+    // Act
+    for (int i = 0; i < 10; i++)
+        log_storm(1, i);
+
+    // Assert
+    ASSERT_EQ(count_of(log_buffer, ", StormMessage"), 10u);
+    ASSERT_EQ(count_of(log_buffer, "repeated"), 0u);
+}
+
+TEST_F(LogLimiter_tests, a_changed_message_reports_the_repeats_of_the_previous_one)
+{
+    // Arrange
+    log_set_deduplication(std::chrono::seconds(60));
+
+    // Act
+    log_storm(3, 1);
+    log_storm(1, 2);
+
+    // Assert
+    ASSERT_THAT(log_buffer, HasSubstr("message repeated 2 times in 0.0s: StormMessage 1"));
+    ASSERT_THAT(log_buffer, HasSubstr(", StormMessage 2\n"));
+}
+
+TEST_F(LogLimiter_tests, threads_logging_alternately_are_deduplicated_per_site)
+{
+    // Arrange
+    log_set_deduplication(std::chrono::seconds(60));
+    auto other_site = [] {
+        r_info("OtherMessage");
+    };
+
+    // Act
+    for (int i = 0; i < 5; i++) {
+        log_storm(1);
+        std::thread(other_site).join();
+    }
+    rpp::Logger::Instance()->flush();
+
+    // Assert
+    ASSERT_EQ(count_of(log_buffer, ", StormMessage 7\n"), 1u);
+    ASSERT_EQ(count_of(log_buffer, ", OtherMessage\n"), 1u);
+    ASSERT_THAT(log_buffer, HasSubstr("message repeated 4 times in "));
+}
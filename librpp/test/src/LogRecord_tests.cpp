@@ -0,0 +1,134 @@
+#include <cstring>
+#include <string>
+#include "LogRecord.h"
+
+#include "gtest/gtest.h"
+
+class LogRecord_tests : public ::testing::Test
+{
+protected:
+    LogRecord_tests() : buffer_() {
+    }
+
+    ~LogRecord_tests() override = default;
+
+    void SetUp() override
+    {
+        buffer_.clear();
+    }
+
+    void TearDown() override
+    {
+    }
+
+    static rpp::LogRecord make_record(const std::initializer_list<rpp::LogField>& fields)
+    {
+        rpp::LogRecord record;
+        record.level = rpp::log_level::WARNING;
+        record.timestamp = 1600000000123000000;
+        record.thread = "3:1234";
+        record.application = "rover";
+        record.event = fields.begin()->key();
+        record.fields = fields.begin() + 1;
+        record.field_count = fields.size() - 1;
+        return record;
+    }
+
+    template <typename T>
+    static T read(const std::string& data, size_t& pos)
+    {
+        T value;
+        memcpy(&value, data.data() + pos, sizeof(T));
+        pos += sizeof(T);
+        return value;
+    }
+
+    rpp::LogBuffer buffer_;
+};
+
+TEST_F(LogRecord_tests, text_body_lists_fields)
+{
+    // Arrange
+    std::initializer_list<rpp::LogField> fields{"motor", {"rpm", 1200}, {"current", 3.25},
+                                                {"on", true}, {"name", "left"}, {"ticks", 7u}};
+    auto record = make_record(fields);
+
+    // Act
+    rpp::encode_text_body(record, buffer_);
+
+    // Assert
+    ASSERT_EQ(buffer_.view(), "motor rpm=1200 current=3.25 on=true name=\"left\" ticks=7");
+}
+
+TEST_F(LogRecord_tests, json_line_holds_typed_fields)
+{
+    // Arrange
+    std::string name("left");
+    std::initializer_list<rpp::LogField> fields{"motor", {"rpm", -1200}, {"current", 3.25},
+                                                {"on", false}, {"name", name}};
+    auto record = make_record(fields);
+
+    // Act
+    rpp::encode_json_line(record, buffer_);
+
+    // Assert
+    ASSERT_EQ(buffer_.view(), "{\"time\":1600000000123000000,\"level\":\"WARNING\",\"app\":\"rover\","
+                              "\"thread\":\"3:1234\",\"event\":\"motor\",\"fields\":{\"rpm\":-1200,"
+                              "\"current\":3.25,\"on\":false,\"name\":\"left\"}}\n");
+}
+
+TEST_F(LogRecord_tests, json_line_escapes_strings_and_non_finite_numbers)
+{
+    // Arrange
+    rpp::LogRecord record;
+    record.message = "say \"hi\"\\\n\x01";
+    std::initializer_list<rpp::LogField> fields{"e", {"nan", std::nan("")}};
+    auto event = make_record(fields);
+
+    // Act
+    rpp::encode_json_line(record, buffer_);
+    std::string message(buffer_.view());
+    buffer_.clear();
+    rpp::encode_json_line(event, buffer_);
+
+    // Assert
+    ASSERT_NE(message.find(",\"msg\":\"say \\\"hi\\\"\\\\\\n\\u0001\"}"), std::string::npos);
+    ASSERT_NE(buffer_.view().find("{\"nan\":null}"), std::string::npos);
+}
+
+TEST_F(LogRecord_tests, binary_record_is_length_prefixed)
+{
+    // Arrange
+    std::initializer_list<rpp::LogField> fields{"motor", {"rpm", 1200}, {"name", "left"}};
+    auto record = make_record(fields);
+
+    // Act
+    rpp::encode_binary_record(record, buffer_);
+    std::string data(buffer_.view());
+
+    // Assert
+    size_t pos = 0;
+    ASSERT_EQ(read<uint32_t>(data, pos), data.size() - sizeof(uint32_t));
+    ASSERT_EQ(read<uint8_t>(data, pos), static_cast<uint8_t>(rpp::log_level::WARNING));
+    ASSERT_EQ(read<uint64_t>(data, pos), 1600000000123000000u);
+    ASSERT_EQ(read<uint16_t>(data, pos), 6u);
+    ASSERT_EQ(data.substr(pos, 6), "3:1234");
+    pos += 6;
+    ASSERT_EQ(read<uint16_t>(data, pos), 5u);
+    ASSERT_EQ(data.substr(pos, 5), "rover");
+    pos += 5;
+    ASSERT_EQ(read<uint16_t>(data, pos), 5u);
+    ASSERT_EQ(data.substr(pos, 5), "motor");
+    pos += 5;
+    ASSERT_EQ(read<uint16_t>(data, pos), 0u);
+    ASSERT_EQ(read<uint8_t>(data, pos), 2u);
+    ASSERT_EQ(read<uint8_t>(data, pos), 3u);
+    ASSERT_EQ(data.substr(pos, 4), "rpmi");
+    pos += 4;
+    ASSERT_EQ(read<int64_t>(data, pos), 1200);
+    ASSERT_EQ(read<uint8_t>(data, pos), 4u);
+    ASSERT_EQ(data.substr(pos, 5), "names");
+    pos += 5;
+    ASSERT_EQ(read<uint16_t>(data, pos), 4u);
+    ASSERT_EQ(data.substr(pos), "left");
+}
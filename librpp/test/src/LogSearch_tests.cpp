@@ -0,0 +1,191 @@
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "LogSearch.h"
+
+#include "gtest/gtest.h"
+
+class LogSearch_tests : public ::testing::Test
+{
+protected:
+    LogSearch_tests() : path_("logsearch_test.txt") {
+    }
+
+    ~LogSearch_tests() override = default;
+
+    void SetUp() override
+    {
+        remove_files();
+    }
+
+    void TearDown() override
+    {
+        remove_files();
+    }
+
+    void remove_files()
+    {
+        std::filesystem::remove(path_);
+        std::filesystem::remove(rpp::LogSearch::index_path(path_));
+    }
+
+    // One line a second from 20261016-120000.000, every tenth a warning
+    // from "nav", the others info from "rover".
+    static std::string make_lines(int first, int count)
+    {
+        std::string lines;
+        for (int i = first; i < first + count; i++) {
+            char line[128];
+            snprintf(line, sizeof(line), "20261016-%02d%02d%02d.%03d, %s, %s, 1:100, line %d\n",
+                     12 + i / 3600, (i / 60) % 60, i % 60, i % 1000, (i % 10 == 0) ? "WW" : "II",
+                     (i % 10 == 0) ? "nav" : "rover", i);
+            lines += line;
+        }
+        return lines;
+    }
+
+    void append(const std::string& text)
+    {
+        std::ofstream out(path_, std::ios::app | std::ios::binary);
+        out << text;
+    }
+
+    static std::vector<std::string> find(const rpp::LogSearch& search, const rpp::log_query& query)
+    {
+        std::vector<std::string> lines;
+        search.search(query, [&lines](std::string_view line) { lines.emplace_back(line); });
+        return lines;
+    }
+
+    const std::string path_;
+};
+
+TEST_F(LogSearch_tests, parse_time_accepts_prefixes)
+{
+    // Arrange
+    // Act
+    // Assert
+    ASSERT_EQ(rpp::LogSearch::parse_time("20261016-235939.620"), 20261016235939620u);
+    ASSERT_EQ(rpp::LogSearch::parse_time("20261016-2359"), 20261016235900000u);
+    ASSERT_EQ(rpp::LogSearch::parse_time("20261016"), 20261016000000000u);
+    ASSERT_THROW(rpp::LogSearch::parse_time("2026"), std::invalid_argument);
+    ASSERT_THROW(rpp::LogSearch::parse_time("20261016 2359"), std::invalid_argument);
+}
+
+TEST_F(LogSearch_tests, search_returns_lines_in_time_range)
+{
+    // Arrange
+    append(make_lines(0, 2000));
+    rpp::LogSearch search(path_, 256);
+    rpp::log_query query;
+    query.from = rpp::LogSearch::parse_time("20261016-121000");
+    query.to = rpp::LogSearch::parse_time("20261016-121100");
+
+    // Act
+    auto lines = find(search, query);
+
+    // Assert
+    ASSERT_GT(search.index_entries(), 100u);
+    ASSERT_EQ(lines.size(), 60u);
+    ASSERT_NE(lines.front().find("line 600\n"), std::string::npos);
+    ASSERT_NE(lines.back().find("line 659\n"), std::string::npos);
+}
+
+TEST_F(LogSearch_tests, search_filters_level_and_application)
+{
+    // Arrange
+    append(make_lines(0, 1000));
+    rpp::LogSearch search(path_, 256);
+    rpp::log_query warnings;
+    warnings.level = rpp::log_level::WARNING;
+    rpp::log_query rover;
+    rover.application = "rover";
+
+    // Act
+    auto warning_lines = find(search, warnings);
+    auto rover_lines = find(search, rover);
+
+    // Assert
+    ASSERT_EQ(warning_lines.size(), 100u);
+    ASSERT_EQ(rover_lines.size(), 900u);
+    ASSERT_NE(warning_lines[1].find(", WW, nav, "), std::string::npos);
+}
+
+TEST_F(LogSearch_tests, search_finds_lines_written_after_newer_blocks)
+{
+    // Arrange
+    append(make_lines(200, 100) + make_lines(100, 100));
+    rpp::LogSearch search(path_, 256);
+    rpp::log_query query;
+    query.from = rpp::LogSearch::parse_time("20261016-120230");
+    query.to = rpp::LogSearch::parse_time("20261016-120240");
+
+    // Act
+    auto lines = find(search, query);
+
+    // Assert
+    ASSERT_EQ(lines.size(), 10u);
+    ASSERT_NE(lines.front().find("line 150\n"), std::string::npos);
+    ASSERT_NE(lines.back().find("line 159\n"), std::string::npos);
+}
+
+TEST_F(LogSearch_tests, untimed_lines_go_with_the_line_before)
+{
+    // Arrange
+    append(make_lines(0, 1) + "  at frame 1\n" + make_lines(1, 1) + "  at frame 2\n");
+    rpp::LogSearch search(path_);
+    rpp::log_query query;
+    query.level = rpp::log_level::WARNING;
+
+    // Act
+    auto lines = find(search, query);
+
+    // Assert
+    ASSERT_EQ(lines.size(), 2u);
+    ASSERT_EQ(lines[1], "  at frame 1\n");
+}
+
+TEST_F(LogSearch_tests, index_is_saved_and_extended_as_log_grows)
+{
+    // Arrange
+    append(make_lines(0, 1000));
+    rpp::LogSearch first(path_, 256);
+    first.save_index();
+    auto indexed = first.indexed_size();
+    std::string appended = make_lines(1000, 500) + "20261016-12";
+
+    // Act
+    append(appended);
+    auto added = first.refresh();
+    rpp::LogSearch second(path_, 256);
+    rpp::log_query query;
+    query.from = rpp::LogSearch::parse_time("20261016-121640");
+
+    // Assert
+    ASSERT_TRUE(std::filesystem::exists(rpp::LogSearch::index_path(path_)));
+    ASSERT_EQ(added, appended.size() - 11);
+    ASSERT_EQ(second.indexed_size(), indexed + added);
+    ASSERT_EQ(find(first, query).size(), 500u);
+    ASSERT_EQ(find(second, query).size(), 500u);
+}
+
+TEST_F(LogSearch_tests, index_is_rebuilt_when_log_is_replaced)
+{
+    // Arrange
+    append(make_lines(0, 1000));
+    rpp::LogSearch search(path_, 256);
+    search.save_index();
+
+    // Act
+    std::filesystem::rename(path_, path_ + ".1");
+    append(make_lines(5000, 10));
+    search.refresh();
+    rpp::LogSearch reopened(path_, 256);
+    std::filesystem::remove(path_ + ".1");
+
+    // Assert
+    ASSERT_EQ(find(search, rpp::log_query()).size(), 10u);
+    ASSERT_EQ(find(reopened, rpp::log_query()).size(), 10u);
+}
@@ -0,0 +1,218 @@
+#include <future>
+#include <string>
+#include "Logger.h"
+#include "ThreadIdentity.h"
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "ClockAccessor.h"
+#include "mock_clock.h"
+#include "mock_logwriter.h"
+#include "mock_logwriterfactory.h"
+
+using namespace testing;
+
+namespace rpp {
+    // Defined in Logger_tests.cpp
+    void set_instance(const std::shared_ptr<rpp::ILogWriterFactory>& factory);
+    void clear_instance();
+}
+
+class LogSink_tests : public ::testing::Test
+{
+protected:
+    LogSink_tests() : mockClock(), mockLogWriterFactory(), mockLogWriter(), log_buffer() {
+    }
+
+    ~LogSink_tests() override = default;
+
+    void SetUp() override
+    {
+        mockClock = std::make_shared<rpp::MockClock>();
+        mockLogWriterFactory = std::make_shared<rpp::MockLogWriterFactory>();
+        mockLogWriter = std::make_shared<rpp::MockLogWriter>();
+        rpp::ClockAccessor::SetInstance(mockClock);
+        EXPECT_CALL(*mockClock, datetime_compact_string)
+                .WillRepeatedly(Return("DTC"));
+        EXPECT_CALL(*mockLogWriter, write(_))
+                .WillRepeatedly(Invoke([this](const std::string& message) {
+                    log_buffer += message;
+                }));
+        EXPECT_CALL(*mockLogWriterFactory, create_console_writer())
+                .WillOnce(Return(mockLogWriter));
+        rpp::set_instance(mockLogWriterFactory);
+        log_buffer = "";
+    }
+
+    void TearDown() override
+    {
+        log_set_level(rpp::log_level::DEBUG);
+        rpp::ClockAccessor::SetInstance(nullptr);
+        rpp::clear_instance();
+    }
+
+    std::shared_ptr<rpp::MockClock> mockClock;
+    std::shared_ptr<rpp::MockLogWriterFactory> mockLogWriterFactory;
+    std::shared_ptr<rpp::MockLogWriter> mockLogWriter;
+    std::string log_buffer;
+};
+
+namespace {
+    std::shared_ptr<rpp::MockLogWriter> create_sink_writer(std::string& buffer) {
+        auto writer = std::make_shared<rpp::MockLogWriter>();
+        EXPECT_CALL(*writer, write(_))
+                .WillRepeatedly(Invoke([&buffer](const std::string& message) {
+                    buffer += message;
+                }));
+        EXPECT_CALL(*writer, close())
+                .Times(1);
+        return writer;
+    }
+}
+
+TEST_F(LogSink_tests, sink_receives_messages_at_or_above_its_level)
+{
+    // Arrange
+    std::string sink_buffer;
+    log_add_sink("warnings", create_sink_writer(sink_buffer), rpp::log_level::WARNING);
+
+    // Act
+    r_info("InfoMessage");
+    r_err("ErrorMessage");
+    log_flush();
+
+    // Assert
+    ASSERT_THAT(log_buffer, HasSubstr("InfoMessage"));
+    ASSERT_THAT(log_buffer, HasSubstr("ErrorMessage"));
+    ASSERT_THAT(sink_buffer, Not(HasSubstr("InfoMessage")));
+    ASSERT_THAT(sink_buffer, HasSubstr("DTC, EE, ??, " + std::string(rpp::ThreadIdentity::current().field()) + ", "));
+    ASSERT_THAT(sink_buffer, HasSubstr("ErrorMessage\n"));
+}
+
+TEST_F(LogSink_tests, primary_writer_and_sinks_have_independent_levels)
+{
+    // Arrange
+    std::string sink_buffer;
+    log_set_level(rpp::log_level::WARNING);
+    log_add_sink("file", create_sink_writer(sink_buffer), rpp::log_level::DEBUG);
+
+    // Act
+    r_debug("DebugMessage");
+    r_warn("WarningMessage");
+    rpp::Logger::Instance()->log(rpp::log_level::INFO, "InfoMessage");
+    log_flush();
+
+    // Assert
+    ASSERT_THAT(log_buffer, Not(HasSubstr("DebugMessage")));
+    ASSERT_THAT(log_buffer, Not(HasSubstr("InfoMessage")));
+    ASSERT_THAT(log_buffer, HasSubstr("WarningMessage"));
+    ASSERT_THAT(sink_buffer, HasSubstr("DebugMessage"));
+    ASSERT_THAT(sink_buffer, HasSubstr("InfoMessage"));
+    ASSERT_THAT(sink_buffer, HasSubstr("WarningMessage"));
+}
+
+TEST_F(LogSink_tests, removing_the_last_sink_restores_the_output_threshold)
+{
+    // Arrange
+    std::string sink_buffer;
+    log_set_level(rpp::log_level::WARNING);
+    log_add_sink("file", create_sink_writer(sink_buffer), rpp::log_level::DEBUG);
+
+    // Act
+    log_remove_sink("file");
+    r_debug("DebugMessage");
+    log_flush();
+
+    // Assert
+    ASSERT_FALSE(rpp::LogFilter::reaches_sinks(rpp::log_level::ERROR));
+    ASSERT_THAT(log_buffer, Not(HasSubstr("DebugMessage")));
+    ASSERT_THAT(sink_buffer, Not(HasSubstr("DebugMessage")));
+}
+
+TEST_F(LogSink_tests, sink_level_can_be_changed)
+{
+    // Arrange
+    std::string sink_buffer;
+    log_add_sink("sink", create_sink_writer(sink_buffer), rpp::log_level::ERROR);
+
+    // Act
+    bool changed = log_set_sink_level("sink", rpp::log_level::DEBUG);
+    bool unknown = log_set_sink_level("unknown", rpp::log_level::DEBUG);
+    r_debug("DebugMessage");
+    log_flush();
+
+    // Assert
+    ASSERT_TRUE(changed);
+    ASSERT_FALSE(unknown);
+    ASSERT_THAT(sink_buffer, HasSubstr("DebugMessage"));
+}
+
+TEST_F(LogSink_tests, removed_sink_is_drained_and_closed)
+{
+    // Arrange
+    std::string sink_buffer;
+    auto writer = create_sink_writer(sink_buffer);
+    log_add_sink("sink", writer, rpp::log_level::DEBUG);
+    r_info("BeforeRemove");
+
+    // Act
+    bool removed = log_remove_sink("sink");
+    r_info("AfterRemove");
+
+    // Assert
+    ASSERT_TRUE(removed);
+    ASSERT_FALSE(log_remove_sink("sink"));
+    ASSERT_THAT(sink_buffer, HasSubstr("BeforeRemove"));
+    ASSERT_THAT(sink_buffer, Not(HasSubstr("AfterRemove")));
+}
+
+TEST_F(LogSink_tests, slow_sink_does_not_hold_up_other_sinks)
+{
+    // Arrange
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    auto slow = std::make_shared<rpp::MockLogWriter>();
+    EXPECT_CALL(*slow, write(_))
+            .WillRepeatedly(Invoke([released](const std::string&) {
+                released.wait();
+            }));
+    EXPECT_CALL(*slow, close())
+            .Times(1);
+    std::string fast_buffer;
+    log_add_sink("slow", slow, rpp::log_level::DEBUG, 4, rpp::log_overflow_policy::COUNT_AND_DROP);
+    log_add_sink("fast", create_sink_writer(fast_buffer), rpp::log_level::DEBUG);
+
+    // Act
+    for (int i = 0; i < 100; i++)
+        r_info("Message %d", i);
+    log_remove_sink("fast");
+    release.set_value();
+
+    // Assert
+    ASSERT_THAT(fast_buffer, HasSubstr("Message 0\n"));
+    ASSERT_THAT(fast_buffer, HasSubstr("Message 99\n"));
+}
+
+TEST_F(LogSink_tests, sinks_share_one_copy_of_the_line)
+{
+    // Arrange
+    rpp::LogSinks sinks;
+    std::string first_buffer;
+    std::string second_buffer;
+    auto first = std::make_shared<rpp::LogSink>("first", create_sink_writer(first_buffer), rpp::log_level::DEBUG);
+    auto second = std::make_shared<rpp::LogSink>("second", create_sink_writer(second_buffer), rpp::log_level::DEBUG);
+    sinks.add(first);
+    sinks.add(second);
+    auto line = std::make_shared<const std::string>("SharedLine\n");
+
+    // Act
+    first->post(line);
+    second->post(line);
+    sinks.publish(rpp::log_level::INFO, "Published\n");
+    sinks.flush();
+
+    // Assert
+    ASSERT_EQ(line.use_count(), 1);
+    ASSERT_EQ(first_buffer, "SharedLine\nPublished\n");
+    ASSERT_EQ(second_buffer, "SharedLine\nPublished\n");
+}
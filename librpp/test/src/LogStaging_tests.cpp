@@ -0,0 +1,160 @@
+#include <string>
+#include <thread>
+#include "LogStaging.h"
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "mock_logwriter.h"
+
+using namespace testing;
+
+class LogStaging_tests : public ::testing::Test
+{
+protected:
+    LogStaging_tests() : mockLogWriter(), written(), written_mutex(), n_writes(0) {
+    }
+
+    ~LogStaging_tests() override = default;
+
+    void SetUp() override
+    {
+        mockLogWriter = std::make_shared<rpp::MockLogWriter>();
+        EXPECT_CALL(*mockLogWriter, write(_))
+                .WillRepeatedly(Invoke([this](const std::string& message) {
+                    std::scoped_lock lock(written_mutex);
+                    written += message;
+                    n_writes++;
+                }));
+    }
+
+    void TearDown() override
+    {
+    }
+
+    std::string get_written()
+    {
+        std::scoped_lock lock(written_mutex);
+        return written;
+    }
+
+    std::shared_ptr<rpp::MockLogWriter> mockLogWriter;
+    std::string written;
+    std::mutex written_mutex;
+    int n_writes;
+};
+
+TEST_F(LogStaging_tests, lines_are_held_until_flush)
+{
+    // Arrange
+    rpp::LogStaging staging(1024, std::chrono::hours(1));
+    staging.set_writer(mockLogWriter);
+
+    // Act
+    staging.append("Line1\n");
+    staging.append("Line2\n");
+    auto before_flush = get_written();
+    staging.flush();
+
+    // Assert
+    ASSERT_TRUE(before_flush.empty());
+    ASSERT_EQ(get_written(), "Line1\nLine2\n");
+}
+
+TEST_F(LogStaging_tests, full_buffer_is_written_with_new_line)
+{
+    // Arrange
+    rpp::LogStaging staging(8, std::chrono::hours(1));
+    staging.set_writer(mockLogWriter);
+
+    // Act
+    staging.append("1234\n");
+    staging.append("5678\n");
+
+    // Assert
+    ASSERT_EQ(get_written(), "1234\n5678\n");
+}
+
+TEST_F(LogStaging_tests, timer_flushes_pending_lines)
+{
+    // Arrange
+    rpp::LogStaging staging(1024, std::chrono::milliseconds(5));
+    staging.set_writer(mockLogWriter);
+
+    // Act
+    staging.append("Line\n");
+    for (int i = 0; i < 200 && get_written().empty(); i++)
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+    // Assert
+    ASSERT_EQ(get_written(), "Line\n");
+}
+
+TEST_F(LogStaging_tests, lines_are_kept_while_writer_is_detached)
+{
+    // Arrange
+    rpp::LogStaging staging(1024, std::chrono::hours(1));
+
+    // Act
+    staging.append("Line\n");
+    staging.flush();
+    staging.set_writer(mockLogWriter);
+
+    // Assert
+    ASSERT_EQ(get_written(), "Line\n");
+}
+
+TEST_F(LogStaging_tests, stopped_timer_does_not_flush_until_restarted)
+{
+    // Arrange
+    rpp::LogStaging staging(1024, std::chrono::milliseconds(1));
+    staging.set_writer(mockLogWriter);
+    staging.stop();
+
+    // Act
+    staging.append("Line\n");
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    auto while_stopped = get_written();
+    staging.start(1024, std::chrono::milliseconds(1));
+    for (int i = 0; i < 200 && get_written().empty(); i++)
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+    // Assert
+    ASSERT_TRUE(while_stopped.empty());
+    ASSERT_EQ(get_written(), "Line\n");
+}
+
+TEST_F(LogStaging_tests, threads_keep_their_line_order)
+{
+    // Arrange
+    const int n_threads = 4;
+    const int n_lines = 2000;
+    std::vector<std::thread> threads;
+    {
+        rpp::LogStaging staging(256, std::chrono::milliseconds(1));
+        staging.set_writer(mockLogWriter);
+
+        // Act
+        for (int t = 0; t < n_threads; t++) {
+            threads.emplace_back([&staging, t]() {
+                for (int i = 0; i < n_lines; i++)
+                    staging.append("T" + std::to_string(t) + " " + std::to_string(i) + "\n");
+            });
+        }
+        for (auto& thread : threads)
+            thread.join();
+    }
+
+    // Assert
+    std::vector<int> last(n_threads, -1);
+    std::stringstream lines(get_written());
+    std::string line;
+    int count = 0;
+    while (std::getline(lines, line)) {
+        auto t = static_cast<size_t>(line[1] - '0');
+        int i = std::stoi(line.substr(3));
+        ASSERT_EQ(i, last[t] + 1);
+        last[t] = i;
+        count++;
+    }
+    ASSERT_EQ(count, n_threads * n_lines);
+}
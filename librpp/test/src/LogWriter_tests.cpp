@@ -0,0 +1,305 @@
+#include <chrono>
+#include <string>
+#include <thread>
+#include "LogWriter.h"
+#include "FileUtils.h"
+
+#include "gtest/gtest.h"
+
+class LogWriter_tests : public ::testing::Test
+{
+protected:
+    LogWriter_tests() : filename_("logwriter_test.txt") {
+    }
+
+    ~LogWriter_tests() override = default;
+
+    void SetUp() override
+    {
+        remove(filename_.c_str());
+    }
+
+    void TearDown() override
+    {
+        remove(filename_.c_str());
+    }
+
+    const std::string filename_;
+};
+
+TEST_F(LogWriter_tests, fd_writer_appends_messages)
+{
+    // Arrange
+    rpp::FdLogWriter writer;
+
+    // Act
+    writer.open(filename_);
+    writer.write("Line1\n");
+    writer.close();
+    writer.open(filename_);
+    writer.write("Line2\n");
+    writer.close();
+
+    // Assert
+    ASSERT_EQ(FileUtils::TryReadFileAsString(filename_), "Line1\nLine2\n");
+}
+
+TEST_F(LogWriter_tests, fd_writer_writes_batches_in_order)
+{
+    // Arrange
+    rpp::FdLogWriter writer;
+    std::vector<std::string> lines;
+    std::string expected;
+    for (int i = 0; i < 3000; i++) {
+        lines.push_back("Line " + std::to_string(i) + "\n");
+        expected += lines.back();
+    }
+    std::vector<std::string_view> chunks(lines.begin(), lines.end());
+
+    // Act
+    writer.open(filename_);
+    writer.write_batch(chunks);
+    writer.close();
+
+    // Assert
+    ASSERT_EQ(FileUtils::TryReadFileAsString(filename_), expected);
+}
+
+TEST_F(LogWriter_tests, fd_writer_ignores_writes_when_closed)
+{
+    // Arrange
+    rpp::FdLogWriter writer;
+
+    // Act
+    // Assert
+    ASSERT_NO_THROW(writer.write("Line\n"));
+}
+
+TEST_F(LogWriter_tests, file_writer_writes_batches)
+{
+    // Arrange
+    rpp::FileLogWriter writer;
+
+    // Act
+    writer.open(filename_);
+    writer.write_batch({"Line1\n", "Line2\n"});
+    writer.close();
+
+    // Assert
+    ASSERT_EQ(FileUtils::TryReadFileAsString(filename_), "Line1\nLine2\n");
+}
+
+TEST_F(LogWriter_tests, mmap_writer_file_holds_only_written_data)
+{
+    // Arrange
+    rpp::MmapLogWriter writer;
+
+    // Act
+    writer.open(filename_);
+    writer.write("Line1\n");
+    writer.write_batch({"Line2\n", "Line3\n"});
+    auto size = writer.size();
+    writer.close();
+
+    // Assert
+    ASSERT_EQ(size, 18u);
+    ASSERT_EQ(FileUtils::TryReadFileAsString(filename_), "Line1\nLine2\nLine3\n");
+}
+
+TEST_F(LogWriter_tests, mmap_writer_switches_segments)
+{
+    // Arrange
+    rpp::MmapLogWriter writer(4096);
+    std::string expected;
+
+    // Act
+    writer.open(filename_);
+    for (int i = 0; i < 5000; i++) {
+        std::string line = "Line " + std::to_string(i) + "\n";
+        expected += line;
+        writer.write(line);
+    }
+    writer.close();
+
+    // Assert
+    ASSERT_GT(expected.size(), 10u * 4096u);
+    ASSERT_EQ(FileUtils::TryReadFileAsString(filename_), expected);
+}
+
+TEST_F(LogWriter_tests, mmap_writer_appends_to_existing_file)
+{
+    // Arrange
+    rpp::MmapLogWriter writer(4096);
+    FileUtils::TryWriteStringAsFile(filename_, "Existing\n");
+
+    // Act
+    writer.open(filename_);
+    writer.write("Line1\n");
+    writer.close();
+    writer.open(filename_);
+    writer.write("Line2\n");
+    writer.close();
+
+    // Assert
+    ASSERT_EQ(FileUtils::TryReadFileAsString(filename_), "Existing\nLine1\nLine2\n");
+}
+
+TEST_F(LogWriter_tests, mmap_writer_appends_after_data_left_by_a_crash)
+{
+    // Arrange
+    rpp::MmapLogWriter writer(4096);
+    std::string crashed("Existing\n");
+    crashed.resize(8192, '\0');
+    FileUtils::TryWriteStringAsFile(filename_, crashed);
+
+    // Act
+    writer.open(filename_);
+    writer.write("Line1\n");
+    writer.close();
+
+    // Assert
+    ASSERT_EQ(FileUtils::TryReadFileAsString(filename_), "Existing\nLine1\n");
+}
+
+TEST_F(LogWriter_tests, mmap_writer_ignores_writes_when_closed)
+{
+    // Arrange
+    rpp::MmapLogWriter writer;
+
+    // Act
+    // Assert
+    ASSERT_NO_THROW(writer.write("Line\n"));
+}
+
+TEST_F(LogWriter_tests, uring_writer_appends_lines_and_batches)
+{
+    // Arrange
+    rpp::UringLogWriter writer;
+    std::vector<std::string> lines;
+    std::string expected = "Line1\nLine2\n";
+    for (int i = 0; i < 3000; i++) {
+        lines.push_back("Line " + std::to_string(i) + "\n");
+        expected += lines.back();
+    }
+    std::vector<std::string_view> chunks(lines.begin(), lines.end());
+
+    // Act
+    writer.open(filename_);
+    writer.write("Line1\n");
+    writer.close();
+    writer.open(filename_);
+    writer.write_line("Line2\n");
+    writer.write_batch(chunks);
+    writer.close();
+
+    // Assert
+    ASSERT_EQ(FileUtils::TryReadFileAsString(filename_), expected);
+}
+
+TEST_F(LogWriter_tests, uring_writer_submits_held_lines_on_interval)
+{
+    // Arrange
+    rpp::UringLogWriter writer(rpp::async_io_backend::AUTO, std::chrono::milliseconds(20));
+    std::string content;
+
+    // Act
+    writer.open(filename_);
+    writer.write_line("Line1\n");
+    for (int i = 0; i < 200 && content.empty(); i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        content = FileUtils::TryReadFileAsString(filename_);
+    }
+
+    // Assert
+    ASSERT_EQ(content, "Line1\n");
+}
+
+TEST_F(LogWriter_tests, uring_writer_sync_puts_held_lines_on_file)
+{
+    // Arrange
+    rpp::UringLogWriter writer(rpp::async_io_backend::AUTO, std::chrono::hours(1));
+
+    // Act
+    writer.open(filename_);
+    writer.write_line("Line1\n");
+    writer.sync();
+
+    // Assert
+    ASSERT_EQ(FileUtils::TryReadFileAsString(filename_), "Line1\n");
+}
+
+TEST_F(LogWriter_tests, uring_writer_thread_backend_ignores_writes_when_closed)
+{
+    // Arrange
+    rpp::UringLogWriter writer(rpp::async_io_backend::THREAD);
+
+    // Act
+    writer.open("/root/fail/log.txt");
+
+    // Assert
+    ASSERT_EQ(writer.backend(), rpp::async_io_backend::THREAD);
+    ASSERT_NO_THROW(writer.write("Line\n"));
+}
+
+TEST_F(LogWriter_tests, buffered_writer_writes_lines_on_interval)
+{
+    // Arrange
+    rpp::log_durability_policy policy;
+    policy.mode = rpp::log_durability::BUFFERED;
+    policy.interval = std::chrono::milliseconds(20);
+    rpp::FileLogWriter writer(policy);
+    std::string content;
+
+    // Act
+    writer.open(filename_);
+    writer.write_line("Line1\n");
+    auto held = FileUtils::TryReadFileAsString(filename_);
+    for (int i = 0; i < 200 && content.empty(); i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        content = FileUtils::TryReadFileAsString(filename_);
+    }
+
+    // Assert
+    ASSERT_EQ(held, "");
+    ASSERT_EQ(content, "Line1\n");
+}
+
+TEST_F(LogWriter_tests, buffered_writer_writes_full_buffer)
+{
+    // Arrange
+    rpp::log_durability_policy policy;
+    policy.mode = rpp::log_durability::BUFFERED;
+    policy.buffer_size = 16;
+    policy.interval = std::chrono::hours(1);
+    rpp::FileLogWriter writer(policy);
+
+    // Act
+    writer.open(filename_);
+    writer.write_batch({"Line1\n", "Line2\n", "Line3\n"});
+
+    // Assert
+    ASSERT_FALSE(FileUtils::TryReadFileAsString(filename_).empty());
+}
+
+TEST_F(LogWriter_tests, group_commit_writer_sync_writes_held_lines)
+{
+    // Arrange
+    rpp::log_durability_policy policy;
+    policy.mode = rpp::log_durability::GROUP_COMMIT;
+    policy.interval = std::chrono::hours(1);
+    rpp::FileLogWriter writer(policy);
+
+    // Act
+    writer.open(filename_);
+    writer.write("Line1\n");
+    auto held = FileUtils::TryReadFileAsString(filename_);
+    writer.sync();
+    auto synced = FileUtils::TryReadFileAsString(filename_);
+    writer.write("Line2\n");
+    writer.close();
+
+    // Assert
+    ASSERT_EQ(held, "");
+    ASSERT_EQ(synced, "Line1\n");
+    ASSERT_EQ(FileUtils::TryReadFileAsString(filename_), "Line1\nLine2\n");
+}
@@ -0,0 +1,129 @@
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+#include "Logger.h"
+#include "ThreadsafeQueue.h"
+
+#include "gtest/gtest.h"
+
+// Counts every allocation in this executable, which is why these tests
+// are not part of rpp_unit_tests.
+static std::atomic<size_t> allocations{0};
+
+void* operator new(size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    void* p = malloc(size > 0 ? size : 1);
+    if (p == nullptr)
+        throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void* p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+    free(p);
+}
+
+class LoggerAllocation_tests : public ::testing::Test
+{
+protected:
+    LoggerAllocation_tests() : filename_("allocation_test.txt") {
+    }
+
+    ~LoggerAllocation_tests() override = default;
+
+    void SetUp() override
+    {
+        log_set_file(filename_);
+    }
+
+    void TearDown() override
+    {
+        log_cleanup();
+        remove(filename_.c_str());
+    }
+
+    const std::string filename_;
+};
+
+TEST_F(LoggerAllocation_tests, logging_a_line_does_not_allocate)
+{
+    // Arrange
+    // The first call sets up the call site and the thread's buffers.
+    r_info("x=%d", 0);
+    size_t before = allocations.load();
+
+    // Act
+    for (int i = 1; i <= 100; i++)
+        r_info("x=%d, name=%s, value=%f", i, "motor", 1.5);
+
+    // Assert
+    ASSERT_EQ(allocations.load(), before);
+}
+
+TEST_F(LoggerAllocation_tests, logging_a_compile_time_format_does_not_allocate)
+{
+    // Arrange
+    std::string name("motor");
+    r_info(RPP_FMT("x=%d"), 0);
+    size_t before = allocations.load();
+
+    // Act
+    for (int i = 1; i <= 100; i++)
+        r_info(RPP_FMT("x=%d, name=%s, value=%f"), i, name, 1.5);
+
+    // Assert
+    ASSERT_EQ(allocations.load(), before);
+}
+
+TEST_F(LoggerAllocation_tests, logging_a_large_line_allocates)
+{
+    // Arrange
+    std::string large(rpp::Logger::line_buffer_size, 'x');
+    r_info("x=%d", 0);
+    size_t before = allocations.load();
+
+    // Act
+    r_info("%s", large.c_str());
+
+    // Assert
+    ASSERT_GT(allocations.load(), before);
+}
+
+TEST(ThreadsafeQueueAllocation_tests, pooled_queue_does_not_allocate_in_steady_state)
+{
+    // Arrange
+    PooledThreadsafeQueue<std::vector<char>> queue(RingStorage<std::vector<char>>(64));
+    std::vector<std::vector<char>> buffers;
+    for (int i = 0; i < 64; i++)
+        buffers.emplace_back(4096);
+    std::vector<std::vector<char>> drained;
+    drained.reserve(64);
+    size_t before = allocations.load();
+
+    // Act
+    for (int round = 0; round < 10; round++) {
+        for (auto& buffer : buffers)
+            queue.push(std::move(buffer));
+        for (auto& buffer : buffers)
+            buffer = std::move(*queue.pop());
+        for (auto& buffer : buffers)
+            queue.push(std::move(buffer));
+        queue.drain_all(drained);
+        for (size_t i = 0; i < buffers.size(); i++)
+            buffers[i] = std::move(drained[i]);
+        drained.clear();
+    }
+
+    // Assert
+    ASSERT_EQ(allocations.load(), before);
+    ASSERT_EQ(queue.size(), 0u);
+    ASSERT_EQ(buffers.back().size(), 4096u);
+}
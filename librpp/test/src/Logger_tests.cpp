@@ -2,6 +2,7 @@
 #include <thread>
 #include "Logger.h"
 #include "FileUtils.h"
+#include "RotatingLogWriter.h"
 
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
@@ -16,13 +17,11 @@ using testing::Invoke;
 
 namespace rpp {
     void set_instance(const std::shared_ptr<rpp::ILogWriterFactory>& factory) {
-        std::scoped_lock lock(Logger::log_mutex_);
-        rpp::Logger::logger_ = std::shared_ptr<rpp::Logger>(new Logger(factory));
+        rpp::Logger::reset_instance(std::shared_ptr<rpp::Logger>(new Logger(factory)));
     }
 
     void clear_instance() {
-        std::scoped_lock lock(Logger::log_mutex_);
-        rpp::Logger::logger_ = nullptr;
+        rpp::Logger::reset_instance(nullptr);
     }
 
 }
@@ -287,8 +286,7 @@ TEST_F(Logger_tests, move_log_catches_filesystem_exception)
     create_test_log_instance();
     std::filesystem::filesystem_error filesystemError("Mock Error",
                                                       std::make_error_code(std::errc::no_such_file_or_directory));
-    EXPECT_CALL(*mockLogWriter, close())
-                .Times(2);
+    EXPECT_CALL(*mockLogWriter, close());
 
     EXPECT_CALL(*mockLogWriterFactory, create_file_writer())
             .WillOnce(Return(mockLogWriter));
@@ -301,6 +299,21 @@ TEST_F(Logger_tests, move_log_catches_filesystem_exception)
 }
 
 
+TEST_F(Logger_tests, log_set_writer_factory_creates_console_writer_through_factory)
+{
+    // Arrange
+    set_default_expectations();
+    EXPECT_CALL(*mockLogWriterFactory, create_console_writer())
+            .WillOnce(Return(mockLogWriter));
+
+    // Act
+    log_set_writer_factory(mockLogWriterFactory);
+    r_info("Through the factory.");
+
+    // Assert
+    ASSERT_THAT(log_buffer, EndsWith(", Through the factory.\n"));
+}
+
 TEST_F(Logger_tests, logger_log_to_file_appends_log_to_same_file)
 {
     // Arrange
@@ -428,8 +441,7 @@ TEST_F(Logger_tests, logger_moves_log_while_logging)
             .WillRepeatedly(Return(expected_DTC));
     EXPECT_CALL(*mockLogWriter, write(_)).
             Times(n_threads * n_logs + n_call_to_log_in_log_to_file_fn);
-    EXPECT_CALL(*mockLogWriter, close())
-            .Times(2);
+    EXPECT_CALL(*mockLogWriter, close());
     EXPECT_CALL(*mockLogWriterFactory, create_file_writer())
             .WillOnce(Return(mockLogWriter));
     EXPECT_CALL(*mockLogWriter, open(_));
@@ -447,4 +459,284 @@ TEST_F(Logger_tests, logger_moves_log_while_logging)
     t3.join();
     // Assert
 
-}
\ No newline at end of file
+}
+TEST_F(Logger_tests, async_logger_writes_messages_after_flush)
+{
+    // Arrange
+    create_test_log_instance();
+    EXPECT_CALL(*mockClock, datetime_compact_string)
+            .WillRepeatedly(Return(expected_DTC));
+    std::string test_log1 ("Log1");
+    std::string test_log2 ("Log2");
+
+    // Act
+    log_set_async(16, rpp::log_overflow_policy::BLOCK);
+    r_info(test_log1);
+    r_info(test_log2);
+    log_flush();
+
+    // Assert
+    ASSERT_THAT(log_buffer, HasSubstr(test_log1));
+    ASSERT_THAT(log_buffer, HasSubstr(test_log2));
+    log_set_sync();
+}
+
+TEST_F(Logger_tests, staged_logger_writes_messages_after_flush)
+{
+    // Arrange
+    create_test_log_instance();
+    EXPECT_CALL(*mockClock, datetime_compact_string)
+            .WillRepeatedly(Return(expected_DTC));
+    std::string test_log1 ("Log1");
+    std::string test_log2 ("Log2");
+
+    // Act
+    log_set_staging(4096, std::chrono::hours(1));
+    r_info(test_log1);
+    r_info(test_log2);
+    auto before_flush = log_buffer;
+    log_flush();
+
+    // Assert
+    ASSERT_TRUE(before_flush.empty());
+    ASSERT_THAT(log_buffer, HasSubstr(test_log1));
+    ASSERT_THAT(log_buffer, HasSubstr(test_log2));
+    log_clear_staging();
+}
+
+TEST_F(Logger_tests, cleared_staging_releases_the_writer_and_can_be_set_again)
+{
+    // Arrange
+    create_test_log_instance();
+    EXPECT_CALL(*mockClock, datetime_compact_string)
+            .WillRepeatedly(Return(expected_DTC));
+    long writer_uses = mockLogWriter.use_count();
+
+    // Act
+    log_set_staging(4096, std::chrono::hours(1));
+    r_info("Staged1");
+    log_clear_staging();
+    long uses_after_clear = mockLogWriter.use_count();
+    r_info("Direct");
+    auto after_clear = log_buffer;
+    log_set_staging(4096, std::chrono::hours(1));
+    r_info("Staged2");
+    log_flush();
+    log_clear_staging();
+
+    // Assert
+    ASSERT_EQ(uses_after_clear, writer_uses);
+    ASSERT_THAT(after_clear, HasSubstr("Staged1"));
+    ASSERT_THAT(after_clear, HasSubstr("Direct"));
+    ASSERT_THAT(log_buffer, HasSubstr("Staged2"));
+}
+
+TEST_F(Logger_tests, logger_log_set_file_creates_fd_file_writer)
+{
+    // Arrange
+    set_default_expectations();
+    create_test_log_instance();
+    EXPECT_CALL(*mockLogWriter, close());
+    EXPECT_CALL(*mockLogWriterFactory, create_fd_file_writer())
+            .WillOnce(Return(mockLogWriter));
+    EXPECT_CALL(*mockLogWriter, open(_));
+
+    // Act
+    log_set_file_writer_type(rpp::file_writer_type::FD);
+    log_set_file("log.txt");
+
+    // Assert
+}
+
+TEST_F(Logger_tests, factory_without_file_writer_types_creates_its_file_writer)
+{
+    // Arrange
+    class FileOnlyFactory : public rpp::ILogWriterFactory
+    {
+    public:
+        explicit FileOnlyFactory(std::shared_ptr<rpp::ILogWriter> writer) : writer_(std::move(writer)) {}
+        std::shared_ptr<rpp::ILogWriter> create_console_writer() override { return writer_; }
+        std::shared_ptr<rpp::ILogWriter> create_file_writer() override { return writer_; }
+
+    private:
+        std::shared_ptr<rpp::ILogWriter> writer_;
+    };
+    EXPECT_CALL(*mockClock, datetime_compact_string)
+            .WillRepeatedly(Return(expected_DTC));
+    rpp::set_instance(std::make_shared<FileOnlyFactory>(mockLogWriter));
+    EXPECT_CALL(*mockLogWriter, write(_)).Times(AnyNumber());
+    EXPECT_CALL(*mockLogWriter, close()).Times(2);
+    EXPECT_CALL(*mockLogWriter, open(_)).Times(2);
+
+    // Act
+    log_set_file_writer_type(rpp::file_writer_type::MMAP);
+    log_set_file("log.txt");
+    rpp::log_durability_policy policy;
+    policy.mode = rpp::log_durability::GROUP_COMMIT;
+    log_set_file_writer_type(rpp::file_writer_type::STREAM);
+    log_set_durability(policy);
+
+    // Assert
+}
+
+TEST_F(Logger_tests, logger_log_set_file_creates_mmap_file_writer)
+{
+    // Arrange
+    set_default_expectations();
+    create_test_log_instance();
+    EXPECT_CALL(*mockLogWriter, close());
+    EXPECT_CALL(*mockLogWriterFactory, create_mmap_file_writer())
+            .WillOnce(Return(mockLogWriter));
+    EXPECT_CALL(*mockLogWriter, open(_));
+
+    // Act
+    log_set_file_writer_type(rpp::file_writer_type::MMAP);
+    log_set_file("log.txt");
+
+    // Assert
+}
+
+TEST_F(Logger_tests, logger_log_set_file_creates_uring_file_writer)
+{
+    // Arrange
+    set_default_expectations();
+    create_test_log_instance();
+    EXPECT_CALL(*mockLogWriter, close());
+    EXPECT_CALL(*mockLogWriterFactory, create_uring_file_writer())
+            .WillOnce(Return(mockLogWriter));
+    EXPECT_CALL(*mockLogWriter, open(_));
+
+    // Act
+    log_set_file_writer_type(rpp::file_writer_type::URING);
+    log_set_file("log.txt");
+
+    // Assert
+}
+
+TEST_F(Logger_tests, logger_durability_creates_durable_writer_and_syncs_errors)
+{
+    // Arrange
+    EXPECT_CALL(*mockClock, datetime_compact_string)
+            .WillRepeatedly(Return(expected_DTC));
+    create_test_log_instance();
+    rpp::log_durability_policy policy;
+    policy.mode = rpp::log_durability::GROUP_COMMIT;
+    EXPECT_CALL(*mockLogWriter, close());
+    EXPECT_CALL(*mockLogWriterFactory, create_durable_file_writer(_))
+            .WillOnce(Return(mockLogWriter));
+    EXPECT_CALL(*mockLogWriter, open(_));
+    EXPECT_CALL(*mockLogWriter, sync())
+            .Times(1);
+
+    // Act
+    log_set_durability(policy);
+    log_set_file("log.txt");
+    r_warn("Warning");
+    r_err("Error");
+
+    // Assert
+}
+
+TEST_F(Logger_tests, logger_rotates_log_file_by_size)
+{
+    // Arrange
+    EXPECT_CALL(*mockClock, datetime_compact_string)
+            .WillRepeatedly(Return(expected_DTC));
+    rpp::clear_instance();
+    rpp::log_rotation_policy policy;
+    policy.max_bytes = 1;
+    policy.keep = 10;
+    std::filesystem::path rotated(filename_ + ".1");
+    remove(rotated.c_str());
+
+    // Act
+    log_set_file(filename_);
+    log_set_rotation(policy);
+    r_info("Rotated");
+    log_set_rotation(rpp::log_rotation_policy());
+
+    // Assert
+    ASSERT_TRUE(std::filesystem::exists(rotated));
+    for (const auto& [index, path] : rpp::RotatingLogWriter::rotated_files(filename_))
+        remove(path.c_str());
+}
+
+TEST_F(Logger_tests, logger_writes_line_larger_than_line_buffer)
+{
+    // Arrange
+    set_default_expectations();
+    create_test_log_instance();
+    std::string large(rpp::Logger::line_buffer_size * 2, 'x');
+
+    // Act
+    r_info("%s-end", large.c_str());
+
+    // Assert
+    ASSERT_THAT(log_buffer, HasSubstr(large + "-end\n"));
+    ASSERT_THAT(log_buffer, StartsWith(expected_DTC + ", II, "));
+}
+
+TEST_F(Logger_tests, logger_outputs_compile_time_format)
+{
+    // Arrange
+    set_default_expectations();
+    create_test_log_instance();
+
+    // Act
+    r_info(RPP_FMT("speed %d, %.1f %s"), 12, 0.5, "m/s");
+
+    // Assert
+    ASSERT_THAT(log_buffer, EndsWith(", speed 12, 0.5 m/s\n"));
+    ASSERT_THAT(log_buffer, StartsWith(expected_DTC + ", II, "));
+}
+
+TEST_F(Logger_tests, logger_outputs_key_value_record_as_text)
+{
+    // Arrange
+    set_default_expectations();
+    create_test_log_instance();
+
+    // Act
+    r_info_kv("motor", {"rpm", 1200}, {"current", 3.5});
+
+    // Assert
+    ASSERT_THAT(log_buffer, StartsWith(expected_DTC + ", II, "));
+    ASSERT_THAT(log_buffer, EndsWith(", motor rpm=1200 current=3.5\n"));
+}
+
+TEST_F(Logger_tests, logger_outputs_json_lines)
+{
+    // Arrange
+    create_test_log_instance();
+    EXPECT_CALL(*mockClock, timestamp)
+            .WillRepeatedly(Return(42));
+    log_set_application("rover");
+    log_set_record_format(rpp::log_record_format::JSON_LINES);
+
+    // Act
+    r_warn_kv("battery", {"level", 0.25});
+    r_err("Message %d", 1);
+
+    // Assert
+    ASSERT_THAT(log_buffer, StartsWith("{\"time\":42,\"level\":\"WARNING\",\"app\":\"rover\","));
+    ASSERT_THAT(log_buffer, HasSubstr("\"event\":\"battery\",\"fields\":{\"level\":0.25}}\n"));
+    ASSERT_THAT(log_buffer, EndsWith("\"msg\":\"Message 1\"}\n"));
+}
+
+TEST_F(Logger_tests, instance_is_stable_until_replaced)
+{
+    // Arrange
+    create_test_log_instance();
+    const auto& first = rpp::Logger::Instance();
+    auto first_logger = first.get();
+
+    // Act
+    auto second_logger = rpp::Logger::Instance().get();
+    create_test_log_instance();
+    auto replaced_logger = rpp::Logger::Instance().get();
+
+    // Assert
+    ASSERT_EQ(first_logger, second_logger);
+    ASSERT_EQ(&first, &rpp::Logger::Instance());
+    ASSERT_NE(replaced_logger, first_logger);
+}
@@ -0,0 +1,202 @@
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "MPMCQueue.h"
+
+#include "gtest/gtest.h"
+
+class MPMCQueue_tests : public ::testing::Test
+{
+protected:
+    MPMCQueue_tests() = default;
+
+    ~MPMCQueue_tests() override = default;
+
+    void SetUp() override
+    {
+    }
+
+    void TearDown() override
+    {
+    }
+};
+
+TEST_F(MPMCQueue_tests, pops_items_in_push_order)
+{
+    // Arrange
+    MPMCQueue<std::string> queue(8);
+    IThreadsafeQueue<std::string>& interface = queue;
+
+    // Act
+    interface.push("one");
+    interface.push("two");
+    auto size = interface.size();
+    auto first = interface.pop();
+    auto second = interface.pop();
+    auto empty = interface.pop();
+
+    // Assert
+    ASSERT_EQ(size, 2u);
+    ASSERT_EQ(first, "one");
+    ASSERT_EQ(second, "two");
+    ASSERT_FALSE(empty.has_value());
+}
+
+TEST_F(MPMCQueue_tests, try_push_fails_when_full)
+{
+    // Arrange
+    MPMCQueue<int> queue(3);
+
+    // Act
+    for (int i = 0; i < 4; i++)
+        ASSERT_TRUE(queue.try_push(i));
+    bool pushed = queue.try_push(4);
+    queue.pop();
+    bool pushed_after_pop = queue.try_push(4);
+
+    // Assert
+    ASSERT_EQ(queue.capacity(), 4u);
+    ASSERT_FALSE(pushed);
+    ASSERT_TRUE(pushed_after_pop);
+}
+
+TEST_F(MPMCQueue_tests, destructor_destroys_remaining_items)
+{
+    // Arrange
+    auto item = std::make_shared<int>(1);
+
+    // Act
+    {
+        MPMCQueue<std::shared_ptr<int>> queue(4);
+        queue.push(item);
+        queue.push(item);
+        queue.pop();
+    }
+
+    // Assert
+    ASSERT_EQ(item.use_count(), 1);
+}
+
+TEST_F(MPMCQueue_tests, concurrent_producers_and_consumers_pass_every_item_once)
+{
+    // Arrange
+    constexpr int producers = 4;
+    constexpr int items_per_producer = 5000;
+    MPMCQueue<int> queue(64);
+    std::vector<std::vector<int>> received(producers);
+    std::atomic<int> remaining(producers * items_per_producer);
+    std::vector<std::thread> threads;
+
+    // Act
+    for (int p = 0; p < producers; p++) {
+        threads.emplace_back([&queue, p] {
+            for (int i = 0; i < items_per_producer; i++)
+                queue.push(p * items_per_producer + i);
+        });
+        threads.emplace_back([&queue, &received, &remaining, p] {
+            while (remaining.load() > 0) {
+                auto item = queue.pop();
+                if (item) {
+                    received[static_cast<size_t>(p)].push_back(*item);
+                    remaining--;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    // Assert
+    std::vector<int> all;
+    for (const auto& items : received) {
+        // Each consumer sees the items of one producer in order.
+        for (int p = 0; p < producers; p++) {
+            std::vector<int> from_producer;
+            std::copy_if(items.begin(), items.end(), std::back_inserter(from_producer), [p](int item) {
+                return item / items_per_producer == p;
+            });
+            ASSERT_TRUE(std::is_sorted(from_producer.begin(), from_producer.end()));
+        }
+        all.insert(all.end(), items.begin(), items.end());
+    }
+    std::sort(all.begin(), all.end());
+    ASSERT_EQ(all.size(), static_cast<size_t>(producers * items_per_producer));
+    for (size_t i = 0; i < all.size(); i++)
+        ASSERT_EQ(all[i], static_cast<int>(i));
+}
+
+TEST_F(MPMCQueue_tests, push_bulk_and_try_drain_wrap_around_the_ring)
+{
+    // Arrange
+    MPMCQueue<int> queue(4);
+    std::vector<int> items{1, 2, 3, 4, 5, 6};
+    std::vector<int> drained;
+    queue.push(0);
+    queue.pop();
+
+    // Act
+    queue.push_bulk(items.begin(), items.begin() + 3);
+    size_t first = queue.try_drain(std::back_inserter(drained), 2);
+    queue.push_bulk(items.begin() + 3, items.end());
+    size_t rest = queue.drain_all(drained);
+
+    // Assert
+    ASSERT_EQ(first, 2u);
+    ASSERT_EQ(rest, 4u);
+    ASSERT_EQ(drained, items);
+    ASSERT_EQ(queue.try_drain(std::back_inserter(drained), 4), 0u);
+}
+
+TEST_F(MPMCQueue_tests, try_drain_stops_at_unpublished_items)
+{
+    // Arrange
+    MPMCQueue<std::string> queue(8);
+    std::vector<std::string> drained;
+    queue.push("a");
+    queue.push("b");
+
+    // Act
+    size_t count = queue.try_drain(std::back_inserter(drained), 8);
+
+    // Assert
+    ASSERT_EQ(count, 2u);
+    ASSERT_EQ(drained, (std::vector<std::string>{"a", "b"}));
+    ASSERT_TRUE(queue.try_push("c"));
+}
+
+TEST_F(MPMCQueue_tests, try_drain_of_zero_items_returns_at_once)
+{
+    // Arrange
+    MPMCQueue<int> queue(4);
+    std::vector<int> drained;
+    queue.push(1);
+
+    // Act
+    size_t count = queue.try_drain(std::back_inserter(drained), 0);
+
+    // Assert
+    ASSERT_EQ(count, 0u);
+    ASSERT_TRUE(drained.empty());
+    ASSERT_EQ(queue.size(), 1u);
+}
+
+TEST_F(MPMCQueue_tests, moves_move_only_items_through_the_queue)
+{
+    // Arrange
+    MPMCQueue<std::unique_ptr<int>> queue(4);
+
+    // Act
+    queue.push(std::make_unique<int>(1));
+    queue.emplace(new int(2));
+    auto first = queue.pop();
+    auto second = queue.pop();
+
+    // Assert
+    ASSERT_EQ(**first, 1);
+    ASSERT_EQ(**second, 2);
+}
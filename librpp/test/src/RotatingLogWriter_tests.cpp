@@ -0,0 +1,173 @@
+#include <string>
+#include "RotatingLogWriter.h"
+#include "LogWriter.h"
+#include "FileUtils.h"
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "ClockAccessor.h"
+#include "mock_clock.h"
+
+using namespace testing;
+
+class RotatingLogWriter_tests : public ::testing::Test
+{
+protected:
+    RotatingLogWriter_tests() : directory_("rotation_test"), path_(directory_ / "log.txt") {
+    }
+
+    ~RotatingLogWriter_tests() override = default;
+
+    void SetUp() override
+    {
+        std::filesystem::remove_all(directory_);
+        std::filesystem::create_directory(directory_);
+    }
+
+    void TearDown() override
+    {
+        rpp::ClockAccessor::SetInstance(nullptr);
+        std::filesystem::remove_all(directory_);
+    }
+
+    static std::shared_ptr<rpp::ILogWriter> create_writer()
+    {
+        return std::make_shared<rpp::FileLogWriter>();
+    }
+
+    std::filesystem::path rotated(int index)
+    {
+        std::filesystem::path path = path_;
+        path += "." + std::to_string(index);
+        return path;
+    }
+
+    const std::filesystem::path directory_;
+    const std::filesystem::path path_;
+};
+
+TEST_F(RotatingLogWriter_tests, rotates_when_max_bytes_reached)
+{
+    // Arrange
+    rpp::log_rotation_policy policy;
+    policy.max_bytes = 12;
+    rpp::RotatingLogWriter writer(create_writer, policy);
+
+    // Act
+    writer.open(path_.string());
+    writer.write("Line1\n");
+    writer.write("Line2\n");
+    writer.write("Line3\n");
+    writer.close();
+    writer.flush();
+
+    // Assert
+    ASSERT_EQ(FileUtils::TryReadFileAsString(rotated(1)), "Line1\nLine2\n");
+    ASSERT_EQ(FileUtils::TryReadFileAsString(path_), "Line3\n");
+}
+
+TEST_F(RotatingLogWriter_tests, keeps_only_newest_rotated_files)
+{
+    // Arrange
+    rpp::log_rotation_policy policy;
+    policy.max_bytes = 1;
+    policy.keep = 2;
+    rpp::RotatingLogWriter writer(create_writer, policy);
+
+    // Act
+    writer.open(path_.string());
+    for (int i = 1; i <= 5; i++)
+        writer.write("Line" + std::to_string(i) + "\n");
+    writer.flush();
+
+    // Assert
+    auto files = rpp::RotatingLogWriter::rotated_files(path_);
+    ASSERT_EQ(files.size(), 2u);
+    ASSERT_EQ(files[0].first, 4u);
+    ASSERT_EQ(FileUtils::TryReadFileAsString(rotated(5)), "Line5\n");
+}
+
+TEST_F(RotatingLogWriter_tests, rotates_when_interval_elapsed)
+{
+    // Arrange
+    auto mockClock = std::make_shared<rpp::MockClock>();
+    rpp::ClockAccessor::SetInstance(mockClock);
+    EXPECT_CALL(*mockClock, time())
+            .WillOnce(Return(100.0))
+            .WillOnce(Return(105.0))
+            .WillRepeatedly(Return(110.0));
+    rpp::log_rotation_policy policy;
+    policy.interval = std::chrono::seconds(10);
+    rpp::RotatingLogWriter writer(create_writer, policy);
+
+    // Act
+    writer.open(path_.string());
+    writer.write("Line1\n");
+    writer.write("Line2\n");
+    writer.write("Line3\n");
+    writer.flush();
+
+    // Assert
+    ASSERT_EQ(FileUtils::TryReadFileAsString(rotated(1)), "Line1\nLine2\n");
+    ASSERT_EQ(FileUtils::TryReadFileAsString(path_), "Line3\n");
+}
+
+TEST_F(RotatingLogWriter_tests, archiver_receives_closed_file)
+{
+    // Arrange
+    std::vector<std::string> archived;
+    rpp::log_rotation_policy policy;
+    policy.max_bytes = 1;
+    policy.archiver = [&archived](const std::filesystem::path& path) {
+        archived.push_back(FileUtils::TryReadFileAsString(path));
+    };
+    rpp::RotatingLogWriter writer(create_writer, policy);
+
+    // Act
+    writer.open(path_.string());
+    writer.write_batch({"Line1\n", "Line2\n"});
+    writer.flush();
+
+    // Assert
+    ASSERT_EQ(archived, std::vector<std::string>({"Line1\nLine2\n"}));
+}
+
+TEST_F(RotatingLogWriter_tests, continues_numbering_after_existing_files)
+{
+    // Arrange
+    FileUtils::TryWriteStringAsFile(rotated(7), "Old\n");
+    FileUtils::TryWriteStringAsFile(directory_ / "log.txt.backup", "Other\n");
+    rpp::log_rotation_policy policy;
+    policy.max_bytes = 1;
+    rpp::RotatingLogWriter writer(create_writer, policy);
+
+    // Act
+    writer.open(path_.string());
+    writer.write("Line1\n");
+    writer.flush();
+
+    // Assert
+    ASSERT_EQ(FileUtils::TryReadFileAsString(rotated(8)), "Line1\n");
+    ASSERT_TRUE(std::filesystem::exists(directory_ / "log.txt.backup"));
+}
+
+TEST_F(RotatingLogWriter_tests, rotates_mmap_log_by_bytes_written)
+{
+    // Arrange
+    rpp::log_rotation_policy policy;
+    policy.max_bytes = 12;
+    rpp::RotatingLogWriter writer([]() { return std::make_shared<rpp::MmapLogWriter>(); }, policy);
+
+    // Act
+    writer.open(path_.string());
+    writer.write("Line1\n");
+    writer.write("Line2\n");
+    writer.write("Line3\n");
+    writer.close();
+    writer.flush();
+
+    // Assert
+    ASSERT_EQ(FileUtils::TryReadFileAsString(rotated(1)), "Line1\nLine2\n");
+    ASSERT_EQ(FileUtils::TryReadFileAsString(path_), "Line3\n");
+    ASSERT_FALSE(std::filesystem::exists(directory_ / "log.txt.next"));
+}
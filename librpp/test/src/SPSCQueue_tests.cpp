@@ -0,0 +1,199 @@
+#include <iterator>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "SPSCQueue.h"
+
+#include "gtest/gtest.h"
+
+class SPSCQueue_tests : public ::testing::Test
+{
+protected:
+    SPSCQueue_tests() = default;
+
+    ~SPSCQueue_tests() override = default;
+
+    void SetUp() override
+    {
+    }
+
+    void TearDown() override
+    {
+    }
+};
+
+TEST_F(SPSCQueue_tests, pops_items_in_push_order)
+{
+    // Arrange
+    SPSCQueue<std::string> queue(8);
+    IThreadsafeQueue<std::string>& interface = queue;
+
+    // Act
+    interface.push("one");
+    interface.push("two");
+    auto size = interface.size();
+    auto first = interface.pop();
+    auto second = interface.pop();
+    auto empty = interface.pop();
+
+    // Assert
+    ASSERT_EQ(size, 2u);
+    ASSERT_EQ(first, "one");
+    ASSERT_EQ(second, "two");
+    ASSERT_FALSE(empty.has_value());
+}
+
+TEST_F(SPSCQueue_tests, runtime_capacity_is_rounded_up)
+{
+    // Arrange
+    SPSCQueue<int> queue(5);
+
+    // Act
+    for (int i = 0; i < 8; i++)
+        ASSERT_TRUE(queue.try_push(i));
+    bool pushed = queue.try_push(8);
+
+    // Assert
+    ASSERT_EQ(queue.capacity(), 8u);
+    ASSERT_FALSE(pushed);
+}
+
+TEST_F(SPSCQueue_tests, compile_time_capacity_wraps_around)
+{
+    // Arrange
+    SPSCQueue<int, 4> queue;
+    int expected = 0;
+
+    // Act
+    for (int i = 0; i < 4; i++)
+        queue.push(i);
+    bool pushed_when_full = queue.try_push(4);
+    for (int i = 4; i < 100; i++) {
+        ASSERT_EQ(queue.pop(), expected++);
+        queue.push(i);
+    }
+
+    // Assert
+    ASSERT_EQ(queue.capacity(), 4u);
+    ASSERT_FALSE(pushed_when_full);
+    ASSERT_EQ(queue.size(), 4u);
+}
+
+TEST_F(SPSCQueue_tests, destructor_destroys_remaining_items)
+{
+    // Arrange
+    auto item = std::make_shared<int>(1);
+
+    // Act
+    {
+        SPSCQueue<std::shared_ptr<int>, 4> queue;
+        queue.push(item);
+        queue.push(item);
+        queue.pop();
+    }
+
+    // Assert
+    ASSERT_EQ(item.use_count(), 1);
+}
+
+TEST_F(SPSCQueue_tests, consumer_thread_receives_items_in_order)
+{
+    // Arrange
+    constexpr uint64_t items = 100000;
+    SPSCQueue<uint64_t, 64> queue;
+    uint64_t next = 0;
+    bool in_order = true;
+
+    // Act
+    std::thread consumer([&queue, &next, &in_order] {
+        while (next < items) {
+            auto item = queue.pop();
+            if (!item) {
+                std::this_thread::yield();
+                continue;
+            }
+            in_order = in_order && (*item == next);
+            next++;
+        }
+    });
+    for (uint64_t i = 0; i < items; i++)
+        queue.push(i);
+    consumer.join();
+
+    // Assert
+    ASSERT_TRUE(in_order);
+    ASSERT_EQ(next, items);
+}
+
+TEST_F(SPSCQueue_tests, push_bulk_and_try_drain_wrap_around_the_ring)
+{
+    // Arrange
+    SPSCQueue<int, 4> queue;
+    std::vector<int> items{1, 2, 3, 4, 5, 6};
+    std::vector<int> drained;
+    queue.push(0);
+    queue.pop();
+
+    // Act
+    queue.push_bulk(items.begin(), items.begin() + 3);
+    size_t first = queue.try_drain(std::back_inserter(drained), 2);
+    queue.push_bulk(items.begin() + 3, items.end());
+    size_t rest = queue.drain_all(drained);
+
+    // Assert
+    ASSERT_EQ(first, 2u);
+    ASSERT_EQ(rest, 4u);
+    ASSERT_EQ(drained, items);
+    ASSERT_EQ(queue.try_drain(std::back_inserter(drained), 4), 0u);
+}
+
+TEST_F(SPSCQueue_tests, consumer_thread_drains_bulk_pushes_in_order)
+{
+    // Arrange
+    constexpr uint64_t items = 100000;
+    SPSCQueue<uint64_t, 64> queue;
+    uint64_t next = 0;
+    bool in_order = true;
+
+    // Act
+    std::thread consumer([&queue, &next, &in_order] {
+        std::vector<uint64_t> drained;
+        while (next < items) {
+            drained.clear();
+            if (queue.try_drain(std::back_inserter(drained), 48) == 0) {
+                std::this_thread::yield();
+                continue;
+            }
+            for (uint64_t item : drained)
+                in_order = in_order && (item == next++);
+        }
+    });
+    std::vector<uint64_t> batch(100);
+    for (uint64_t i = 0; i < items; i += batch.size()) {
+        for (size_t j = 0; j < batch.size(); j++)
+            batch[j] = i + j;
+        queue.push_bulk(batch.begin(), batch.end());
+    }
+    consumer.join();
+
+    // Assert
+    ASSERT_TRUE(in_order);
+    ASSERT_EQ(next, items);
+}
+
+TEST_F(SPSCQueue_tests, moves_move_only_items_through_the_queue)
+{
+    // Arrange
+    SPSCQueue<std::unique_ptr<int>, 4> queue;
+
+    // Act
+    queue.push(std::make_unique<int>(1));
+    queue.emplace(new int(2));
+    auto first = queue.pop();
+    auto second = queue.pop();
+
+    // Assert
+    ASSERT_EQ(**first, 1);
+    ASSERT_EQ(**second, 2);
+}
@@ -0,0 +1,219 @@
+#include <cerrno>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "SocketLogWriter.h"
+#include "Linux.h"
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "mock_linux.h"
+#include "mock_logwriter.h"
+
+using namespace testing;
+
+class SocketLogWriter_tests : public ::testing::Test
+{
+protected:
+    SocketLogWriter_tests() : mockLinux(std::make_shared<rpp::MockLinux>()), packets() {
+    }
+
+    ~SocketLogWriter_tests() override = default;
+
+    void expect_connect()
+    {
+        EXPECT_CALL(*mockLinux, socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0))
+                .WillOnce(Return(fd));
+        EXPECT_CALL(*mockLinux, connect(fd, _, _))
+                .WillOnce(Return(0));
+        EXPECT_CALL(*mockLinux, close(fd))
+                .WillOnce(Return(0));
+    }
+
+    void capture_packets()
+    {
+        EXPECT_CALL(*mockLinux, send(fd, _, _, MSG_DONTWAIT | MSG_NOSIGNAL))
+                .WillRepeatedly(Invoke([this](int, const void* data, size_t size, int) {
+                    packets.emplace_back(static_cast<const char*>(data), size);
+                    return static_cast<ssize_t>(size);
+                }));
+    }
+
+    static constexpr int fd = 7;
+    std::shared_ptr<rpp::MockLinux> mockLinux;
+    std::vector<std::string> packets;
+};
+
+TEST_F(SocketLogWriter_tests, write_sends_one_packet)
+{
+    // Arrange
+    expect_connect();
+    capture_packets();
+    rpp::SocketLogWriter writer(mockLinux);
+
+    // Act
+    writer.open("/tmp/collector.sock");
+    writer.write_line("Line1\n");
+
+    // Assert
+    ASSERT_TRUE(writer.connected());
+    ASSERT_THAT(packets, ElementsAre("Line1\n"));
+}
+
+TEST_F(SocketLogWriter_tests, batch_is_packed_without_splitting_lines)
+{
+    // Arrange
+    expect_connect();
+    capture_packets();
+    rpp::SocketLogWriter writer(mockLinux, 16);
+    writer.open("/tmp/collector.sock");
+
+    // Act
+    writer.write_batch({"Line1\n", "Line2\n", "Line3\n", "A much longer line\n"});
+
+    // Assert
+    ASSERT_THAT(packets, ElementsAre("Line1\nLine2\n", "Line3\n", "A much longer line\n"));
+}
+
+TEST_F(SocketLogWriter_tests, line_longer_than_collector_packet_is_dropped)
+{
+    // Arrange
+    expect_connect();
+    capture_packets();
+    rpp::SocketLogWriter writer(mockLinux, 2 * rpp::SocketLogWriter::max_packet_size);
+    std::string line(rpp::SocketLogWriter::max_packet_size + 10, 'x');
+    line += "\n";
+
+    // Act
+    writer.open("collector.sock");
+    writer.write_line("Line1\n");
+    writer.write_line(line);
+    writer.write_line("Line2\n");
+
+    // Assert
+    ASSERT_EQ(writer.dropped(), 1u);
+    ASSERT_THAT(packets, ElementsAre("Line1\n", "SocketLogWriter dropped 1 log records\n", "Line2\n"));
+}
+
+TEST_F(SocketLogWriter_tests, full_socket_drops_and_counts_lines)
+{
+    // Arrange
+    expect_connect();
+    EXPECT_CALL(*mockLinux, send(fd, _, _, _))
+            .WillOnce(Invoke([](int, const void*, size_t, int) {
+                errno = EAGAIN;
+                return static_cast<ssize_t>(-1);
+            }))
+            .WillRepeatedly(Invoke([this](int, const void* data, size_t size, int) {
+                packets.emplace_back(static_cast<const char*>(data), size);
+                return static_cast<ssize_t>(size);
+            }));
+    rpp::SocketLogWriter writer(mockLinux);
+    writer.open("/tmp/collector.sock");
+
+    // Act
+    writer.write("Line1\nLine2\n");
+    writer.write_line("Line3\n");
+
+    // Assert
+    ASSERT_TRUE(writer.connected());
+    ASSERT_EQ(writer.dropped(), 2u);
+    ASSERT_THAT(packets, ElementsAre("SocketLogWriter dropped 2 log records\n", "Line3\n"));
+}
+
+TEST_F(SocketLogWriter_tests, missing_collector_drops_without_blocking)
+{
+    // Arrange
+    EXPECT_CALL(*mockLinux, socket(_, _, _))
+            .WillOnce(Return(fd));
+    EXPECT_CALL(*mockLinux, connect(fd, _, _))
+            .WillOnce(Invoke([](int, const sockaddr*, socklen_t) {
+                errno = ENOENT;
+                return -1;
+            }));
+    EXPECT_CALL(*mockLinux, close(fd))
+            .WillOnce(Return(0));
+    EXPECT_CALL(*mockLinux, send(_, _, _, _))
+            .Times(0);
+    rpp::SocketLogWriter writer(mockLinux);
+
+    // Act
+    writer.open("/tmp/collector.sock");
+    writer.write_line("Line1\n");
+    writer.write_line("Line2\n");
+
+    // Assert
+    ASSERT_FALSE(writer.connected());
+    ASSERT_EQ(writer.dropped(), 2u);
+}
+
+TEST_F(SocketLogWriter_tests, collector_receives_lines_from_writers)
+{
+    // Arrange
+    auto linux = std::make_shared<rpp::Linux>();
+    auto output = std::make_shared<rpp::MockLogWriter>();
+    std::string log_buffer;
+    EXPECT_CALL(*output, write(_))
+            .WillRepeatedly(Invoke([&log_buffer](const std::string& message) {
+                log_buffer += message;
+            }));
+    std::string path = "socket_log_writer_test.sock";
+    rpp::LogCollector collector(linux, output);
+    collector.listen(path);
+    rpp::SocketLogWriter first(linux);
+    rpp::SocketLogWriter second(linux);
+    first.open(path);
+    second.open(path);
+    collector.poll(100);
+    collector.poll(100);
+
+    // Act
+    first.write_line("First\n");
+    second.write_batch({"Second1\n", "Second2\n"});
+    size_t packets = collector.poll(100) + collector.poll(10);
+
+    // Assert
+    ASSERT_EQ(collector.clients(), 2u);
+    ASSERT_EQ(packets, 2u);
+    ASSERT_THAT(log_buffer, HasSubstr("First\n"));
+    ASSERT_THAT(log_buffer, HasSubstr("Second1\nSecond2\n"));
+    ASSERT_EQ(first.dropped() + second.dropped(), 0u);
+}
+
+TEST_F(SocketLogWriter_tests, collector_drops_and_counts_packet_too_large)
+{
+    // Arrange
+    auto linux = std::make_shared<rpp::Linux>();
+    auto output = std::make_shared<rpp::MockLogWriter>();
+    std::string log_buffer;
+    EXPECT_CALL(*output, write(_))
+            .WillRepeatedly(Invoke([&log_buffer](const std::string& message) {
+                log_buffer += message;
+            }));
+    std::string path = "socket_log_writer_test.sock";
+    rpp::LogCollector collector(linux, output);
+    collector.listen(path);
+    int client = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    path.copy(address.sun_path, sizeof(address.sun_path) - 1);
+    int connected = connect(client, reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+    collector.poll(100);
+    std::string large(rpp::LogCollector::max_packet_size + 1, 'x');
+
+    // Act
+    ssize_t sent = send(client, large.data(), large.size(), 0);
+    ssize_t next = send(client, "Next\n", 5, 0);
+    collector.poll(100);
+    close(client);
+
+    // Assert
+    ASSERT_EQ(connected, 0);
+    ASSERT_EQ(sent, static_cast<ssize_t>(large.size()));
+    ASSERT_EQ(next, 5);
+    ASSERT_EQ(collector.dropped(), 1u);
+    ASSERT_THAT(log_buffer, HasSubstr("dropped a log packet of 65537 bytes\n"));
+    ASSERT_THAT(log_buffer, EndsWith("Next\n"));
+    ASSERT_THAT(log_buffer, Not(HasSubstr("xxx")));
+}
@@ -0,0 +1,161 @@
+#include <cfloat>
+#include <climits>
+#include <cstdio>
+#include <string>
+#include "StringUtils.h"
+
+#include "gtest/gtest.h"
+
+class string_format_tests : public ::testing::Test
+{
+protected:
+    string_format_tests() = default;
+
+    ~string_format_tests() override = default;
+
+    void SetUp() override
+    {
+    }
+
+    void TearDown() override
+    {
+    }
+
+    template <typename ...Args>
+    static std::string printf_format(const char* format, Args ...args)
+    {
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wformat-nonliteral"
+        char buffer[2048];
+        snprintf(buffer, sizeof(buffer), format, args...);
+#pragma GCC diagnostic pop
+        return buffer;
+    }
+
+    template <typename ...Args>
+    static void expect_printf_output(const char* format, Args ...args)
+    {
+        std::string actual;
+        ASSERT_TRUE(StringUtils::format_to(actual, format, args...)) << format;
+        ASSERT_EQ(actual, printf_format(format, args...)) << format;
+    }
+};
+
+TEST_F(string_format_tests, integers_match_printf)
+{
+    // Arrange
+    // Act
+    // Assert
+    expect_printf_output("%d|%i|%u", 42, -42, 42u);
+    expect_printf_output("%5d|%-5d|%05d|%+d|% d", 42, 42, -42, 42, 42);
+    expect_printf_output("%.3d|%8.3d|%.0d|%#o|%#x|%#X|%x", 7, -7, 0, 8, 255, 255, -1);
+    expect_printf_output("%ld|%lld|%lu|%zu|%hhd|%hu", LONG_MIN, LLONG_MAX, ULONG_MAX, sizeof(int), 300, 70000);
+    expect_printf_output("%c|%3c|%-3c|", 'a', 'b', 'c');
+}
+
+TEST_F(string_format_tests, floats_match_printf)
+{
+    // Arrange
+    // Act
+    // Assert
+    expect_printf_output("%f|%.2f|%8.3f|%-8.1f|%08.2f|%+.1f", 3.14159, 2.005, -1.5, 1.25, -3.5, 2.0);
+    expect_printf_output("%e|%.3E|%g|%G|%.10g|%g", 12345.678, 0.000123, 0.0001, 1e20, 1.0 / 3, 100000.0);
+    expect_printf_output("%#.0f|%#.0e|%a|%A|%.2a", 3.0, 3.0, 1.5, -0.25, 1.0);
+    expect_printf_output("%f|%f|%5f|%05f", INFINITY, -INFINITY, NAN, INFINITY);
+}
+
+TEST_F(string_format_tests, floats_with_largest_precision_match_printf)
+{
+    // Arrange
+    // Act
+    auto actual = StringUtils::string_format(RPP_FMT("[%.600f]"), 1.0);
+
+    // Assert
+    ASSERT_EQ(actual, printf_format("[%.600f]", 1.0));
+    expect_printf_output("%.1000f", -DBL_MAX);
+    expect_printf_output("%+.1000e|%#.1000a", DBL_MAX, -DBL_MAX);
+    expect_printf_output("%.1000d|%#.1000x", INT_MIN, UINT_MAX);
+}
+
+TEST_F(string_format_tests, strings_and_pointers_match_printf)
+{
+    // Arrange
+    int value = 0;
+    const char* null_string = nullptr;
+
+    // Act
+    // Assert
+    expect_printf_output("%s|%10s|%-10s|%.2s|%%|100%%", "abc", "right", "left", "truncate");
+    expect_printf_output("%p|%p|%20p", static_cast<void*>(&value), static_cast<void*>(nullptr), &value);
+    std::string actual;
+    StringUtils::format_to(actual, "%s", null_string);
+    ASSERT_EQ(actual, "(null)");
+}
+
+TEST_F(string_format_tests, formats_std_strings)
+{
+    // Arrange
+    std::string name("motor");
+    std::string_view unit("rpm");
+
+    // Act
+    auto actual = StringUtils::string_format(RPP_FMT("%s: %d %s"), name, 1200, unit);
+
+    // Assert
+    ASSERT_EQ(actual, "motor: 1200 rpm");
+}
+
+TEST_F(string_format_tests, compile_time_format_matches_runtime_format)
+{
+    // Arrange
+    // Act
+    auto actual = StringUtils::string_format(RPP_FMT("%-6s|%+08.3f|%#x|%%|%c"), "id", 3.14159, 48879u, 'z');
+
+    // Assert
+    ASSERT_EQ(actual, printf_format("%-6s|%+08.3f|%#x|%%|%c", "id", 3.14159, 48879u, 'z'));
+}
+
+TEST_F(string_format_tests, runtime_format_rejects_mismatched_arguments)
+{
+    // Arrange
+    std::string actual;
+
+    // Act
+    // Assert
+    ASSERT_FALSE(StringUtils::format_to(actual, "%d", 1.5));
+    ASSERT_FALSE(StringUtils::format_to(actual, "%d %d", 1));
+    ASSERT_FALSE(StringUtils::format_to(actual, "%d", 1, 2));
+    ASSERT_FALSE(StringUtils::format_to(actual, "%*d", 5, 1));
+    ASSERT_TRUE(actual.empty());
+}
+
+TEST_F(string_format_tests, string_format_of_runtime_format_uses_printf)
+{
+    // Arrange
+    std::string format("%d|%*d|%s");
+
+    // Act
+    auto actual = StringUtils::string_format(format, 3000000000u, 5, 42, "ok");
+
+    // Assert
+    ASSERT_EQ(actual, printf_format("%d|%*d|%s", 3000000000u, 5, 42, "ok"));
+}
+
+TEST_F(string_format_tests, format_buffer_moves_to_heap_when_full)
+{
+    // Arrange
+    StringUtils::FormatBuffer<8> buffer;
+
+    // Act
+    StringUtils::format_to(buffer, RPP_FMT("%d"), 1234);
+    std::string small(buffer.view());
+    StringUtils::format_to(buffer, RPP_FMT("-%s"), "overflowing");
+    std::string large(buffer.view());
+    buffer.clear();
+    StringUtils::format_to(buffer, RPP_FMT("%d"), 5);
+
+    // Assert
+    ASSERT_EQ(small, "1234");
+    ASSERT_EQ(large, "1234-overflowing");
+    ASSERT_EQ(buffer.view(), "5");
+}
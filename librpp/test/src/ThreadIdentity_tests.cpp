@@ -0,0 +1,109 @@
+#include <string>
+#include <thread>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include "ThreadIdentity.h"
+#include "Logger.h"
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "ClockAccessor.h"
+#include "mock_clock.h"
+#include "mock_logwriter.h"
+#include "mock_logwriterfactory.h"
+
+using namespace testing;
+
+namespace rpp {
+    // Defined in Logger_tests.cpp
+    void set_instance(const std::shared_ptr<rpp::ILogWriterFactory>& factory);
+    void clear_instance();
+}
+
+class ThreadIdentity_tests : public ::testing::Test
+{
+protected:
+    ThreadIdentity_tests() = default;
+    ~ThreadIdentity_tests() override = default;
+};
+
+TEST_F(ThreadIdentity_tests, identity_holds_kernel_tid)
+{
+    // Arrange
+    // Act
+    const auto& identity = rpp::ThreadIdentity::current();
+
+    // Assert
+    ASSERT_GT(identity.id(), 0u);
+    ASSERT_EQ(identity.tid(), static_cast<pid_t>(syscall(SYS_gettid)));
+    ASSERT_EQ(identity.field(), std::to_string(identity.id()) + ":" + std::to_string(identity.tid()));
+}
+
+TEST_F(ThreadIdentity_tests, threads_get_distinct_sequential_ids)
+{
+    // Arrange
+    uint32_t first = 0;
+    uint32_t second = 0;
+
+    // Act
+    std::thread([&first] { first = rpp::ThreadIdentity::current().id(); }).join();
+    std::thread([&second] { second = rpp::ThreadIdentity::current().id(); }).join();
+
+    // Assert
+    ASSERT_EQ(second, first + 1);
+    ASSERT_NE(first, rpp::ThreadIdentity::current().id());
+}
+
+TEST_F(ThreadIdentity_tests, name_is_cut_and_prefixes_the_field)
+{
+    // Arrange
+    std::string field;
+    std::string name;
+    std::string long_name(100, 'x');
+
+    // Act
+    std::thread([&field, &name, &long_name] {
+        rpp::set_thread_name("motor");
+        field = rpp::ThreadIdentity::current().field();
+        rpp::set_thread_name(long_name);
+        name = rpp::ThreadIdentity::current().name();
+    }).join();
+
+    // Assert
+    ASSERT_THAT(field, StartsWith("motor:"));
+    ASSERT_EQ(name.size(), rpp::ThreadIdentity::max_name_size);
+}
+
+TEST_F(ThreadIdentity_tests, log_lines_carry_the_thread_field)
+{
+    // Arrange
+    auto mockClock = std::make_shared<rpp::MockClock>();
+    auto mockLogWriterFactory = std::make_shared<rpp::MockLogWriterFactory>();
+    auto mockLogWriter = std::make_shared<rpp::MockLogWriter>();
+    std::string log_buffer;
+    std::string expected;
+    rpp::ClockAccessor::SetInstance(mockClock);
+    EXPECT_CALL(*mockClock, datetime_compact_string)
+            .WillRepeatedly(Return("DTC"));
+    EXPECT_CALL(*mockLogWriter, write(_))
+            .WillRepeatedly(Invoke([&log_buffer](const std::string& message) {
+                log_buffer += message;
+            }));
+    EXPECT_CALL(*mockLogWriterFactory, create_console_writer())
+            .WillOnce(Return(mockLogWriter));
+    rpp::set_instance(mockLogWriterFactory);
+
+    // Act
+    std::thread([&expected] {
+        rpp::set_thread_name("navigation");
+        expected = "DTC, II, ??, navigation:" + std::to_string(rpp::ThreadIdentity::current().id()) + ":"
+                   + std::to_string(rpp::ThreadIdentity::current().tid()) + ", Message\n";
+        r_info("Message");
+    }).join();
+
+    // Assert
+    ASSERT_EQ(log_buffer, expected);
+
+    rpp::ClockAccessor::SetInstance(nullptr);
+    rpp::clear_instance();
+}
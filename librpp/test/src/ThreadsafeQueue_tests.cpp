@@ -0,0 +1,225 @@
+#include <chrono>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include <poll.h>
+#include "ThreadsafeQueue.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+    template<typename Queue, typename Item, typename = void>
+    struct can_push_copy : std::false_type {};
+
+    template<typename Queue, typename Item>
+    struct can_push_copy<Queue, Item, std::void_t<decltype(std::declval<Queue&>().push(std::declval<const Item&>()))>>
+            : std::true_type {};
+
+    static_assert(can_push_copy<ThreadsafeQueue<int>, int>::value);
+    static_assert(!can_push_copy<ThreadsafeQueue<std::unique_ptr<int>>, std::unique_ptr<int>>::value);
+    static_assert(!can_push_copy<IThreadsafeQueue<std::unique_ptr<int>>, std::unique_ptr<int>>::value);
+}
+
+class ThreadsafeQueue_tests : public ::testing::Test
+{
+protected:
+    ThreadsafeQueue_tests() = default;
+
+    ~ThreadsafeQueue_tests() override = default;
+
+    void SetUp() override
+    {
+    }
+
+    void TearDown() override
+    {
+    }
+
+    static bool readable(int fd)
+    {
+        pollfd request{fd, POLLIN, 0};
+        return poll(&request, 1, 0) == 1 && (request.revents & POLLIN) != 0;
+    }
+};
+
+TEST_F(ThreadsafeQueue_tests, pop_wait_returns_item_pushed_while_waiting)
+{
+    // Arrange
+    ThreadsafeQueue<int> queue;
+
+    // Act
+    std::thread producer([&queue] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        queue.push(42);
+    });
+    auto item = queue.pop_wait(std::chrono::seconds(10));
+    producer.join();
+
+    // Assert
+    ASSERT_EQ(item, 42);
+}
+
+TEST_F(ThreadsafeQueue_tests, pop_wait_times_out_on_empty_queue)
+{
+    // Arrange
+    ThreadsafeQueue<int> queue;
+    auto start = std::chrono::steady_clock::now();
+
+    // Act
+    auto item = queue.pop_wait(std::chrono::milliseconds(20));
+    auto waited = std::chrono::steady_clock::now() - start;
+
+    // Assert
+    ASSERT_FALSE(item.has_value());
+    ASSERT_GE(waited, std::chrono::milliseconds(20));
+}
+
+TEST_F(ThreadsafeQueue_tests, readiness_fd_is_readable_while_queue_holds_items)
+{
+    // Arrange
+    ThreadsafeQueue<int> queue;
+    queue.push(1);
+    int fd = queue.readiness_fd();
+
+    // Act
+    bool ready_with_one = readable(fd);
+    queue.push(2);
+    queue.pop();
+    bool ready_with_two_popped_one = readable(fd);
+    queue.pop();
+    bool ready_when_empty = readable(fd);
+    queue.push(3);
+    bool ready_after_push = readable(fd);
+    queue.pop_wait(std::chrono::milliseconds(0));
+
+    // Assert
+    ASSERT_GE(fd, 0);
+    ASSERT_EQ(queue.readiness_fd(), fd);
+    ASSERT_TRUE(ready_with_one);
+    ASSERT_TRUE(ready_with_two_popped_one);
+    ASSERT_FALSE(ready_when_empty);
+    ASSERT_TRUE(ready_after_push);
+    ASSERT_FALSE(readable(fd));
+}
+
+TEST_F(ThreadsafeQueue_tests, moved_queue_takes_items_and_readiness_fd)
+{
+    // Arrange
+    ThreadsafeQueue<int> queue;
+    queue.push(1);
+    int fd = queue.readiness_fd();
+
+    // Act
+    ThreadsafeQueue<int> moved(std::move(queue));
+    auto item = moved.pop();
+    bool ready_when_empty = readable(fd);
+
+    // Assert
+    ASSERT_EQ(item, 1);
+    ASSERT_EQ(moved.readiness_fd(), fd);
+    ASSERT_FALSE(ready_when_empty);
+}
+
+TEST_F(ThreadsafeQueue_tests, try_drain_moves_at_most_max_items_in_order)
+{
+    // Arrange
+    ThreadsafeQueue<int> queue;
+    std::vector<int> items{1, 2, 3, 4, 5};
+    std::vector<int> drained;
+    queue.push_bulk(items.begin(), items.end());
+
+    // Act
+    size_t first = queue.try_drain(std::back_inserter(drained), 3);
+    size_t second = queue.try_drain(std::back_inserter(drained), 3);
+
+    // Assert
+    ASSERT_EQ(first, 3u);
+    ASSERT_EQ(second, 2u);
+    ASSERT_EQ(drained, items);
+    ASSERT_FALSE(queue.pop().has_value());
+}
+
+TEST_F(ThreadsafeQueue_tests, drain_all_empties_queue_and_clears_readiness_fd)
+{
+    // Arrange
+    ThreadsafeQueue<int> queue;
+    int fd = queue.readiness_fd();
+    std::vector<int> items{1, 2, 3};
+    std::vector<int> drained{0};
+    queue.push_bulk(items.begin(), items.end());
+    bool readable_after_push = readable(fd);
+
+    // Act
+    size_t count = queue.drain_all(drained);
+
+    // Assert
+    ASSERT_TRUE(readable_after_push);
+    ASSERT_FALSE(readable(fd));
+    ASSERT_EQ(count, 3u);
+    ASSERT_EQ(drained, (std::vector<int>{0, 1, 2, 3}));
+    ASSERT_EQ(queue.drain_all(drained), 0u);
+}
+
+TEST_F(ThreadsafeQueue_tests, moves_move_only_items_through_the_queue)
+{
+    // Arrange
+    ThreadsafeQueue<std::unique_ptr<int>> queue;
+    IThreadsafeQueue<std::unique_ptr<int>>& interface = queue;
+
+    // Act
+    interface.push(std::make_unique<int>(1));
+    queue.emplace(new int(2));
+    auto first = interface.pop();
+    auto second = queue.pop_wait(std::chrono::milliseconds(0));
+
+    // Assert
+    ASSERT_TRUE(first.has_value());
+    ASSERT_EQ(**first, 1);
+    ASSERT_TRUE(second.has_value());
+    ASSERT_EQ(**second, 2);
+}
+
+TEST_F(ThreadsafeQueue_tests, pooled_queue_keeps_order_across_wrap_and_growth)
+{
+    // Arrange
+    PooledThreadsafeQueue<std::string> queue(RingStorage<std::string>(4));
+    std::vector<std::string> drained;
+
+    // Act
+    queue.push("a");
+    queue.push("b");
+    queue.push("c");
+    queue.pop();
+    queue.pop();
+    for (const char* item : {"d", "e", "f", "g"})
+        queue.emplace(item);
+    queue.drain_all(drained);
+    queue.push("h");
+
+    // Assert
+    ASSERT_EQ(drained, (std::vector<std::string>{"c", "d", "e", "f", "g"}));
+    ASSERT_EQ(queue.pop(), std::optional<std::string>("h"));
+}
+
+TEST_F(ThreadsafeQueue_tests, queue_implementing_only_the_copying_push_takes_rvalues)
+{
+    // Arrange
+    class CopyOnlyQueue : public IThreadsafeQueue<std::string> {
+    public:
+        [[nodiscard]] unsigned long size() const override { return items.size(); }
+        std::optional<std::string> pop() override { return {}; }
+        void push(const std::string &item) override { items.push_back(item); }
+        std::vector<std::string> items{};
+    };
+    CopyOnlyQueue queue;
+    IThreadsafeQueue<std::string>& interface = queue;
+
+    // Act
+    interface.push(std::string("moved"));
+
+    // Assert
+    ASSERT_EQ(queue.items, std::vector<std::string>{"moved"});
+}
@@ -0,0 +1,28 @@
+// Prints the lines kept by the flight recorder (log_set_flight_recorder()),
+// oldest first. Run it on the file after the process has died.
+//
+// usage: rpp-flightrec recorder-file [lines]
+
+#include <iostream>
+#include <string>
+#include "FlightRecorder.h"
+
+int main(int argc, char **argv)
+{
+    if (argc < 2 || argc > 3) {
+        std::cerr << "usage: " << argv[0] << " recorder-file [lines]" << std::endl;
+        return 1;
+    }
+
+    size_t max_lines = 0;
+    try {
+        if (argc == 3)
+            max_lines = std::stoul(argv[2]);
+        for (const auto& line : rpp::FlightRecorder::read_lines(argv[1], max_lines))
+            std::cout << line << '\n';
+    } catch (const std::exception& e) {
+        std::cerr << argv[0] << ": " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
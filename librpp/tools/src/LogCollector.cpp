@@ -0,0 +1,58 @@
+// Collects the log lines that several processes send with SocketLogWriter
+// and writes them, merged, to one rotated log file.
+//
+// usage: rpp-logcollector socket-path log-file [max-megabytes [keep]]
+
+#include <csignal>
+#include <iostream>
+#include <string>
+#include "Linux.h"
+#include "LogWriter.h"
+#include "RotatingLogWriter.h"
+#include "SocketLogWriter.h"
+
+namespace {
+    volatile std::sig_atomic_t quit = 0;
+
+    void handle_signal(int) {
+        quit = 1;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 3 || argc > 5) {
+        std::cerr << "usage: " << argv[0] << " socket-path log-file [max-megabytes [keep]]" << std::endl;
+        return 1;
+    }
+
+    try {
+        rpp::log_rotation_policy policy;
+        policy.max_bytes = 64ull * 1024 * 1024;
+        if (argc >= 4)
+            policy.max_bytes = std::stoull(argv[3]) * 1024 * 1024;
+        if (argc == 5)
+            policy.keep = std::stoul(argv[4]);
+
+        std::shared_ptr<rpp::ILogWriter> writer = std::make_shared<rpp::FdLogWriter>();
+        if (policy.enabled())
+            writer = std::make_shared<rpp::RotatingLogWriter>(
+                    [] { return std::make_shared<rpp::FdLogWriter>(); }, policy);
+        writer->open(argv[2]);
+
+        rpp::LogCollector collector(std::make_shared<rpp::Linux>(), writer);
+        collector.listen(argv[1]);
+
+        std::signal(SIGINT, handle_signal);
+        std::signal(SIGTERM, handle_signal);
+        while (quit == 0)
+            collector.poll(500);
+
+        collector.close();
+        writer->close();
+    } catch (const std::exception& e) {
+        std::cerr << argv[0] << ": " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,35 @@
+// Converts a binary log written with rb_* / log_set_binary_file() to text.
+//
+// usage: rpp-logdecode binary-log [output-file]
+
+#include <fstream>
+#include <iostream>
+#include "BinaryLog.h"
+
+int main(int argc, char **argv)
+{
+    if (argc < 2 || argc > 3) {
+        std::cerr << "usage: " << argv[0] << " binary-log [output-file]" << std::endl;
+        return 1;
+    }
+
+    std::ifstream input(argv[1], std::ios::in | std::ios::binary);
+    if (!input) {
+        std::cerr << argv[0] << ": failed to open " << argv[1] << std::endl;
+        return 1;
+    }
+
+    try {
+        rpp::BinaryLogDecoder decoder;
+        if (argc == 3) {
+            std::ofstream output(argv[2]);
+            decoder.decode(input, output);
+        } else {
+            decoder.decode(input, std::cout);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << argv[0] << ": " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,81 @@
+// Prints the lines of a TEXT format log file within a time range, at or
+// above a level and from one application. The index is built on the first
+// run, brought up to date on later runs and saved as "<log>.idx".
+//
+// usage: rpp-logsearch log-file [--from datetime] [--to datetime]
+//                               [--level debug|info|warning|error] [--app name] [--no-save]
+//
+// Datetimes are compact, or a prefix of one: 20261016-2350 to 20261016-2400.
+
+#include <iostream>
+#include <string>
+#include "LogSearch.h"
+
+namespace {
+    bool parse_level(const std::string& name, rpp::log_level& level)
+    {
+        if (name == "debug")
+            level = rpp::log_level::DEBUG;
+        else if (name == "info")
+            level = rpp::log_level::INFO;
+        else if (name == "warning")
+            level = rpp::log_level::WARNING;
+        else if (name == "error")
+            level = rpp::log_level::ERROR;
+        else
+            return false;
+        return true;
+    }
+
+    bool parse(int argc, char **argv, rpp::log_query& query, bool& save)
+    {
+        for (int i = 2; i < argc; i++) {
+            std::string arg = argv[i];
+            if (arg == "--no-save") {
+                save = false;
+                continue;
+            }
+            if (i + 1 >= argc)
+                return false;
+            std::string value = argv[++i];
+            if (arg == "--from")
+                query.from = rpp::LogSearch::parse_time(value);
+            else if (arg == "--to")
+                query.to = rpp::LogSearch::parse_time(value);
+            else if (arg == "--level" && parse_level(value, query.level))
+                continue;
+            else if (arg == "--app")
+                query.application = value;
+            else
+                return false;
+        }
+        return true;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    rpp::log_query query;
+    bool save = true;
+    try {
+        if (argc < 2 || !parse(argc, argv, query, save)) {
+            std::cerr << "usage: " << argv[0] << " log-file [--from datetime] [--to datetime] "
+                      << "[--level debug|info|warning|error] [--app name] [--no-save]" << std::endl;
+            return 1;
+        }
+
+        rpp::LogSearch search(argv[1]);
+        if (save) {
+            try {
+                search.save_index();
+            } catch (const std::runtime_error& e) {
+                std::cerr << argv[0] << ": " << e.what() << std::endl;
+            }
+        }
+        search.search(query, [](std::string_view line) { std::cout << line; });
+    } catch (const std::exception& e) {
+        std::cerr << argv[0] << ": " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
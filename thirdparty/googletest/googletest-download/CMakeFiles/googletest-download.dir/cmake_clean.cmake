@@ -0,0 +1,16 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/googletest-download"
+  "CMakeFiles/googletest-download-complete"
+  "googletest-download-prefix/src/googletest-download-stamp/googletest-download-build"
+  "googletest-download-prefix/src/googletest-download-stamp/googletest-download-configure"
+  "googletest-download-prefix/src/googletest-download-stamp/googletest-download-download"
+  "googletest-download-prefix/src/googletest-download-stamp/googletest-download-install"
+  "googletest-download-prefix/src/googletest-download-stamp/googletest-download-mkdir"
+  "googletest-download-prefix/src/googletest-download-stamp/googletest-download-patch"
+  "googletest-download-prefix/src/googletest-download-stamp/googletest-download-test"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang )
+  include(CMakeFiles/googletest-download.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
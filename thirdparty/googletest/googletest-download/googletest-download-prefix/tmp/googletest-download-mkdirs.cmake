@@ -0,0 +1,22 @@
+# Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+# file Copyright.txt or https://cmake.org/licensing for details.
+
+cmake_minimum_required(VERSION 3.5)
+
+file(MAKE_DIRECTORY
+  "/root/repo/thirdparty/googletest/googletest-src"
+  "/root/repo/thirdparty/googletest/googletest-build"
+  "/root/repo/thirdparty/googletest/googletest-download/googletest-download-prefix"
+  "/root/repo/thirdparty/googletest/googletest-download/googletest-download-prefix/tmp"
+  "/root/repo/thirdparty/googletest/googletest-download/googletest-download-prefix/src/googletest-download-stamp"
+  "/root/repo/thirdparty/googletest/googletest-download/googletest-download-prefix/src"
+  "/root/repo/thirdparty/googletest/googletest-download/googletest-download-prefix/src/googletest-download-stamp"
+)
+
+set(configSubDirs )
+foreach(subDir IN LISTS configSubDirs)
+    file(MAKE_DIRECTORY "/root/repo/thirdparty/googletest/googletest-download/googletest-download-prefix/src/googletest-download-stamp/${subDir}")
+endforeach()
+if(cfgdir)
+  file(MAKE_DIRECTORY "/root/repo/thirdparty/googletest/googletest-download/googletest-download-prefix/src/googletest-download-stamp${cfgdir}") # cfgdir has leading slash
+endif()